@@ -0,0 +1,719 @@
+/*
+ * Persistent cache of translated code
+ *
+ * Copyright (c) 2021 iSYSTEM Labs d.o.o.
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ *
+ * Runs of the same firmware translate the same code again in every QEMU
+ * process.  The cache saves host code of TBs translated from ROM into a
+ * file, and the next run copies it into the code buffer instead of
+ * translating.
+ *
+ * The file is specific to the QEMU executable, the host CPU features, the
+ * configuration of guest CPUs and the contents of ROM when the guest
+ * starts, which are hashed into its name.  Each entry is keyed by pc,
+ * cs_base, flags and cflags of the TB, and holds a copy of the guest code,
+ * which must match the current contents of ROM.
+ *
+ * Runs which share the directory save under a lock on it, and merge
+ * their entries with those saved by others in the meantime.  Only the
+ * TB_CACHE_MAX_FILES most recently used files are kept.
+ *
+ * Host addresses in the code are recorded by the TCG backend while it
+ * generates the code (see tcg_tb_reloc_add()).  They are saved relative to
+ * the TB, the TCG prologue or the QEMU executable, and relocated when
+ * another process loads the code.
+ */
+
+#include "qemu/osdep.h"
+#include <sys/file.h>
+#include "qemu-common.h"
+#include "qemu-version.h"
+#include "qapi/error.h"
+#include "qemu/error-report.h"
+#include "qemu/cacheflush.h"
+#include "qemu/cutils.h"
+#include "qemu/log.h"
+#include "qemu/xxhash.h"
+#include "qom/object.h"
+#include "exec/address-spaces.h"
+#include "exec/exec-all.h"
+#include "exec/memory.h"
+#include "hw/core/cpu.h"
+#include "semihosting/semihost.h"
+#include "sysemu/runstate.h"
+#include "sysemu/sysemu.h"
+#include "tcg/tcg.h"
+#include "tb-cache.h"
+#include "trace.h"
+#ifdef CONFIG_CPUID_H
+#include "qemu/cpuid.h"
+#endif
+
+#define TB_CACHE_MAGIC      "QEMUTBC"
+#define TB_CACHE_VERSION    1
+#define TB_CACHE_SUFFIX     ".tbc"
+#define TB_CACHE_LOCK       "tb-cache.lock"
+#define TB_CACHE_MAX_FILES  16
+
+typedef struct TBCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t nb_entries;
+    uint8_t config[32];         /* SHA-256 of the configuration */
+} TBCacheHeader;
+
+typedef struct TBCacheKey {
+    uint64_t pc;
+    uint64_t cs_base;
+    uint32_t flags;
+    uint32_t cflags;
+    uint32_t trace_vcpu_dstate;
+    uint32_t reserved;
+} TBCacheKey;
+
+/*
+ * An entry is followed by its relocations, the guest code, the host code
+ * and the search data of the TB, and is padded to 8 bytes.
+ */
+typedef struct TBCacheEntry {
+    TBCacheKey key;
+    uint16_t size;              /* of guest code */
+    uint16_t icount;
+    uint16_t jmp_reset_offset[2];
+    uint32_t jmp_insn_offset[2];
+    uint32_t code_size;
+    uint32_t search_size;
+    uint32_t nb_relocs;
+    uint32_t reserved;
+} TBCacheEntry;
+
+typedef enum TBCacheBase {
+    TB_CACHE_BASE_TB,           /* TranslationBlock of the code */
+    TB_CACHE_BASE_PROLOGUE,     /* tcg_qemu_tb_exec */
+    TB_CACHE_BASE_IMAGE,        /* QEMU executable */
+} TBCacheBase;
+
+typedef struct TBCacheReloc {
+    uint32_t offset;
+    uint8_t type;               /* TCGTBRelocType */
+    uint8_t base;               /* TBCacheBase */
+    uint16_t reserved;
+    int64_t value;              /* target address relative to base */
+} TBCacheReloc;
+
+static struct {
+    char *dir;
+    char *path;
+    uint8_t config[32];
+    /* Entries in the mapped file, which stays mapped until exit */
+    GHashTable *entries;
+    /* Entries translated in this run, protected by lock */
+    GPtrArray *new_entries;
+    QemuMutex lock;
+    bool started;
+    Notifier exit;
+} tb_cache;
+
+static bool tb_cache_enabled;
+
+/* Bounds of the executable, provided by the linker */
+extern const char __executable_start[];
+extern const char _end[];
+
+static size_t tb_cache_entry_size(const TBCacheEntry *e)
+{
+    return ROUND_UP(sizeof(*e) + e->nb_relocs * sizeof(TBCacheReloc) +
+                    e->size + e->code_size + e->search_size, 8);
+}
+
+static TBCacheReloc *tb_cache_entry_relocs(TBCacheEntry *e)
+{
+    return (TBCacheReloc *)(e + 1);
+}
+
+static uint8_t *tb_cache_entry_guest_code(TBCacheEntry *e)
+{
+    return (uint8_t *)(tb_cache_entry_relocs(e) + e->nb_relocs);
+}
+
+static uint8_t *tb_cache_entry_host_code(TBCacheEntry *e)
+{
+    return tb_cache_entry_guest_code(e) + e->size;
+}
+
+static void tb_cache_key_init(TBCacheKey *key, const TranslationBlock *tb)
+{
+    memset(key, 0, sizeof(*key));
+    key->pc = tb->pc;
+    key->cs_base = tb->cs_base;
+    key->flags = tb->flags;
+    key->cflags = tb->cflags;
+    key->trace_vcpu_dstate = tb->trace_vcpu_dstate;
+}
+
+static guint tb_cache_key_hash(gconstpointer p)
+{
+    const TBCacheKey *key = p;
+
+    return qemu_xxhash7(key->pc, key->cs_base, key->flags, key->cflags,
+                        key->trace_vcpu_dstate);
+}
+
+static gboolean tb_cache_key_equal(gconstpointer a, gconstpointer b)
+{
+    return memcmp(a, b, sizeof(TBCacheKey)) == 0;
+}
+
+static uintptr_t tb_cache_reloc_base(TranslationBlock *tb, int base)
+{
+    switch (base) {
+    case TB_CACHE_BASE_TB:
+        return (uintptr_t)tb;
+    case TB_CACHE_BASE_PROLOGUE:
+        return (uintptr_t)tcg_qemu_tb_exec;
+    default:
+        return (uintptr_t)__executable_start;
+    }
+}
+
+static void tb_cache_hash_u64(GChecksum *checksum, uint64_t value)
+{
+    g_checksum_update(checksum, (const guchar *)&value, sizeof(value));
+}
+
+static void tb_cache_hash_str(GChecksum *checksum, const char *str)
+{
+    /* Include the terminating zero to separate the strings */
+    g_checksum_update(checksum, (const guchar *)str, strlen(str) + 1);
+}
+
+static gint tb_cache_compare_names(gconstpointer a, gconstpointer b)
+{
+    return strcmp(*(const char **)a, *(const char **)b);
+}
+
+/* CPU properties select features, which change the translation */
+static void tb_cache_hash_cpu(GChecksum *checksum, CPUState *cpu)
+{
+    Object *obj = OBJECT(cpu);
+    g_autoptr(GPtrArray) names = g_ptr_array_new();
+    ObjectPropertyIterator iter;
+    ObjectProperty *prop;
+    guint i;
+
+    object_property_iter_init(&iter, obj);
+    while ((prop = object_property_iter_next(&iter))) {
+        if (prop->get && !strstart(prop->type, "child<", NULL)) {
+            g_ptr_array_add(names, (gpointer)prop->name);
+        }
+    }
+    g_ptr_array_sort(names, tb_cache_compare_names);
+
+    tb_cache_hash_str(checksum, object_get_typename(obj));
+    for (i = 0; i < names->len; i++) {
+        const char *name = g_ptr_array_index(names, i);
+        g_autofree char *value = object_property_print(obj, name, false, NULL);
+
+        tb_cache_hash_str(checksum, name);
+        tb_cache_hash_str(checksum, value ? value : "");
+    }
+}
+
+static bool tb_cache_hash_rom(Int128 start, Int128 len, const MemoryRegion *mr,
+                              hwaddr offset_in_region, void *opaque)
+{
+    MemoryRegion *rom = (MemoryRegion *)mr;
+    GChecksum *checksum = opaque;
+
+    if (memory_region_is_rom(rom)) {
+        tb_cache_hash_u64(checksum, int128_get64(start));
+        tb_cache_hash_u64(checksum, int128_get64(len));
+        g_checksum_update(checksum,
+                          memory_region_get_ram_ptr(rom) + offset_in_region,
+                          int128_get64(len));
+    }
+    return false;
+}
+
+static bool tb_cache_hash_config(uint8_t *digest, Error **errp)
+{
+    g_autoptr(GChecksum) checksum = g_checksum_new(G_CHECKSUM_SHA256);
+    gsize len = sizeof(tb_cache.config);
+    struct stat st;
+    CPUState *cpu;
+
+    /* The executable, which generated the code */
+    if (stat("/proc/self/exe", &st) < 0) {
+        error_setg_errno(errp, errno, "cannot identify the QEMU executable");
+        return false;
+    }
+    tb_cache_hash_str(checksum, QEMU_FULL_VERSION);
+    tb_cache_hash_str(checksum, TARGET_NAME);
+    tb_cache_hash_u64(checksum, st.st_size);
+    tb_cache_hash_u64(checksum, st.st_mtim.tv_sec);
+    tb_cache_hash_u64(checksum, st.st_mtim.tv_nsec);
+    tb_cache_hash_u64(checksum, qemu_icache_linesize);
+
+#ifdef CONFIG_CPUID_H
+    /* Host features, which the backend uses */
+    {
+        unsigned a, b, c, d;
+
+        __cpuid(1, a, b, c, d);
+        tb_cache_hash_u64(checksum, ((uint64_t)c << 32) | d);
+        if (__get_cpuid_max(0, NULL) >= 7) {
+            __cpuid_count(7, 0, a, b, c, d);
+            tb_cache_hash_u64(checksum, ((uint64_t)c << 32) | b);
+        }
+        __cpuid(0x80000001, a, b, c, d);
+        tb_cache_hash_u64(checksum, c);
+    }
+#endif
+
+    tb_cache_hash_u64(checksum, semihosting_enabled());
+    CPU_FOREACH(cpu) {
+        tb_cache_hash_cpu(checksum, cpu);
+    }
+
+    /* Each firmware gets a file of its own */
+    WITH_RCU_READ_LOCK_GUARD() {
+        FlatView *fv = address_space_to_flatview(&address_space_memory);
+
+        flatview_for_each_range(fv, tb_cache_hash_rom, checksum);
+    }
+
+    g_checksum_get_digest(checksum, digest, &len);
+    return true;
+}
+
+/*
+ * Maps the file at @path and adds its entries to @entries.  Returns the
+ * mapping and sets *@size, or returns NULL if there is no valid file.
+ */
+static void *tb_cache_map_file(const char *path, GHashTable *entries,
+                               size_t *size)
+{
+    TBCacheHeader *hdr;
+    struct stat st;
+    void *map = NULL, *p, *end;
+    uint32_t i;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (fstat(fd, &st) < 0 || st.st_size < sizeof(*hdr)) {
+        goto out;
+    }
+    p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+        goto out;
+    }
+
+    hdr = p;
+    if (memcmp(hdr->magic, TB_CACHE_MAGIC, sizeof(hdr->magic)) != 0 ||
+        hdr->version != TB_CACHE_VERSION ||
+        memcmp(hdr->config, tb_cache.config, sizeof(hdr->config)) != 0) {
+        warn_report("TB cache %s was not written by this configuration, "
+                    "ignoring it", path);
+        munmap(p, st.st_size);
+        goto out;
+    }
+
+    map = p;
+    *size = st.st_size;
+    end = p + st.st_size;
+    p += sizeof(*hdr);
+    for (i = 0; i < hdr->nb_entries; i++) {
+        TBCacheEntry *e = p;
+
+        if (end - p < sizeof(*e) || end - p < tb_cache_entry_size(e)) {
+            warn_report("TB cache %s is truncated", path);
+            break;
+        }
+        g_hash_table_insert(entries, &e->key, e);
+        p += tb_cache_entry_size(e);
+    }
+
+out:
+    close(fd);
+    return map;
+}
+
+/* Adds the entries of @src, whose keys are not in @dst yet */
+static void tb_cache_merge(GHashTable *dst, GHashTable *src)
+{
+    GHashTableIter iter;
+    TBCacheEntry *e;
+
+    g_hash_table_iter_init(&iter, src);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&e)) {
+        if (!g_hash_table_contains(dst, &e->key)) {
+            g_hash_table_insert(dst, &e->key, e);
+        }
+    }
+}
+
+typedef struct TBCacheFile {
+    char *path;
+    time_t mtime;
+} TBCacheFile;
+
+static gint tb_cache_compare_files(gconstpointer a, gconstpointer b)
+{
+    const TBCacheFile *fa = a, *fb = b;
+
+    /* Most recently used first */
+    return fa->mtime < fb->mtime ? 1 : fa->mtime > fb->mtime ? -1 : 0;
+}
+
+/*
+ * Removes all but TB_CACHE_MAX_FILES most recently used files, so that the
+ * directory does not grow with each new firmware.  Called under the lock.
+ */
+static void tb_cache_prune(void)
+{
+    g_autoptr(GArray) files = g_array_new(FALSE, FALSE, sizeof(TBCacheFile));
+    GDir *dir = g_dir_open(tb_cache.dir, 0, NULL);
+    const char *name;
+    guint i;
+
+    if (!dir) {
+        return;
+    }
+    while ((name = g_dir_read_name(dir))) {
+        TBCacheFile f;
+        struct stat st;
+
+        if (!g_str_has_suffix(name, TB_CACHE_SUFFIX)) {
+            continue;
+        }
+        f.path = g_build_filename(tb_cache.dir, name, NULL);
+        if (stat(f.path, &st) < 0) {
+            g_free(f.path);
+            continue;
+        }
+        f.mtime = st.st_mtime;
+        g_array_append_val(files, f);
+    }
+    g_dir_close(dir);
+
+    g_array_sort(files, tb_cache_compare_files);
+    for (i = 0; i < files->len; i++) {
+        TBCacheFile *f = &g_array_index(files, TBCacheFile, i);
+
+        if (i >= TB_CACHE_MAX_FILES) {
+            unlink(f->path);
+        }
+        g_free(f->path);
+    }
+}
+
+/* ROM is filled at reset, so the file is selected when the guest starts */
+static void tb_cache_vm_state_change(void *opaque, bool running,
+                                     RunState state)
+{
+    Error *err = NULL;
+    char name[2 * 16 + sizeof(TB_CACHE_SUFFIX)];
+    size_t size;
+    int i;
+
+    if (!running || tb_cache.started) {
+        return;
+    }
+    tb_cache.started = true;
+
+    if (!tb_cache_hash_config(tb_cache.config, &err)) {
+        warn_report_err(err);
+        return;
+    }
+    for (i = 0; i < 16; i++) {
+        snprintf(&name[2 * i], 3, "%02x", tb_cache.config[i]);
+    }
+    strcpy(&name[2 * 16], TB_CACHE_SUFFIX);
+    tb_cache.path = g_build_filename(tb_cache.dir, name, NULL);
+
+    /* The mapping stays until exit, entries point into it */
+    if (tb_cache_map_file(tb_cache.path, tb_cache.entries, &size)) {
+        /* Mark the file as recently used for tb_cache_prune() */
+        utimensat(AT_FDCWD, tb_cache.path, NULL, 0);
+    }
+    trace_tb_cache_load(tb_cache.path, g_hash_table_size(tb_cache.entries));
+    tb_cache_enabled = true;
+}
+
+static void tb_cache_save(Notifier *notifier, void *data)
+{
+    g_autoptr(GHashTable) saved = NULL;
+    g_autoptr(GHashTable) on_disk = NULL;
+    g_autofree char *lock_path = NULL;
+    g_autofree char *tmp = NULL;
+    TBCacheHeader hdr = {
+        .magic = TB_CACHE_MAGIC,
+        .version = TB_CACHE_VERSION,
+    };
+    GHashTableIter iter;
+    TBCacheEntry *e;
+    void *map;
+    size_t map_size = 0;
+    bool ok;
+    FILE *f;
+    guint i;
+    int lock_fd, fd;
+
+    qemu_mutex_lock(&tb_cache.lock);
+    if (!tb_cache_enabled || tb_cache.new_entries->len == 0) {
+        goto out;
+    }
+
+    /* Other runs may save into the directory at the same time */
+    lock_path = g_build_filename(tb_cache.dir, TB_CACHE_LOCK, NULL);
+    lock_fd = open(lock_path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (lock_fd < 0 || flock(lock_fd, LOCK_EX) < 0) {
+        warn_report("cannot lock TB cache %s: %s", lock_path, strerror(errno));
+        if (lock_fd >= 0) {
+            close(lock_fd);
+        }
+        goto out;
+    }
+
+    /*
+     * Entries translated in this run replace the stale ones.  Entries which
+     * other runs saved since this one loaded the file are kept as well.
+     */
+    saved = g_hash_table_new(tb_cache_key_hash, tb_cache_key_equal);
+    for (i = 0; i < tb_cache.new_entries->len; i++) {
+        e = g_ptr_array_index(tb_cache.new_entries, i);
+        g_hash_table_insert(saved, &e->key, e);
+    }
+    on_disk = g_hash_table_new(tb_cache_key_hash, tb_cache_key_equal);
+    map = tb_cache_map_file(tb_cache.path, on_disk, &map_size);
+    tb_cache_merge(saved, on_disk);
+    tb_cache_merge(saved, tb_cache.entries);
+
+    /* Replace the file atomically, other runs may be reading it */
+    tmp = g_strdup_printf("%s.XXXXXX", tb_cache.path);
+    fd = mkstemp(tmp);
+    if (fd < 0) {
+        warn_report("cannot save TB cache %s: %s", tb_cache.path,
+                    strerror(errno));
+        goto unlock;
+    }
+    f = fdopen(fd, "wb");
+    if (!f) {
+        close(fd);
+        ok = false;
+    } else {
+        hdr.nb_entries = g_hash_table_size(saved);
+        memcpy(hdr.config, tb_cache.config, sizeof(hdr.config));
+        ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1;
+
+        g_hash_table_iter_init(&iter, saved);
+        while (ok && g_hash_table_iter_next(&iter, NULL, (gpointer *)&e)) {
+            ok = fwrite(e, tb_cache_entry_size(e), 1, f) == 1;
+        }
+        ok = fclose(f) == 0 && ok;
+    }
+    if (!ok || rename(tmp, tb_cache.path) < 0) {
+        warn_report("cannot save TB cache %s: %s", tb_cache.path,
+                    strerror(errno));
+        unlink(tmp);
+        goto unlock;
+    }
+    trace_tb_cache_save(tb_cache.path, hdr.nb_entries);
+    tb_cache_prune();
+
+unlock:
+    if (map) {
+        munmap(map, map_size);
+    }
+    close(lock_fd);
+out:
+    qemu_mutex_unlock(&tb_cache.lock);
+}
+
+bool tb_cache_init(const char *dir, Error **errp)
+{
+    if (!TCG_TARGET_HAS_tb_reloc || !TCG_TARGET_HAS_direct_jump) {
+        error_setg(errp, "TB cache is not supported on this host");
+        return false;
+    }
+    if (tcg_splitwx_diff) {
+        error_setg(errp, "TB cache cannot be used with split-wx");
+        return false;
+    }
+    /*
+     * The backend records only constants which do not fit in 32 bits,
+     * so no host address may fit in them.
+     */
+    if ((uintptr_t)__executable_start <= UINT32_MAX) {
+        error_setg(errp, "TB cache needs a position independent executable");
+        return false;
+    }
+
+    tb_cache.dir = g_strdup(dir);
+    tb_cache.entries = g_hash_table_new(tb_cache_key_hash, tb_cache_key_equal);
+    tb_cache.new_entries = g_ptr_array_new_with_free_func(g_free);
+    qemu_mutex_init(&tb_cache.lock);
+
+    qemu_add_vm_change_state_handler(tb_cache_vm_state_change, NULL);
+    tb_cache.exit.notify = tb_cache_save;
+    qemu_add_exit_notifier(&tb_cache.exit);
+    return true;
+}
+
+bool tb_cache_usable(CPUState *cpu, void *host_pc)
+{
+    MemoryRegion *mr;
+    ram_addr_t offset;
+
+    if (!tb_cache_enabled || !host_pc) {
+        return false;
+    }
+    /* Breakpoints, single-stepping and plugins change the translation */
+    if (cpu->singlestep_enabled || !QTAILQ_EMPTY(&cpu->breakpoints) ||
+        !bitmap_empty(cpu->plugin_mask, QEMU_PLUGIN_EV_MAX)) {
+        return false;
+    }
+    /* Code of cached TBs would be missing from the log */
+    if (qemu_loglevel_mask(CPU_LOG_TB_IN_ASM | CPU_LOG_TB_OP |
+                           CPU_LOG_TB_OP_OPT | CPU_LOG_TB_OUT_ASM)) {
+        return false;
+    }
+    mr = memory_region_from_host(host_pc, &offset);
+    return mr && memory_region_is_rom(mr);
+}
+
+int tb_cache_load(TranslationBlock *tb, void *host_pc,
+                  tcg_insn_unit *gen_code_buf, int *search_size)
+{
+    void *buf = gen_code_buf;
+    TBCacheKey key;
+    TBCacheEntry *e;
+    TBCacheReloc *r;
+    uint32_t i;
+
+    tb_cache_key_init(&key, tb);
+    e = g_hash_table_lookup(tb_cache.entries, &key);
+    if (!e || e->size == 0 ||
+        e->size > TARGET_PAGE_SIZE - (tb->pc & ~TARGET_PAGE_MASK) ||
+        memcmp(host_pc, tb_cache_entry_guest_code(e), e->size) != 0) {
+        return 0;
+    }
+    /* Let the translation handle overflow of the buffer */
+    if (buf + e->code_size + e->search_size > tcg_ctx->code_gen_highwater) {
+        return 0;
+    }
+
+    memcpy(buf, tb_cache_entry_host_code(e), e->code_size + e->search_size);
+    r = tb_cache_entry_relocs(e);
+    for (i = 0; i < e->nb_relocs; i++, r++) {
+        uintptr_t target = tb_cache_reloc_base(tb, r->base) + r->value;
+        void *field = buf + r->offset;
+        intptr_t disp;
+
+        switch (r->type) {
+        case TCG_TB_RELOC_PC32:
+            if (r->offset + 4 > e->code_size) {
+                return 0;
+            }
+            disp = target - (uintptr_t)tcg_splitwx_to_rx(field) - 4;
+            if (disp != (int32_t)disp) {
+                return 0;
+            }
+            stl_he_p(field, disp);
+            break;
+        case TCG_TB_RELOC_ABS64:
+            if (r->offset + 8 > e->code_size) {
+                return 0;
+            }
+            stq_he_p(field, target);
+            break;
+        default:
+            return 0;
+        }
+    }
+
+    tb->size = e->size;
+    tb->icount = e->icount;
+    tb->tc.size = e->code_size;
+    for (i = 0; i < 2; i++) {
+        tb->jmp_reset_offset[i] = e->jmp_reset_offset[i];
+        tb->jmp_target_arg[i] = e->jmp_insn_offset[i];
+    }
+    flush_idcache_range((uintptr_t)tcg_splitwx_to_rx(buf), (uintptr_t)buf,
+                        e->code_size);
+
+    *search_size = e->search_size;
+    return e->code_size;
+}
+
+void tb_cache_record(TranslationBlock *tb, void *host_pc, int search_size)
+{
+    TCGContext *s = tcg_ctx;
+    TBCacheReloc relocs[TCG_MAX_TB_RELOCS];
+    uintptr_t tb_start = (uintptr_t)tb;
+    uintptr_t tb_end = (uintptr_t)tb->tc.ptr + tb->tc.size;
+    uint32_t nb_relocs = 0;
+    TBCacheEntry *e;
+    size_t size;
+    int i;
+
+    if (s->tb_reloc_failed ||
+        ((tb->pc ^ (tb->pc + tb->size - 1)) & TARGET_PAGE_MASK) != 0) {
+        return;
+    }
+
+    for (i = 0; i < s->nb_tb_relocs; i++) {
+        const TCGTBReloc *tr = &s->tb_relocs[i];
+        uintptr_t target = (uintptr_t)tr->target;
+        TBCacheReloc *r = &relocs[nb_relocs];
+
+        if (target >= tb_start && target < tb_end) {
+            if (tr->type == TCG_TB_RELOC_PC32) {
+                continue;
+            }
+            r->base = TB_CACHE_BASE_TB;
+        } else if (in_code_gen_buffer(tr->target)) {
+            /* Other TBs are not referenced before chaining */
+            r->base = TB_CACHE_BASE_PROLOGUE;
+        } else if (target >= (uintptr_t)__executable_start &&
+                   target < (uintptr_t)_end) {
+            r->base = TB_CACHE_BASE_IMAGE;
+        } else {
+            /* Heap address, or a constant which is not an address */
+            return;
+        }
+        r->offset = tr->offset;
+        r->type = tr->type;
+        r->reserved = 0;
+        r->value = target - tb_cache_reloc_base(tb, r->base);
+        nb_relocs++;
+    }
+
+    size = ROUND_UP(sizeof(*e) + nb_relocs * sizeof(TBCacheReloc) +
+                    tb->size + tb->tc.size + search_size, 8);
+    e = g_malloc0(size);
+    tb_cache_key_init(&e->key, tb);
+    e->size = tb->size;
+    e->icount = tb->icount;
+    for (i = 0; i < 2; i++) {
+        e->jmp_reset_offset[i] = tb->jmp_reset_offset[i];
+        e->jmp_insn_offset[i] = tb->jmp_target_arg[i];
+    }
+    e->code_size = tb->tc.size;
+    e->search_size = search_size;
+    e->nb_relocs = nb_relocs;
+    memcpy(tb_cache_entry_relocs(e), relocs, nb_relocs * sizeof(*relocs));
+    memcpy(tb_cache_entry_guest_code(e), host_pc, tb->size);
+    memcpy(tb_cache_entry_host_code(e), tb->tc.ptr,
+           tb->tc.size + search_size);
+
+    qemu_mutex_lock(&tb_cache.lock);
+    g_ptr_array_add(tb_cache.new_entries, e);
+    qemu_mutex_unlock(&tb_cache.lock);
+}
@@ -0,0 +1,66 @@
+/*
+ * Persistent cache of translated code
+ *
+ * Copyright (c) 2021 iSYSTEM Labs d.o.o.
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+
+#ifndef ACCEL_TCG_TB_CACHE_H
+#define ACCEL_TCG_TB_CACHE_H
+
+#include "qapi/error.h"
+#include "exec/exec-all.h"
+#include "tcg/tcg.h"
+
+#if defined(CONFIG_SOFTMMU) && defined(CONFIG_LINUX)
+/*
+ * Loads the cache of TBs from a file in @dir when the guest starts, and
+ * saves the newly translated TBs into it when QEMU exits.
+ */
+bool tb_cache_init(const char *dir, Error **errp);
+
+/*
+ * Returns true if the TB starting at @host_pc can be loaded from the
+ * cache, or saved into it.  This is the case for code in ROM, when no
+ * debugging or logging affects the translation.
+ */
+bool tb_cache_usable(CPUState *cpu, void *host_pc);
+
+/*
+ * Copies the code of the cached TB matching the pc, cs_base, flags and
+ * cflags of @tb into @gen_code_buf and fills in the rest of @tb.  Returns
+ * the size of code and sets *@search_size, or returns 0 if no cached code
+ * matches the guest code at @host_pc.
+ */
+int tb_cache_load(TranslationBlock *tb, void *host_pc,
+                  tcg_insn_unit *gen_code_buf, int *search_size);
+
+/* Adds the just translated @tb to the entries, saved on exit */
+void tb_cache_record(TranslationBlock *tb, void *host_pc, int search_size);
+#else
+static inline bool tb_cache_init(const char *dir, Error **errp)
+{
+    error_setg(errp, "TB cache is not supported on this host");
+    return false;
+}
+
+static inline bool tb_cache_usable(CPUState *cpu, void *host_pc)
+{
+    return false;
+}
+
+static inline int tb_cache_load(TranslationBlock *tb, void *host_pc,
+                                tcg_insn_unit *gen_code_buf, int *search_size)
+{
+    return 0;
+}
+
+static inline void tb_cache_record(TranslationBlock *tb, void *host_pc,
+                                   int search_size)
+{
+}
+#endif
+
+#endif /* ACCEL_TCG_TB_CACHE_H */
@@ -37,6 +37,7 @@
 #include "hw/boards.h"
 #endif
 #include "internal.h"
+#include "tb-cache.h"
 
 struct TCGState {
     AccelState parent_obj;
@@ -44,6 +45,7 @@ struct TCGState {
     bool mttcg_enabled;
     int splitwx_enabled;
     unsigned long tb_size;
+    char *tb_cache;
 };
 typedef struct TCGState TCGState;
 
@@ -132,6 +134,15 @@ static int tcg_init_machine(MachineState *ms)
      * initialize the prologue now.
      */
     tcg_prologue_init(tcg_ctx);
+
+    if (s->tb_cache) {
+        Error *err = NULL;
+
+        if (!tb_cache_init(s->tb_cache, &err)) {
+            error_report_err(err);
+            return -EINVAL;
+        }
+    }
 #endif
 
     return 0;
@@ -208,6 +219,21 @@ static void tcg_set_splitwx(Object *obj, bool value, Error **errp)
     s->splitwx_enabled = value;
 }
 
+static char *tcg_get_tb_cache(Object *obj, Error **errp)
+{
+    TCGState *s = TCG_STATE(obj);
+
+    return g_strdup(s->tb_cache);
+}
+
+static void tcg_set_tb_cache(Object *obj, const char *value, Error **errp)
+{
+    TCGState *s = TCG_STATE(obj);
+
+    g_free(s->tb_cache);
+    s->tb_cache = g_strdup(value);
+}
+
 static void tcg_accel_class_init(ObjectClass *oc, void *data)
 {
     AccelClass *ac = ACCEL_CLASS(oc);
@@ -229,6 +255,11 @@ static void tcg_accel_class_init(ObjectClass *oc, void *data)
         tcg_get_splitwx, tcg_set_splitwx);
     object_class_property_set_description(oc, "split-wx",
         "Map jit pages into separate RW and RX regions");
+
+    object_class_property_add_str(oc, "tb-cache",
+        tcg_get_tb_cache, tcg_set_tb_cache);
+    object_class_property_set_description(oc, "tb-cache",
+        "Directory of the persistent cache of code translated from ROM");
 }
 
 static const TypeInfo tcg_accel_type = {
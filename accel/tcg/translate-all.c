@@ -59,6 +59,7 @@
 #include "hw/core/tcg-cpu-ops.h"
 #include "tb-hash.h"
 #include "tb-context.h"
+#include "tb-cache.h"
 #include "internal.h"
 
 /* #define DEBUG_TB_INVALIDATE */
@@ -1409,6 +1410,7 @@ TranslationBlock *tb_gen_code(CPUState *cpu,
     TranslationBlock *tb, *existing_tb;
     tb_page_addr_t phys_pc, phys_page2;
     target_ulong virt_page2;
+    void *host_pc;
     tcg_insn_unit *gen_code_buf;
     int gen_code_size, search_size, max_insns;
 #ifdef CONFIG_PROFILER
@@ -1419,7 +1421,7 @@ TranslationBlock *tb_gen_code(CPUState *cpu,
     assert_memory_lock();
     qemu_thread_jit_write();
 
-    phys_pc = get_page_addr_code(env, pc);
+    phys_pc = get_page_addr_code_hostp(env, pc, &host_pc);
 
     if (phys_pc == -1) {
         /* Generate a one-shot TB with 1 insn in it */
@@ -1451,6 +1453,14 @@ TranslationBlock *tb_gen_code(CPUState *cpu,
     tb->cflags = cflags;
     tb->trace_vcpu_dstate = *cpu->trace_dstate;
     tcg_ctx->tb_cflags = cflags;
+
+    tcg_ctx->tb_reloc = tb_cache_usable(cpu, host_pc);
+    if (tcg_ctx->tb_reloc) {
+        gen_code_size = tb_cache_load(tb, host_pc, gen_code_buf, &search_size);
+        if (gen_code_size > 0) {
+            goto code_done;
+        }
+    }
  tb_overflow:
 
 #ifdef CONFIG_PROFILER
@@ -1540,6 +1550,10 @@ TranslationBlock *tb_gen_code(CPUState *cpu,
     }
     tb->tc.size = gen_code_size;
 
+    if (tcg_ctx->tb_reloc) {
+        tb_cache_record(tb, host_pc, search_size);
+    }
+
 #ifdef CONFIG_PROFILER
     qatomic_set(&prof->code_time, prof->code_time + profile_getclock() - ti);
     qatomic_set(&prof->code_in_len, prof->code_in_len + tb->size);
@@ -1616,6 +1630,7 @@ TranslationBlock *tb_gen_code(CPUState *cpu,
     }
 #endif
 
+ code_done:
     qatomic_set(&tcg_ctx->code_gen_ptr, (void *)
         ROUND_UP((uintptr_t)gen_code_buf + gen_code_size + search_size,
                  CODE_GEN_ALIGN));
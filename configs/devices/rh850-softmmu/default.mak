@@ -1,4 +1,8 @@
 # Default configuration for rh850-softmmu
+
+CONFIG_SEMIHOSTING=y
+CONFIG_ARM_COMPATIBLE_SEMIHOSTING=y
+
 #
 # Boards:
 CONFIG_RH850_MINI=y
@@ -1,2 +1,3 @@
-TARGET_ARCH=arm
-
+TARGET_ARCH=rh850
+TARGET_SUPPORTS_MTTCG=y
+TARGET_XML_FILES= gdb-xml/rh850-core.xml
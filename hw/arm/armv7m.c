@@ -22,12 +22,47 @@
 
 /* Bitbanded IO.  Each word corresponds to a single bit.  */
 
+/* Size of the bit-banded range, 32 times smaller than the alias */
+#define BITBAND_SOURCE_SIZE 0x00100000
+
 /* Get the byte address of the real memory for a bitband access.  */
 static inline hwaddr bitband_addr(BitBandState *s, hwaddr offset)
 {
     return s->base | (offset & 0x1ffffff) >> 5;
 }
 
+/*
+ * Return true if the real memory at addr is RAM covered by the cache, so
+ * that bit-band accesses to SRAM don't go through a lookup in the address
+ * space every time. Peripherals are still accessed with
+ * address_space_read/write, with the attributes of the bit-band access.
+ */
+static bool bitband_in_ram(BitBandState *s, hwaddr addr, unsigned size)
+{
+    return addr - s->base + size <= s->ram_cache_len;
+}
+
+static void bitband_update_ram_cache(MemoryListener *listener)
+{
+    BitBandState *s = container_of(listener, BitBandState, listener);
+    MemoryRegionSection section;
+    int64_t len;
+
+    address_space_cache_destroy(&s->ram_cache);
+    s->ram_cache_len = 0;
+
+    section = memory_region_find(s->source_memory, s->base, 1);
+    if (!section.mr) {
+        return;
+    }
+    if (memory_region_is_ram(section.mr)) {
+        len = address_space_cache_init(&s->ram_cache, &s->source_as, s->base,
+                                       BITBAND_SOURCE_SIZE, true);
+        s->ram_cache_len = MAX(len, 0);
+    }
+    memory_region_unref(section.mr);
+}
+
 static MemTxResult bitband_read(void *opaque, hwaddr offset,
                                 uint64_t *data, unsigned size, MemTxAttrs attrs)
 {
@@ -41,7 +76,12 @@ static MemTxResult bitband_read(void *opaque, hwaddr offset,
 
     /* Find address in underlying memory and round down to multiple of size */
     addr = bitband_addr(s, offset) & (-size);
-    res = address_space_read(&s->source_as, addr, attrs, buf, size);
+    if (bitband_in_ram(s, addr, size)) {
+        res = address_space_read_cached(&s->ram_cache, addr - s->base,
+                                        buf, size);
+    } else {
+        res = address_space_read(&s->source_as, addr, attrs, buf, size);
+    }
     if (res) {
         return res;
     }
@@ -66,14 +106,32 @@ static MemTxResult bitband_write(void *opaque, hwaddr offset, uint64_t value,
 
     /* Find address in underlying memory and round down to multiple of size */
     addr = bitband_addr(s, offset) & (-size);
+    /* Bit position in the N bytes accessed... */
+    bitpos = (offset >> 2) & ((size * 8) - 1);
+    /* ...converted to byte in buffer and bit in byte */
+    bit = 1 << (bitpos & 7);
+
+    if (bitband_in_ram(s, addr, size)) {
+        /* Only the byte holding the bit changes */
+        hwaddr byte = addr - s->base + (bitpos >> 3);
+        uint8_t val = address_space_ldub_cached(&s->ram_cache, byte,
+                                                attrs, NULL);
+
+        if (value & 1) {
+            val |= bit;
+        } else {
+            val &= ~bit;
+        }
+        address_space_stb_cached(&s->ram_cache, byte, val, attrs, NULL);
+        /* Marks the byte dirty and invalidates TBs translated from it */
+        address_space_cache_invalidate(&s->ram_cache, byte, 1);
+        return MEMTX_OK;
+    }
+
     res = address_space_read(&s->source_as, addr, attrs, buf, size);
     if (res) {
         return res;
     }
-    /* Bit position in the N bytes read... */
-    bitpos = (offset >> 2) & ((size * 8) - 1);
-    /* ...converted to byte in buffer and bit in byte */
-    bit = 1 << (bitpos & 7);
     if (value & 1) {
         buf[bitpos >> 3] |= bit;
     } else {
@@ -100,6 +158,7 @@ static void bitband_init(Object *obj)
     memory_region_init_io(&s->iomem, obj, &bitband_ops, s,
                           "bitband", 0x02000000);
     sysbus_init_mmio(dev, &s->iomem);
+    s->ram_cache = MEMORY_REGION_CACHE_INVALID;
 }
 
 static void bitband_realize(DeviceState *dev, Error **errp)
@@ -112,6 +171,12 @@ static void bitband_realize(DeviceState *dev, Error **errp)
     }
 
     address_space_init(&s->source_as, s->source_memory, "bitband-source");
+
+    /* Look up the RAM again whenever the memory map changes */
+    s->listener = (MemoryListener) {
+        .commit = bitband_update_ram_cache,
+    };
+    memory_listener_register(&s->listener, &s->source_as);
 }
 
 /* Board init.  */
@@ -339,6 +404,32 @@ void armv7m_load_kernel(ARMCPU *cpu, const char *kernel_filename, int mem_size)
     qemu_register_reset(armv7m_reset, cpu);
 }
 
+bool armv7m_init_cached_flash(MemoryRegion *flash, Object *owner,
+                              const char *name, hwaddr base, uint64_t size,
+                              const char *kernel_filename,
+                              const char *cache_dir)
+{
+    Error *err = NULL;
+    int big_endian;
+
+#ifdef TARGET_WORDS_BIGENDIAN
+    big_endian = 1;
+#else
+    big_endian = 0;
+#endif
+
+    if (!kernel_filename || !cache_dir) {
+        return false;
+    }
+    if (!load_elf_flash_cached(flash, owner, name, base, size,
+                               kernel_filename, cache_dir, big_endian,
+                               EM_ARM, &err)) {
+        warn_report_err(err);
+        return false;
+    }
+    return true;
+}
+
 static Property bitband_properties[] = {
     DEFINE_PROP_UINT32("base", BitBandState, base, 0),
     DEFINE_PROP_LINK("source-memory", BitBandState, source_memory,
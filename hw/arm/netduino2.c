@@ -40,6 +40,7 @@
 static void netduino2_init(MachineState *machine)
 {
     DeviceState *dev;
+    const char *kernel_filename = machine->kernel_filename;
 
     /*
      * TODO: ideally we would model the SoC RCC and let it handle
@@ -50,14 +51,22 @@ static void netduino2_init(MachineState *machine)
 
     dev = qdev_new(TYPE_STM32F205_SOC);
     qdev_prop_set_string(dev, "cpu-type", ARM_CPU_TYPE_NAME("cortex-m3"));
+    if (machine->memory_map) {
+        qdev_prop_set_string(dev, "memory-map", machine->memory_map);
+    } else if (kernel_filename && machine->flash_cache) {
+        qdev_prop_set_string(dev, "flash-image", kernel_filename);
+        qdev_prop_set_string(dev, "flash-cache", machine->flash_cache);
+    }
     sysbus_realize_and_unref(SYS_BUS_DEVICE(dev), &error_fatal);
+    if (STM32F205_SOC(dev)->flash_image_loaded) {
+        kernel_filename = NULL;
+    }
 
     // see also stm32f3015_soc.c for start address and RAM
     uint32_t flash_size = FLASH_SIZE;
     get_memory_ranges("0", NULL, &flash_size, NULL, NULL);
 
-    armv7m_load_kernel(ARM_CPU(first_cpu), machine->kernel_filename,
-                       flash_size);
+    armv7m_load_kernel(ARM_CPU(first_cpu), kernel_filename, flash_size);
 
     /* The folowing two calls are a workaround for problem with rom in aliased
      * addresses on STM32. It is also possible to call qemu_system_reset()
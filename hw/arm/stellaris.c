@@ -16,6 +16,7 @@
 #include "hw/i2c/i2c.h"
 #include "net/net.h"
 #include "hw/boards.h"
+#include "hw/memory-map.h"
 #include "qemu/log.h"
 #include "exec/address-spaces.h"
 #include "sysemu/sysemu.h"
@@ -1271,6 +1272,207 @@ static void stellaris_adc_init(Object *obj)
     qdev_init_gpio_in(dev, stellaris_adc_trigger, 1);
 }
 
+/*
+ * Flash memory controller.  Program and erase operations complete
+ * immediately.  Flash is at address 0 and stays ROM for the CPU, so
+ * it is modified with address_space_write_rom(), which invalidates
+ * the translated code of the affected pages only.
+ */
+
+#define STELLARIS_FLASH_PAGE_SIZE   0x400
+#define STELLARIS_FLASH_FMC_WRKEY   0xa4420000
+#define STELLARIS_FLASH_FMC_WRITE   0x01
+#define STELLARIS_FLASH_FMC_ERASE   0x02
+#define STELLARIS_FLASH_FMC_MERASE  0x04
+#define STELLARIS_FLASH_FMC_COMT    0x08
+#define STELLARIS_FLASH_INT_ACCESS  0x01
+#define STELLARIS_FLASH_INT_PROGRAM 0x02
+
+#define TYPE_STELLARIS_FLASH "stellaris-flash"
+OBJECT_DECLARE_SIMPLE_TYPE(stellaris_flash_state, STELLARIS_FLASH)
+
+struct stellaris_flash_state {
+    SysBusDevice parent_obj;
+
+    MemoryRegion iomem;
+    qemu_irq irq;
+    uint32_t flash_size;
+    uint32_t fma;
+    uint32_t fmd;
+    uint32_t fcris;
+    uint32_t fcim;
+};
+
+static void stellaris_flash_update(stellaris_flash_state *s)
+{
+    qemu_set_irq(s->irq, (s->fcris & s->fcim) != 0);
+}
+
+static void stellaris_flash_erase(stellaris_flash_state *s, hwaddr addr,
+                                  hwaddr len)
+{
+    uint8_t buf[STELLARIS_FLASH_PAGE_SIZE];
+
+    memset(buf, 0xff, sizeof(buf));
+    for (; len > 0; addr += sizeof(buf), len -= sizeof(buf)) {
+        address_space_write_rom(&address_space_memory, addr,
+                                MEMTXATTRS_UNSPECIFIED, buf, sizeof(buf));
+    }
+}
+
+/* Flash bits can only be cleared by programming.  */
+static void stellaris_flash_program(stellaris_flash_state *s)
+{
+    hwaddr addr = s->fma & ~3;
+    uint8_t buf[4];
+
+    address_space_read(&address_space_memory, addr, MEMTXATTRS_UNSPECIFIED,
+                       buf, sizeof(buf));
+    stl_le_p(buf, ldl_le_p(buf) & s->fmd);
+    address_space_write_rom(&address_space_memory, addr,
+                            MEMTXATTRS_UNSPECIFIED, buf, sizeof(buf));
+}
+
+static void stellaris_flash_command(stellaris_flash_state *s, uint32_t value)
+{
+    if ((value & 0xffff0000) != STELLARIS_FLASH_FMC_WRKEY) {
+        return;
+    }
+
+    if (value & STELLARIS_FLASH_FMC_MERASE) {
+        stellaris_flash_erase(s, 0, s->flash_size);
+    } else if (value & (STELLARIS_FLASH_FMC_WRITE |
+                        STELLARIS_FLASH_FMC_ERASE)) {
+        if (s->fma >= s->flash_size) {
+            s->fcris |= STELLARIS_FLASH_INT_ACCESS;
+            stellaris_flash_update(s);
+            return;
+        }
+        if (value & STELLARIS_FLASH_FMC_ERASE) {
+            stellaris_flash_erase(s, s->fma & ~(STELLARIS_FLASH_PAGE_SIZE - 1),
+                                  STELLARIS_FLASH_PAGE_SIZE);
+        } else {
+            stellaris_flash_program(s);
+        }
+    } else if (value & STELLARIS_FLASH_FMC_COMT) {
+        /* Committing the USER registers is not modelled.  */
+        qemu_log_mask(LOG_UNIMP, "stellaris_flash: FMC.COMT not implemented\n");
+        return;
+    } else {
+        return;
+    }
+    s->fcris |= STELLARIS_FLASH_INT_PROGRAM;
+    stellaris_flash_update(s);
+}
+
+static uint64_t stellaris_flash_read(void *opaque, hwaddr offset,
+                                     unsigned size)
+{
+    stellaris_flash_state *s = (stellaris_flash_state *)opaque;
+
+    switch (offset) {
+    case 0x00: /* FMA */
+        return s->fma;
+    case 0x04: /* FMD */
+        return s->fmd;
+    case 0x08: /* FMC */
+        /* Operations are already complete.  */
+        return 0;
+    case 0x0c: /* FCRIS */
+        return s->fcris;
+    case 0x10: /* FCIM */
+        return s->fcim;
+    case 0x14: /* FCMISC */
+        return s->fcris & s->fcim;
+    default:
+        qemu_log_mask(LOG_GUEST_ERROR,
+                      "stellaris_flash: read at bad offset 0x%x\n",
+                      (int)offset);
+        return 0;
+    }
+}
+
+static void stellaris_flash_write(void *opaque, hwaddr offset,
+                                  uint64_t value, unsigned size)
+{
+    stellaris_flash_state *s = (stellaris_flash_state *)opaque;
+
+    switch (offset) {
+    case 0x00: /* FMA */
+        s->fma = value & 0x3ffff;
+        break;
+    case 0x04: /* FMD */
+        s->fmd = value;
+        break;
+    case 0x08: /* FMC */
+        stellaris_flash_command(s, value);
+        break;
+    case 0x0c: /* FCRIS */
+        break;
+    case 0x10: /* FCIM */
+        s->fcim = value & (STELLARIS_FLASH_INT_ACCESS |
+                           STELLARIS_FLASH_INT_PROGRAM);
+        stellaris_flash_update(s);
+        break;
+    case 0x14: /* FCMISC */
+        s->fcris &= ~value;
+        stellaris_flash_update(s);
+        break;
+    default:
+        qemu_log_mask(LOG_GUEST_ERROR,
+                      "stellaris_flash: write at bad offset 0x%x\n",
+                      (int)offset);
+    }
+}
+
+static const MemoryRegionOps stellaris_flash_ops = {
+    .read = stellaris_flash_read,
+    .write = stellaris_flash_write,
+    .endianness = DEVICE_NATIVE_ENDIAN,
+    .valid.min_access_size = 4,
+    .valid.max_access_size = 4,
+};
+
+static void stellaris_flash_reset(DeviceState *dev)
+{
+    stellaris_flash_state *s = STELLARIS_FLASH(dev);
+
+    s->fma = 0;
+    s->fmd = 0;
+    s->fcris = 0;
+    s->fcim = 0;
+    stellaris_flash_update(s);
+}
+
+static const VMStateDescription vmstate_stellaris_flash = {
+    .name = "stellaris_flash",
+    .version_id = 1,
+    .minimum_version_id = 1,
+    .fields = (VMStateField[]) {
+        VMSTATE_UINT32(fma, stellaris_flash_state),
+        VMSTATE_UINT32(fmd, stellaris_flash_state),
+        VMSTATE_UINT32(fcris, stellaris_flash_state),
+        VMSTATE_UINT32(fcim, stellaris_flash_state),
+        VMSTATE_END_OF_LIST()
+    }
+};
+
+static void stellaris_flash_init(Object *obj)
+{
+    stellaris_flash_state *s = STELLARIS_FLASH(obj);
+    SysBusDevice *sbd = SYS_BUS_DEVICE(obj);
+
+    sysbus_init_irq(sbd, &s->irq);
+    memory_region_init_io(&s->iomem, obj, &stellaris_flash_ops, s,
+                          "flash-control", 0x1000);
+    sysbus_init_mmio(sbd, &s->iomem);
+}
+
+static Property stellaris_flash_properties[] = {
+    DEFINE_PROP_UINT32("flash-size", stellaris_flash_state, flash_size, 0),
+    DEFINE_PROP_END_OF_LIST()
+};
+
 /* Board init.  */
 static stellaris_board_info stellaris_boards[] = {
   { "LM3S811EVB",
@@ -1344,27 +1546,42 @@ static void stellaris_init(MachineState *ms, stellaris_board_info *board)
     qemu_irq adc;
     int sram_size;
     int flash_size;
+    const char *kernel_filename = ms->kernel_filename;
     I2CBus *i2c;
     DeviceState *dev;
     DeviceState *ssys_dev;
     int i;
     int j;
 
-    MemoryRegion *sram = g_new(MemoryRegion, 1);
-    MemoryRegion *flash = g_new(MemoryRegion, 1);
     MemoryRegion *system_memory = get_system_memory();
 
     flash_size = (((board->dc0 & 0xffff) + 1) << 1) * 1024;
     sram_size = ((board->dc0 >> 18) + 1) * 1024;
 
-    /* Flash programming is done via the SCU, so pretend it is ROM.  */
-    memory_region_init_rom(flash, NULL, "stellaris.flash", flash_size,
-                           &error_fatal);
-    memory_region_add_subregion(system_memory, 0, flash);
+    if (ms->memory_map) {
+        memory_map_init(ms->memory_map, system_memory, &error_fatal);
+    } else {
+        MemoryRegion *sram = g_new(MemoryRegion, 1);
+        MemoryRegion *flash = g_new(MemoryRegion, 1);
+
+        /*
+         * Flash programming is done via the flash controller registers,
+         * so it is ROM for the CPU.
+         */
+        if (armv7m_init_cached_flash(flash, NULL, "stellaris.flash", 0,
+                                     flash_size, kernel_filename,
+                                     ms->flash_cache)) {
+            kernel_filename = NULL;
+        } else {
+            memory_region_init_rom(flash, NULL, "stellaris.flash", flash_size,
+                                   &error_fatal);
+        }
+        memory_region_add_subregion(system_memory, 0, flash);
 
-    memory_region_init_ram(sram, NULL, "stellaris.sram", sram_size,
-                           &error_fatal);
-    memory_region_add_subregion(system_memory, 0x20000000, sram);
+        memory_region_init_ram(sram, NULL, "stellaris.sram", sram_size,
+                               &error_fatal);
+        memory_region_add_subregion(system_memory, 0x20000000, sram);
+    }
 
     nvic = qdev_new(TYPE_ARMV7M);
     qdev_prop_set_uint32(nvic, "num-irq", NUM_IRQ_LINES);
@@ -1561,6 +1778,12 @@ static void stellaris_init(MachineState *ms, stellaris_board_info *board)
         }
     }
 
+    dev = qdev_new(TYPE_STELLARIS_FLASH);
+    qdev_prop_set_uint32(dev, "flash-size", flash_size);
+    sysbus_realize_and_unref(SYS_BUS_DEVICE(dev), &error_fatal);
+    sysbus_mmio_map(SYS_BUS_DEVICE(dev), 0, 0x400fd000);
+    sysbus_connect_irq(SYS_BUS_DEVICE(dev), 0, qdev_get_gpio_in(nvic, 29));
+
     /* Add dummy regions for the devices we don't implement yet,
      * so guest accesses don't cause unlogged crashes.
      */
@@ -1571,9 +1794,8 @@ static void stellaris_init(MachineState *ms, stellaris_board_info *board)
     create_unimplemented_device("QEI-1", 0x4002d000, 0x1000);
     create_unimplemented_device("analogue-comparator", 0x4003c000, 0x1000);
     create_unimplemented_device("hibernation", 0x400fc000, 0x1000);
-    create_unimplemented_device("flash-control", 0x400fd000, 0x1000);
 
-    armv7m_load_kernel(ARM_CPU(first_cpu), ms->kernel_filename, flash_size);
+    armv7m_load_kernel(ARM_CPU(first_cpu), kernel_filename, flash_size);
 }
 
 /* FIXME: Figure out how to generate these from stellaris_boards.  */
@@ -1673,6 +1895,23 @@ static const TypeInfo stellaris_adc_info = {
     .class_init    = stellaris_adc_class_init,
 };
 
+static void stellaris_flash_class_init(ObjectClass *klass, void *data)
+{
+    DeviceClass *dc = DEVICE_CLASS(klass);
+
+    dc->vmsd = &vmstate_stellaris_flash;
+    dc->reset = stellaris_flash_reset;
+    device_class_set_props(dc, stellaris_flash_properties);
+}
+
+static const TypeInfo stellaris_flash_info = {
+    .name          = TYPE_STELLARIS_FLASH,
+    .parent        = TYPE_SYS_BUS_DEVICE,
+    .instance_size = sizeof(stellaris_flash_state),
+    .instance_init = stellaris_flash_init,
+    .class_init    = stellaris_flash_class_init,
+};
+
 static void stellaris_sys_class_init(ObjectClass *klass, void *data)
 {
     DeviceClass *dc = DEVICE_CLASS(klass);
@@ -1698,6 +1937,7 @@ static void stellaris_register_types(void)
     type_register_static(&stellaris_i2c_info);
     type_register_static(&stellaris_gptm_info);
     type_register_static(&stellaris_adc_info);
+    type_register_static(&stellaris_flash_info);
     type_register_static(&stellaris_sys_info);
 }
 
@@ -29,6 +29,7 @@
 #include "exec/address-spaces.h"
 #include "hw/arm/stm32f205_soc.h"
 #include "hw/qdev-properties.h"
+#include "hw/memory-map.h"
 #include "sysemu/sysemu.h"
 #include "qemu/soc-options.h"
 
@@ -41,11 +42,13 @@ static const uint32_t adc_addr[STM_NUM_ADCS] = { 0x40012000, 0x40012100,
     0x40012200 };
 static const uint32_t spi_addr[STM_NUM_SPIS] = { 0x40013000, 0x40003800,
     0x40003C00 };
+#define FLASH_IF_ADDR 0x40023C00
 
 static const int timer_irq[STM_NUM_TIMERS] = {28, 29, 30, 50};
 static const int usart_irq[STM_NUM_USARTS] = {37, 38, 39, 52, 53, 71};
 #define ADC_IRQ 18
 static const int spi_irq[STM_NUM_SPIS] = {35, 36, 51};
+#define FLASH_IRQ 4
 
 static void stm32f205_soc_initfn(Object *obj)
 {
@@ -75,6 +78,8 @@ static void stm32f205_soc_initfn(Object *obj)
     for (i = 0; i < STM_NUM_SPIS; i++) {
         object_initialize_child(obj, "spi[*]", &s->spi[i], TYPE_STM32F2XX_SPI);
     }
+
+    object_initialize_child(obj, "flash", &s->flash, TYPE_STM32F2XX_FLASH);
 }
 
 static void stm32f205_soc_realize(DeviceState *dev_soc, Error **errp)
@@ -83,29 +88,51 @@ static void stm32f205_soc_realize(DeviceState *dev_soc, Error **errp)
     DeviceState *dev, *armv7m;
     SysBusDevice *busdev;
     int i;
-    uint32_t flash_base_addr = FLASH_BASE_ADDRESS, flash_size = FLASH_SIZE;
-    uint32_t flash_alias_base_addr = FLASH_ALIAS_BASE_ADDRESS;
-    uint32_t sram_base_addr = SRAM_BASE_ADDRESS, sram_size = SRAM_SIZE;
-
-    get_memory_ranges("0", &flash_base_addr, &flash_size, &sram_base_addr, &sram_size);
-    get_memory_ranges("1", &flash_alias_base_addr, NULL, NULL, NULL);
-
     MemoryRegion *system_memory = get_system_memory();
-    MemoryRegion *sram = g_new(MemoryRegion, 1);
-    MemoryRegion *flash = g_new(MemoryRegion, 1);
-    MemoryRegion *flash_alias = g_new(MemoryRegion, 1);
 
-    memory_region_init_rom(flash, OBJECT(dev_soc), "STM32F205.flash", 
-                           flash_size, &error_fatal);
-    memory_region_init_alias(flash_alias, OBJECT(dev_soc), 
-                             "STM32F205.flash.alias", flash, 0, flash_size);
+    if (s->memory_map) {
+        if (!memory_map_init(s->memory_map, system_memory, errp)) {
+            return;
+        }
+    } else {
+        uint32_t flash_base_addr = FLASH_BASE_ADDRESS, flash_size = FLASH_SIZE;
+        uint32_t flash_alias_base_addr = FLASH_ALIAS_BASE_ADDRESS;
+        uint32_t sram_base_addr = SRAM_BASE_ADDRESS, sram_size = SRAM_SIZE;
+
+        get_memory_ranges("0", &flash_base_addr, &flash_size, &sram_base_addr, &sram_size);
+        get_memory_ranges("1", &flash_alias_base_addr, NULL, NULL, NULL);
+
+        MemoryRegion *sram = g_new(MemoryRegion, 1);
+        MemoryRegion *flash;
+        MemoryRegion *flash_alias = g_new(MemoryRegion, 1);
+
+        /*
+         * Flash mapped from the flash cache stays read-only; otherwise it
+         * belongs to the flash interface, which can program and erase it.
+         */
+        flash = g_new(MemoryRegion, 1);
+        s->flash_image_loaded =
+            armv7m_init_cached_flash(flash, OBJECT(dev_soc), "STM32F205.flash",
+                                     flash_base_addr, flash_size,
+                                     s->flash_image, s->flash_cache);
+        if (!s->flash_image_loaded) {
+            g_free(flash);
+            qdev_prop_set_uint32(DEVICE(&s->flash), "flash-size", flash_size);
+            if (!sysbus_realize(SYS_BUS_DEVICE(&s->flash), errp)) {
+                return;
+            }
+            flash = sysbus_mmio_get_region(SYS_BUS_DEVICE(&s->flash), 1);
+        }
+        memory_region_init_alias(flash_alias, OBJECT(dev_soc),
+                                 "STM32F205.flash.alias", flash, 0, flash_size);
 
-    memory_region_add_subregion(system_memory, flash_base_addr, flash);
-    memory_region_add_subregion(system_memory, flash_alias_base_addr, flash_alias);
+        memory_region_add_subregion(system_memory, flash_base_addr, flash);
+        memory_region_add_subregion(system_memory, flash_alias_base_addr, flash_alias);
 
-    memory_region_init_ram(sram, NULL, "STM32F205.sram", sram_size,
-                           &error_fatal);
-    memory_region_add_subregion(system_memory, sram_base_addr, sram);
+        memory_region_init_ram(sram, NULL, "STM32F205.sram", sram_size,
+                               &error_fatal);
+        memory_region_add_subregion(system_memory, sram_base_addr, sram);
+    }
 
     armv7m = DEVICE(&s->armv7m);
     qdev_prop_set_uint32(armv7m, "num-irq", 96);
@@ -179,10 +206,20 @@ static void stm32f205_soc_realize(DeviceState *dev_soc, Error **errp)
         sysbus_mmio_map(busdev, 0, spi_addr[i]);
         sysbus_connect_irq(busdev, 0, qdev_get_gpio_in(armv7m, spi_irq[i]));
     }
+
+    /* Flash interface registers */
+    if (DEVICE(&s->flash)->realized) {
+        busdev = SYS_BUS_DEVICE(&s->flash);
+        sysbus_mmio_map(busdev, 0, FLASH_IF_ADDR);
+        sysbus_connect_irq(busdev, 0, qdev_get_gpio_in(armv7m, FLASH_IRQ));
+    }
 }
 
 static Property stm32f205_soc_properties[] = {
     DEFINE_PROP_STRING("cpu-type", STM32F205State, cpu_type),
+    DEFINE_PROP_STRING("flash-image", STM32F205State, flash_image),
+    DEFINE_PROP_STRING("flash-cache", STM32F205State, flash_cache),
+    DEFINE_PROP_STRING("memory-map", STM32F205State, memory_map),
     DEFINE_PROP_END_OF_LIST(),
 };
 
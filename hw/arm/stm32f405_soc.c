@@ -42,12 +42,14 @@ static const uint32_t adc_addr[] = { 0x40012000, 0x40012100, 0x40012200,
 static const uint32_t spi_addr[] =   { 0x40013000, 0x40003800, 0x40003C00,
                                        0x40013400, 0x40015000, 0x40015400 };
 #define EXTI_ADDR                      0x40013C00
+#define FLASH_IF_ADDR                  0x40023C00
 
 #define SYSCFG_IRQ               71
 static const int usart_irq[] = { 37, 38, 39, 52, 53, 71, 82, 83 };
 static const int timer_irq[] = { 28, 29, 30, 50 };
 #define ADC_IRQ 18
 static const int spi_irq[] =   { 35, 36, 51, 0, 0, 0 };
+#define FLASH_IRQ 4
 static const int exti_irq[] =  { 6, 7, 8, 9, 10, 23, 23, 23, 23, 23, 40,
                                  40, 40, 40, 40, 40} ;
 
@@ -80,6 +82,8 @@ static void stm32f405_soc_initfn(Object *obj)
     }
 
     object_initialize_child(obj, "exti", &s->exti, TYPE_STM32F4XX_EXTI);
+
+    object_initialize_child(obj, "flash", &s->flash, TYPE_STM32F2XX_FLASH);
 }
 
 static void stm32f405_soc_realize(DeviceState *dev_soc, Error **errp)
@@ -91,17 +95,18 @@ static void stm32f405_soc_realize(DeviceState *dev_soc, Error **errp)
     Error *err = NULL;
     int i;
 
-    memory_region_init_rom(&s->flash, OBJECT(dev_soc), "STM32F405.flash",
-                           FLASH_SIZE, &err);
-    if (err != NULL) {
-        error_propagate(errp, err);
+    /* Flash interface, it also owns the flash memory */
+    qdev_prop_set_uint32(DEVICE(&s->flash), "flash-size", FLASH_SIZE);
+    if (!sysbus_realize(SYS_BUS_DEVICE(&s->flash), errp)) {
         return;
     }
     memory_region_init_alias(&s->flash_alias, OBJECT(dev_soc),
-                             "STM32F405.flash.alias", &s->flash, 0,
-                             FLASH_SIZE);
+                             "STM32F405.flash.alias",
+                             sysbus_mmio_get_region(SYS_BUS_DEVICE(&s->flash),
+                                                    1),
+                             0, FLASH_SIZE);
 
-    memory_region_add_subregion(system_memory, FLASH_BASE_ADDRESS, &s->flash);
+    sysbus_mmio_map(SYS_BUS_DEVICE(&s->flash), 1, FLASH_BASE_ADDRESS);
     memory_region_add_subregion(system_memory, 0, &s->flash_alias);
 
     memory_region_init_ram(&s->sram, NULL, "STM32F405.sram", SRAM_SIZE,
@@ -205,6 +210,11 @@ static void stm32f405_soc_realize(DeviceState *dev_soc, Error **errp)
         qdev_connect_gpio_out(DEVICE(&s->syscfg), i, qdev_get_gpio_in(dev, i));
     }
 
+    /* Flash interface registers */
+    busdev = SYS_BUS_DEVICE(&s->flash);
+    sysbus_mmio_map(busdev, 0, FLASH_IF_ADDR);
+    sysbus_connect_irq(busdev, 0, qdev_get_gpio_in(armv7m, FLASH_IRQ));
+
     create_unimplemented_device("timer[7]",    0x40001400, 0x400);
     create_unimplemented_device("timer[12]",   0x40001800, 0x400);
     create_unimplemented_device("timer[6]",    0x40001000, 0x400);
@@ -239,7 +249,6 @@ static void stm32f405_soc_realize(DeviceState *dev_soc, Error **errp)
     create_unimplemented_device("GPIOI",       0x40022000, 0x400);
     create_unimplemented_device("CRC",         0x40023000, 0x400);
     create_unimplemented_device("RCC",         0x40023800, 0x400);
-    create_unimplemented_device("Flash Int",   0x40023C00, 0x400);
     create_unimplemented_device("BKPSRAM",     0x40024000, 0x400);
     create_unimplemented_device("DMA1",        0x40026000, 0x400);
     create_unimplemented_device("DMA2",        0x40026400, 0x400);
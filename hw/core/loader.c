@@ -1289,6 +1289,166 @@ void rom_transaction_end(bool commit)
     }
 }
 
+#ifdef CONFIG_POSIX
+/*
+ * Returns the path of the cached flash image for an ELF file. The name is a
+ * hash of the file contents and of everything else that affects the image.
+ */
+static char *flash_cache_path(const char *filename, const char *cache_dir,
+                              hwaddr base, uint64_t size, int big_endian,
+                              int elf_machine, Error **errp)
+{
+    g_autoptr(GMappedFile) mapped_file = NULL;
+    g_autoptr(GChecksum) checksum = NULL;
+    uint64_t params[] = { base, size, big_endian, elf_machine };
+    GError *gerr = NULL;
+
+    mapped_file = g_mapped_file_new(filename, false, &gerr);
+    if (!mapped_file) {
+        error_setg(errp, "could not read '%s': %s", filename, gerr->message);
+        g_error_free(gerr);
+        return NULL;
+    }
+
+    checksum = g_checksum_new(G_CHECKSUM_SHA256);
+    g_checksum_update(checksum, (const guchar *)params, sizeof(params));
+    g_checksum_update(checksum,
+                      (const guchar *)g_mapped_file_get_contents(mapped_file),
+                      g_mapped_file_get_length(mapped_file));
+
+    return g_strdup_printf("%s/%s.flash", cache_dir,
+                           g_checksum_get_string(checksum));
+}
+
+/*
+ * Loads the ELF file as ROMs, copies them into a new image file and
+ * atomically renames it to @path, so that concurrent instances never see a
+ * partially written image. The ROMs are dropped afterwards.
+ */
+static bool flash_cache_build(const char *path, const char *filename,
+                              hwaddr base, uint64_t size, int big_endian,
+                              int elf_machine, Error **errp)
+{
+    g_autofree char *tmp_path = g_strdup_printf("%s.XXXXXX", path);
+    uint8_t *image = MAP_FAILED;
+    bool ok = false;
+    int fd = -1;
+    int ret;
+    Rom *rom;
+
+    rom_transaction_begin();
+
+    ret = load_elf_as(filename, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+                      big_endian, elf_machine, 1, 0, NULL);
+    if (ret < 0) {
+        error_setg(errp, "could not load '%s': %s", filename,
+                   load_elf_strerror(ret));
+        goto out;
+    }
+    QTAILQ_FOREACH(rom, &roms, next) {
+        if (!rom->committed &&
+            (rom->addr < base || rom->addr + rom->romsize > base + size)) {
+            error_setg(errp, "'%s' is loaded to 0x%" HWADDR_PRIx
+                       ", outside of flash", filename, rom->addr);
+            goto out;
+        }
+    }
+
+    fd = mkstemp(tmp_path);
+    if (fd < 0) {
+        error_setg_errno(errp, errno, "could not create '%s'", tmp_path);
+        goto out;
+    }
+    if (ftruncate(fd, size) < 0) {
+        error_setg_errno(errp, errno, "could not resize '%s'", tmp_path);
+        goto out;
+    }
+    image = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (image == MAP_FAILED) {
+        error_setg_errno(errp, errno, "could not map '%s'", tmp_path);
+        goto out;
+    }
+
+    /* The rest of the image is zero, like freshly allocated flash RAM */
+    QTAILQ_FOREACH(rom, &roms, next) {
+        if (!rom->committed) {
+            memcpy(image + (rom->addr - base), rom->data, rom->datasize);
+        }
+    }
+
+    if (fchmod(fd, 0444) < 0 || rename(tmp_path, path) < 0) {
+        error_setg_errno(errp, errno, "could not create '%s'", path);
+        goto out;
+    }
+    ok = true;
+
+out:
+    if (image != MAP_FAILED) {
+        munmap(image, size);
+    }
+    if (fd >= 0) {
+        close(fd);
+        if (!ok) {
+            unlink(tmp_path);
+        }
+    }
+    rom_transaction_end(false);
+    return ok;
+}
+
+bool load_elf_flash_cached(MemoryRegion *mr, Object *owner, const char *name,
+                           hwaddr base, uint64_t size, const char *filename,
+                           const char *cache_dir, int big_endian,
+                           int elf_machine, Error **errp)
+{
+    g_autofree char *path = NULL;
+    Error *err = NULL;
+    int fd;
+
+    path = flash_cache_path(filename, cache_dir, base, size, big_endian,
+                            elf_machine, errp);
+    if (!path) {
+        return false;
+    }
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        if (!flash_cache_build(path, filename, base, size, big_endian,
+                               elf_machine, errp)) {
+            return false;
+        }
+        fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            error_setg_errno(errp, errno, "could not open '%s'", path);
+            return false;
+        }
+    }
+
+    /*
+     * A private mapping shares the page cache with all other instances until
+     * a page is written, which only happens for debugger writes to flash.
+     */
+    memory_region_init_ram_from_fd(mr, owner, name, size, 0, fd, 0, &err);
+    if (err) {
+        close(fd);
+        error_propagate(errp, err);
+        return false;
+    }
+    memory_region_set_readonly(mr, true);
+    vmstate_register_ram(mr, owner ? DEVICE(owner) : NULL);
+    return true;
+}
+#else
+bool load_elf_flash_cached(MemoryRegion *mr, Object *owner, const char *name,
+                           hwaddr base, uint64_t size, const char *filename,
+                           const char *cache_dir, int big_endian,
+                           int elf_machine, Error **errp)
+{
+    error_setg(errp, "flash image cache is not supported on this host");
+    return false;
+}
+#endif
+
 static Rom *find_rom(hwaddr addr, size_t size)
 {
     Rom *rom;
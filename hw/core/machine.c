@@ -427,6 +427,38 @@ static void machine_set_firmware(Object *obj, const char *value, Error **errp)
     ms->firmware = g_strdup(value);
 }
 
+static char *machine_get_flash_cache(Object *obj, Error **errp)
+{
+    MachineState *ms = MACHINE(obj);
+
+    return g_strdup(ms->flash_cache);
+}
+
+static void machine_set_flash_cache(Object *obj, const char *value,
+                                    Error **errp)
+{
+    MachineState *ms = MACHINE(obj);
+
+    g_free(ms->flash_cache);
+    ms->flash_cache = g_strdup(value);
+}
+
+static char *machine_get_memory_map(Object *obj, Error **errp)
+{
+    MachineState *ms = MACHINE(obj);
+
+    return g_strdup(ms->memory_map);
+}
+
+static void machine_set_memory_map(Object *obj, const char *value,
+                                   Error **errp)
+{
+    MachineState *ms = MACHINE(obj);
+
+    g_free(ms->memory_map);
+    ms->memory_map = g_strdup(value);
+}
+
 static void machine_set_suppress_vmdesc(Object *obj, bool value, Error **errp)
 {
     MachineState *ms = MACHINE(obj);
@@ -932,6 +964,16 @@ static void machine_class_init(ObjectClass *oc, void *data)
     object_class_property_set_description(oc, "firmware",
         "Firmware image");
 
+    object_class_property_add_str(oc, "flash-cache",
+        machine_get_flash_cache, machine_set_flash_cache);
+    object_class_property_set_description(oc, "flash-cache",
+        "Directory with flash images shared between instances");
+
+    object_class_property_add_str(oc, "memory-map",
+        machine_get_memory_map, machine_set_memory_map);
+    object_class_property_set_description(oc, "memory-map",
+        "JSON file describing flash, RAM and aliases of the board");
+
     object_class_property_add_bool(oc, "suppress-vmdesc",
         machine_get_suppress_vmdesc, machine_set_suppress_vmdesc);
     object_class_property_set_description(oc, "suppress-vmdesc",
@@ -1039,6 +1081,8 @@ static void machine_finalize(Object *obj)
     g_free(ms->dumpdtb);
     g_free(ms->dt_compatible);
     g_free(ms->firmware);
+    g_free(ms->flash_cache);
+    g_free(ms->memory_map);
     g_free(ms->device_memory);
     g_free(ms->nvdimms_state);
     g_free(ms->numa_state);
@@ -1246,6 +1290,11 @@ void machine_run_board_init(MachineState *machine)
                     cc->deprecation_note);
     }
 
+    /* Boards create flash from the memory map, not from the image cache */
+    if (machine->memory_map && machine->flash_cache) {
+        warn_report("flash-cache is ignored when memory-map is given");
+    }
+
     if (machine->cgs) {
         /*
          * With confidential guests, the host can't see the real
@@ -0,0 +1,191 @@
+/*
+ * Board memory map described in a JSON file
+ *
+ * Copyright (c) 2021 iSYSTEM Labs d.o.o.
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "qapi/error.h"
+#include "qapi/qmp/qdict.h"
+#include "qapi/qmp/qjson.h"
+#include "qapi/qmp/qlist.h"
+#include "qapi/qmp/qnum.h"
+#include "qapi/qmp/qstring.h"
+#include "qemu/cutils.h"
+#include "exec/memory.h"
+#include "hw/memory-map.h"
+
+/* Accepts JSON numbers and strings like "0x1000" or "64k" */
+static bool memory_map_get_u64(QDict *region, const char *name,
+                               const char *key, uint64_t *value,
+                               bool required, Error **errp)
+{
+    QObject *obj = qdict_get(region, key);
+
+    if (!obj) {
+        if (required) {
+            error_setg(errp, "memory region '%s': '%s' is missing",
+                       name, key);
+            return false;
+        }
+        return true;
+    }
+
+    switch (qobject_type(obj)) {
+    case QTYPE_QNUM:
+        if (qnum_get_try_uint(qobject_to(QNum, obj), value)) {
+            return true;
+        }
+        break;
+    case QTYPE_QSTRING:
+        if (qemu_strtosz(qstring_get_str(qobject_to(QString, obj)), NULL,
+                         value) == 0) {
+            return true;
+        }
+        break;
+    default:
+        break;
+    }
+    error_setg(errp, "memory region '%s': '%s' must be an unsigned number",
+               name, key);
+    return false;
+}
+
+static bool memory_map_add_region(QDict *region, MemoryRegion *sysmem,
+                                  GHashTable *regions, bool aliases,
+                                  Error **errp)
+{
+    const char *name = qdict_get_try_str(region, "name");
+    const char *type = qdict_get_try_str(region, "type");
+    uint64_t base, size = 0, offset = 0, priority = 0;
+    MemoryRegion *mr, *target = NULL;
+    Error *err = NULL;
+    bool is_alias;
+
+    if (!name || !type) {
+        error_setg(errp, "memory region needs 'name' and 'type' strings");
+        return false;
+    }
+    is_alias = !strcmp(type, "alias");
+    if (is_alias != aliases) {
+        /* Aliases are created in the second pass, after their targets */
+        return true;
+    }
+    if (!is_alias && strcmp(type, "flash") && strcmp(type, "ram")) {
+        error_setg(errp, "memory region '%s': unknown type '%s'", name, type);
+        return false;
+    }
+    if (g_hash_table_contains(regions, name)) {
+        error_setg(errp, "memory region '%s' is defined twice", name);
+        return false;
+    }
+
+    if (!memory_map_get_u64(region, name, "base", &base, true, errp) ||
+        !memory_map_get_u64(region, name, "size", &size, !is_alias, errp) ||
+        !memory_map_get_u64(region, name, "offset", &offset, false, errp) ||
+        !memory_map_get_u64(region, name, "priority", &priority, false,
+                            errp)) {
+        return false;
+    }
+
+    mr = g_new(MemoryRegion, 1);
+    if (is_alias) {
+        const char *alias = qdict_get_try_str(region, "alias");
+        uint64_t target_size;
+
+        target = alias ? g_hash_table_lookup(regions, alias) : NULL;
+        if (!target) {
+            error_setg(errp, "memory region '%s': 'alias' must name a flash "
+                       "or RAM region", name);
+            goto fail;
+        }
+        target_size = memory_region_size(target);
+        if (!qdict_haskey(region, "size")) {
+            size = offset < target_size ? target_size - offset : 0;
+        }
+        if (size == 0 || offset > target_size ||
+            size > target_size - offset) {
+            error_setg(errp, "memory region '%s' is outside of '%s'",
+                       name, alias);
+            goto fail;
+        }
+        memory_region_init_alias(mr, NULL, name, target, offset, size);
+    } else if (!strcmp(type, "flash")) {
+        /* Flash programming is not modelled, so it is ROM for the guest */
+        memory_region_init_rom(mr, NULL, name, size, &err);
+    } else {
+        memory_region_init_ram(mr, NULL, name, size, &err);
+    }
+    if (err) {
+        error_propagate(errp, err);
+        goto fail;
+    }
+
+    memory_region_add_subregion_overlap(sysmem, base, mr, (int)priority);
+    g_hash_table_insert(regions, g_strdup(name), mr);
+    return true;
+
+fail:
+    g_free(mr);
+    return false;
+}
+
+bool memory_map_init(const char *filename, MemoryRegion *sysmem,
+                     Error **errp)
+{
+    g_autofree char *contents = NULL;
+    g_autoptr(GHashTable) regions = NULL;
+    GError *gerr = NULL;
+    QObject *obj;
+    QList *list = NULL;
+    QListEntry *entry;
+    bool ok = false;
+    int pass;
+
+    if (!g_file_get_contents(filename, &contents, NULL, &gerr)) {
+        error_setg(errp, "could not read memory map '%s': %s", filename,
+                   gerr->message);
+        g_error_free(gerr);
+        return false;
+    }
+
+    obj = qobject_from_json(contents, errp);
+    if (!obj) {
+        error_prepend(errp, "memory map '%s': ", filename);
+        return false;
+    }
+    if (qobject_to(QDict, obj)) {
+        list = qdict_get_qlist(qobject_to(QDict, obj), "regions");
+    }
+    if (!list) {
+        error_setg(errp, "memory map '%s' must be an object with array "
+                   "'regions'", filename);
+        goto out;
+    }
+
+    regions = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    for (pass = 0; pass < 2; pass++) {
+        QLIST_FOREACH_ENTRY(list, entry) {
+            QDict *region = qobject_to(QDict, qlist_entry_obj(entry));
+
+            if (!region) {
+                error_setg(errp, "memory map '%s': regions must be objects",
+                           filename);
+                goto out;
+            }
+            if (!memory_map_add_region(region, sysmem, regions, pass == 1,
+                                       errp)) {
+                error_prepend(errp, "memory map '%s': ", filename);
+                goto out;
+            }
+        }
+    }
+    ok = true;
+
+out:
+    qobject_unref(obj);
+    return ok;
+}
@@ -220,6 +220,45 @@ static int exc_group_prio(NVICState *s, int rawprio, bool targets_secure)
     return rawprio;
 }
 
+/* Note that vec may be pending or active, so the next recompute
+ * must look at it
+ */
+static void nvic_mark_live(NVICState *s, VecInfo *vec)
+{
+    if (vec >= s->sec_vectors &&
+        vec < s->sec_vectors + NVIC_INTERNAL_VECTORS) {
+        set_bit(NVIC_MAX_VECTORS + (vec - s->sec_vectors), s->live);
+    } else {
+        set_bit(vec - s->vectors, s->live);
+    }
+}
+
+/* Make the next recompute look at every exception, for when the state
+ * has been changed wholesale (register writes touching many exceptions
+ * or migration)
+ */
+static void nvic_mark_all_live(NVICState *s)
+{
+    bitmap_set(s->live, 0, s->num_irq);
+    bitmap_set(s->live, NVIC_MAX_VECTORS, NVIC_INTERNAL_VECTORS);
+}
+
+/* Return the lowest exception number >= irq with a live bit set in
+ * either bank, or s->num_irq if there is none
+ */
+static int nvic_next_live(NVICState *s, int irq)
+{
+    int ns = find_next_bit(s->live, s->num_irq, irq);
+    int sec;
+
+    if (irq >= NVIC_INTERNAL_VECTORS) {
+        return ns;
+    }
+    sec = find_next_bit(s->live, NVIC_MAX_VECTORS + NVIC_INTERNAL_VECTORS,
+                        NVIC_MAX_VECTORS + irq) - NVIC_MAX_VECTORS;
+    return sec < NVIC_INTERNAL_VECTORS ? MIN(ns, sec) : ns;
+}
+
 /* Recompute vectpending and exception_prio for a CPU which implements
  * the Security extension
  */
@@ -241,10 +280,11 @@ static void nvic_recompute_state_secure(NVICState *s)
      * Annoyingly, now we have two prigroup values (for S and NS)
      * we can't do the loop comparison on raw priority values.
      */
-    for (i = 1; i < s->num_irq; i++) {
+    for (i = nvic_next_live(s, 1); i < s->num_irq;
+         i = nvic_next_live(s, i + 1)) {
         for (bank = M_REG_S; bank >= M_REG_NS; bank--) {
             VecInfo *vec;
-            int prio, subprio;
+            int prio, subprio, bit;
             bool targets_secure;
 
             if (bank == M_REG_S) {
@@ -252,12 +292,19 @@ static void nvic_recompute_state_secure(NVICState *s)
                     continue;
                 }
                 vec = &s->sec_vectors[i];
+                bit = NVIC_MAX_VECTORS + i;
                 targets_secure = true;
             } else {
                 vec = &s->vectors[i];
+                bit = i;
                 targets_secure = !exc_is_banked(i) && exc_targets_secure(s, i);
             }
 
+            if (!vec->pending && !vec->active) {
+                clear_bit(bit, s->live);
+                continue;
+            }
+
             prio = exc_group_prio(s, vec->prio, targets_secure);
             subprio = vec->prio & ~nvic_gprio_mask(s, targets_secure);
             if (vec->enabled && vec->pending &&
@@ -305,9 +352,14 @@ static void nvic_recompute_state(NVICState *s)
         return;
     }
 
-    for (i = 1; i < s->num_irq; i++) {
+    for (i = find_next_bit(s->live, s->num_irq, 1); i < s->num_irq;
+         i = find_next_bit(s->live, s->num_irq, i + 1)) {
         VecInfo *vec = &s->vectors[i];
 
+        if (!vec->pending && !vec->active) {
+            clear_bit(i, s->live);
+            continue;
+        }
         if (vec->enabled && vec->pending && vec->prio < pend_prio) {
             pend_prio = vec->prio;
             pend_irq = i;
@@ -663,6 +715,7 @@ static void do_armv7m_nvic_set_pending(void *opaque, int irq, bool secure,
 
     if (!vec->pending) {
         vec->pending = 1;
+        nvic_mark_live(s, vec);
         nvic_irq_update(s);
     }
 }
@@ -761,6 +814,7 @@ void armv7m_nvic_set_pending_lazyfp(void *opaque, int irq, bool secure)
     }
     if (!vec->pending) {
         vec->pending = 1;
+        nvic_mark_live(s, vec);
         /*
          * We do not call nvic_irq_update(), because we know our caller
          * is going to handle causing us to take the exception by
@@ -1771,6 +1825,7 @@ static void nvic_writel(NVICState *s, uint32_t offset, uint32_t value,
 
         /* TODO: this is RAZ/WI from NS if DEMCR.SDME is set */
         s->vectors[ARMV7M_EXCP_DEBUG].active = (value & (1 << 8)) != 0;
+        nvic_mark_all_live(s);
         nvic_irq_update(s);
         break;
     case 0xd2c: /* Hard Fault Status.  */
@@ -2376,6 +2431,9 @@ static MemTxResult nvic_sysreg_write(void *opaque, hwaddr addr,
             if (value & (1 << i) &&
                 (attrs.secure || s->itns[startvec + i])) {
                 s->vectors[startvec + i].pending = setval;
+                if (setval) {
+                    set_bit(startvec + i, s->live);
+                }
             }
         }
         nvic_irq_update(s);
@@ -2640,6 +2698,7 @@ static int nvic_post_load(void *opaque, int version_id)
         }
     }
 
+    nvic_mark_all_live(s);
     nvic_recompute_state(s);
 
     return 0;
@@ -2772,6 +2831,8 @@ static void armv7m_nvic_reset(DeviceState *dev)
      * So we leave it disabled to catch logic errors.
      */
 
+    bitmap_zero(s->live, NVIC_MAX_VECTORS + NVIC_INTERNAL_VECTORS);
+
     s->exception_prio = NVIC_NOEXC_PRIO;
     s->vectpending = 0;
     s->vectpending_is_s_banked = false;
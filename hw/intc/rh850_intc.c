@@ -0,0 +1,534 @@
+/*
+ * RH850 interrupt controller (INTC1/INTC2)
+ *
+ * INTC1 handles channels 0..31, which are private to a CPU on multicore
+ * devices, INTC2 handles the remaining channels. Each channel has an EIC
+ * register with request flag, mask, priority and vector method, IMR
+ * registers give access to mask bits of 32 channels at once. On multicore
+ * devices each PE has its own INTC1, and EIBD registers of INTC2 select
+ * the PE which receives the interrupt of an INTC2 channel.
+ *
+ * Priority arbitration is split between this device and the CPU. The
+ * controller keeps for each of the 16 priority levels the channel which
+ * wins arbitration, the CPU then picks the highest level which is not
+ * masked by PMR and in-service priorities in ISPR. This way the CPU side
+ * check is a bit operation on every TB boundary, while the scan over
+ * channels is done only when the state of some channel changes.
+ *
+ * Datasheet: RH850/F1L Group User's Manual: Hardware, chapter Interrupt
+ *            Controller (INTC)
+ *
+ * Copyright (c) 2021 iSYSTEM Labs d.o.o.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2 or later, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/log.h"
+#include "qemu/module.h"
+#include "qapi/error.h"
+#include "hw/irq.h"
+#include "hw/registerfields.h"
+#include "hw/qdev-properties.h"
+#include "hw/intc/rh850_intc.h"
+#include "migration/vmstate.h"
+#include "cpu.h"
+
+REG16(EIC, 0)
+  FIELD(EIC, EIP,  0, 4)
+  FIELD(EIC, EITB, 6, 1)
+  FIELD(EIC, EIMK, 7, 1)
+  FIELD(EIC, EIRF, 12, 1)
+  FIELD(EIC, EICT, 15, 1)
+
+/* INTC1 offsets */
+REG32(IMR0, 0xf0)
+
+/* INTC2 offsets, EICn is at 2 * n as in INTC1, IMRm at 0x400 + 4 * m */
+REG32(IMR, 0x400)
+REG32(EIBD, 0x800)
+  FIELD(EIBD, PEID, 0, 3)
+
+#define EIC_WRITABLE (R_EIC_EIP_MASK | R_EIC_EITB_MASK | \
+                      R_EIC_EIMK_MASK | R_EIC_EIRF_MASK)
+#define EIC_RESET_VALUE (R_EIC_EIMK_MASK | R_EIC_EIP_MASK)
+
+/* INTC2 channels are bound to the first PE (PEID 1) after reset */
+#define EIBD_RESET_VALUE 1
+
+#define INTC1_SIZE 0x100
+#define INTC2_SIZE 0x1000
+
+static void rh850_intc_update_pe(RH850INTCPEState *pe)
+{
+    RH850INTCState *s = pe->intc;
+    uint32_t prio_pending = 0;
+    int w;
+
+    for (w = 0; w < DIV_ROUND_UP(s->num_irq, 32); w++) {
+        uint32_t bits = pe->pending[w];
+
+        while (bits) {
+            int irq = w * 32 + ctz32(bits);
+            uint16_t eic = irq < RH850_INTC1_NUM_IRQ ? pe->eic1[irq]
+                                                     : s->eic[irq];
+            int prio = FIELD_EX16(eic, EIC, EIP);
+
+            if (!(prio_pending & (1 << prio))) {
+                prio_pending |= 1 << prio;
+                pe->prio_irq[prio] = irq;
+            }
+            bits &= bits - 1;
+        }
+    }
+
+    pe->prio_pending = prio_pending;
+    qemu_set_irq(pe->irq, prio_pending != 0);
+}
+
+static void rh850_intc_update(RH850INTCState *s)
+{
+    int i;
+
+    for (i = 0; i < s->num_pe; i++) {
+        rh850_intc_update_pe(&s->pe[i]);
+    }
+}
+
+static uint16_t *rh850_intc_eic(RH850INTCState *s, int pe, int irq)
+{
+    return irq < RH850_INTC1_NUM_IRQ ? &s->pe[pe].eic1[irq] : &s->eic[irq];
+}
+
+static bool rh850_intc_eic_pending(uint16_t eic)
+{
+    return (eic & (R_EIC_EIRF_MASK | R_EIC_EIMK_MASK)) == R_EIC_EIRF_MASK;
+}
+
+/*
+ * Recomputes pending bit of one channel, call rh850_intc_update() after.
+ * pe selects INTC1 for channels 0..31 and is ignored for INTC2 channels.
+ */
+static void rh850_intc_sync_pending(RH850INTCState *s, int pe, int irq)
+{
+    uint32_t bit = 1u << (irq & 31);
+    int target, i;
+
+    if (irq < RH850_INTC1_NUM_IRQ) {
+        if (rh850_intc_eic_pending(s->pe[pe].eic1[irq])) {
+            s->pe[pe].pending[0] |= bit;
+        } else {
+            s->pe[pe].pending[0] &= ~bit;
+        }
+        return;
+    }
+
+    /* A channel bound to a PE which does not exist is never delivered */
+    target = -1;
+    if (rh850_intc_eic_pending(s->eic[irq])) {
+        target = FIELD_EX32(s->eibd[irq], EIBD, PEID) - 1;
+    }
+    for (i = 0; i < s->num_pe; i++) {
+        if (i == target) {
+            s->pe[i].pending[irq / 32] |= bit;
+        } else {
+            s->pe[i].pending[irq / 32] &= ~bit;
+        }
+    }
+}
+
+static void rh850_intc_set_irq(void *opaque, int n, int level)
+{
+    RH850INTCState *s = opaque;
+    uint32_t *plevel;
+    uint32_t bit;
+    int pe, irq;
+
+    if (n < s->num_irq) {
+        pe = 0;
+        irq = n;
+    } else {
+        pe = 1 + (n - s->num_irq) / RH850_INTC1_NUM_IRQ;
+        irq = (n - s->num_irq) % RH850_INTC1_NUM_IRQ;
+    }
+    bit = 1u << (irq & 31);
+    plevel = irq < RH850_INTC1_NUM_IRQ ? &s->pe[pe].level1
+                                       : &s->level[irq / 32];
+
+    if (level && !(*plevel & bit)) {
+        *plevel |= bit;
+        *rh850_intc_eic(s, pe, irq) |= R_EIC_EIRF_MASK;
+        rh850_intc_sync_pending(s, pe, irq);
+        rh850_intc_update(s);
+    } else if (!level) {
+        *plevel &= ~bit;
+    }
+}
+
+int rh850_intc_get_pending_irq(void *opaque, uint32_t prio_mask,
+                               int *pprio, bool *ptable_ref)
+{
+    RH850INTCPEState *pe = opaque;
+    uint32_t ready = pe->prio_pending & prio_mask;
+    int prio, irq;
+
+    if (!ready) {
+        return -1;
+    }
+
+    prio = ctz32(ready);
+    irq = pe->prio_irq[prio];
+    if (pprio) {
+        *pprio = prio;
+    }
+    if (ptable_ref) {
+        *ptable_ref = FIELD_EX16(*rh850_intc_eic(pe->intc, pe->pe, irq),
+                                 EIC, EITB);
+    }
+    return irq;
+}
+
+void rh850_intc_acknowledge_irq(void *opaque, int irq)
+{
+    RH850INTCPEState *pe = opaque;
+    RH850INTCState *s = pe->intc;
+
+    *rh850_intc_eic(s, pe->pe, irq) &= ~R_EIC_EIRF_MASK;
+    rh850_intc_sync_pending(s, pe->pe, irq);
+    rh850_intc_update(s);
+}
+
+static uint32_t rh850_intc_imr_read(RH850INTCState *s, int pe, int m)
+{
+    uint32_t val = 0;
+    int i;
+
+    for (i = 0; i < 32 && m * 32 + i < s->num_irq; i++) {
+        val |= FIELD_EX16(*rh850_intc_eic(s, pe, m * 32 + i), EIC, EIMK) << i;
+    }
+    return val;
+}
+
+static void rh850_intc_imr_write(RH850INTCState *s, int pe, int m,
+                                 uint32_t val, uint32_t mask)
+{
+    int i;
+
+    for (i = 0; i < 32 && m * 32 + i < s->num_irq; i++) {
+        int irq = m * 32 + i;
+
+        if (mask & (1u << i)) {
+            uint16_t *eic = rh850_intc_eic(s, pe, irq);
+
+            *eic = FIELD_DP16(*eic, EIC, EIMK, (val >> i) & 1);
+            rh850_intc_sync_pending(s, pe, irq);
+        }
+    }
+    rh850_intc_update(s);
+}
+
+static uint64_t rh850_intc_eic_read(RH850INTCState *s, int pe, int irq,
+                                    hwaddr addr, unsigned size)
+{
+    if (size > 2) {
+        qemu_log_mask(LOG_GUEST_ERROR, "rh850_intc: Invalid read size %u "
+                      "from EIC%d\n", size, irq);
+        return 0;
+    }
+    if (irq >= s->num_irq) {
+        return 0;
+    }
+    return extract32(*rh850_intc_eic(s, pe, irq), (addr & 1) * 8, size * 8);
+}
+
+static void rh850_intc_eic_write(RH850INTCState *s, int pe, int irq,
+                                 hwaddr addr, uint64_t val, unsigned size)
+{
+    int shift = (addr & 1) * 8;
+    uint16_t mask = MAKE_64BIT_MASK(shift, size * 8) & EIC_WRITABLE;
+    uint16_t *eic;
+
+    if (size > 2) {
+        qemu_log_mask(LOG_GUEST_ERROR, "rh850_intc: Invalid write size %u "
+                      "to EIC%d\n", size, irq);
+        return;
+    }
+    if (irq >= s->num_irq) {
+        return;
+    }
+    eic = rh850_intc_eic(s, pe, irq);
+    *eic = (*eic & ~mask) | ((val << shift) & mask);
+    rh850_intc_sync_pending(s, pe, irq);
+    rh850_intc_update(s);
+}
+
+static uint64_t rh850_intc1_read(void *opaque, hwaddr addr, unsigned size)
+{
+    RH850INTCPEState *pe = opaque;
+    RH850INTCState *s = pe->intc;
+
+    switch (addr) {
+    case A_EIC ... A_EIC + 2 * RH850_INTC1_NUM_IRQ - 1:
+        return rh850_intc_eic_read(s, pe->pe, addr / 2, addr, size);
+    case A_IMR0 ... A_IMR0 + 3:
+        return extract32(rh850_intc_imr_read(s, pe->pe, 0),
+                         (addr & 3) * 8, size * 8);
+    default:
+        qemu_log_mask(LOG_UNIMP, "rh850_intc: INTC1 register 0x%"
+                      HWADDR_PRIX " not implemented\n", addr);
+        return 0;
+    }
+}
+
+static void rh850_intc1_write(void *opaque, hwaddr addr, uint64_t val,
+                              unsigned size)
+{
+    RH850INTCPEState *pe = opaque;
+    RH850INTCState *s = pe->intc;
+
+    switch (addr) {
+    case A_EIC ... A_EIC + 2 * RH850_INTC1_NUM_IRQ - 1:
+        rh850_intc_eic_write(s, pe->pe, addr / 2, addr, val, size);
+        break;
+    case A_IMR0 ... A_IMR0 + 3:
+        rh850_intc_imr_write(s, pe->pe, 0, val << ((addr & 3) * 8),
+                             MAKE_64BIT_MASK((addr & 3) * 8, size * 8));
+        break;
+    default:
+        qemu_log_mask(LOG_UNIMP, "rh850_intc: INTC1 register 0x%"
+                      HWADDR_PRIX " not implemented\n", addr);
+        break;
+    }
+}
+
+static uint64_t rh850_intc2_read(void *opaque, hwaddr addr, unsigned size)
+{
+    RH850INTCState *s = opaque;
+    int irq;
+
+    switch (addr) {
+    case 2 * RH850_INTC1_NUM_IRQ ... A_IMR - 1:
+        return rh850_intc_eic_read(s, 0, addr / 2, addr, size);
+    case A_IMR + 4 ... A_IMR + RH850_INTC_MAX_IRQ / 8 - 1:
+        return extract32(rh850_intc_imr_read(s, 0, (addr - A_IMR) / 4),
+                         (addr & 3) * 8, size * 8);
+    case A_EIBD + 4 * RH850_INTC1_NUM_IRQ ... INTC2_SIZE - 1:
+        irq = (addr - A_EIBD) / 4;
+        if (irq >= s->num_irq) {
+            return 0;
+        }
+        return extract32(s->eibd[irq], (addr & 3) * 8, size * 8);
+    default:
+        qemu_log_mask(LOG_UNIMP, "rh850_intc: INTC2 register 0x%"
+                      HWADDR_PRIX " not implemented\n", addr);
+        return 0;
+    }
+}
+
+static void rh850_intc2_write(void *opaque, hwaddr addr, uint64_t val,
+                              unsigned size)
+{
+    RH850INTCState *s = opaque;
+    int irq;
+
+    switch (addr) {
+    case 2 * RH850_INTC1_NUM_IRQ ... A_IMR - 1:
+        rh850_intc_eic_write(s, 0, addr / 2, addr, val, size);
+        break;
+    case A_IMR + 4 ... A_IMR + RH850_INTC_MAX_IRQ / 8 - 1:
+        rh850_intc_imr_write(s, 0, (addr - A_IMR) / 4,
+                             val << ((addr & 3) * 8),
+                             MAKE_64BIT_MASK((addr & 3) * 8, size * 8));
+        break;
+    case A_EIBD + 4 * RH850_INTC1_NUM_IRQ ... INTC2_SIZE - 1:
+        irq = (addr - A_EIBD) / 4;
+        if (irq >= s->num_irq) {
+            break;
+        }
+        s->eibd[irq] = deposit32(s->eibd[irq], (addr & 3) * 8, size * 8, val) &
+                       R_EIBD_PEID_MASK;
+        rh850_intc_sync_pending(s, 0, irq);
+        rh850_intc_update(s);
+        break;
+    default:
+        qemu_log_mask(LOG_UNIMP, "rh850_intc: INTC2 register 0x%"
+                      HWADDR_PRIX " not implemented\n", addr);
+        break;
+    }
+}
+
+static const MemoryRegionOps rh850_intc1_ops = {
+    .read = rh850_intc1_read,
+    .write = rh850_intc1_write,
+    .endianness = DEVICE_LITTLE_ENDIAN,
+    .valid = {
+        .min_access_size = 1,
+        .max_access_size = 4,
+    },
+};
+
+static const MemoryRegionOps rh850_intc2_ops = {
+    .read = rh850_intc2_read,
+    .write = rh850_intc2_write,
+    .endianness = DEVICE_LITTLE_ENDIAN,
+    .valid = {
+        .min_access_size = 1,
+        .max_access_size = 4,
+    },
+};
+
+static void rh850_intc_reset(DeviceState *dev)
+{
+    RH850INTCState *s = RH850_INTC(dev);
+    int i, j;
+
+    for (i = 0; i < RH850_INTC_MAX_IRQ; i++) {
+        s->eic[i] = EIC_RESET_VALUE;
+        s->eibd[i] = EIBD_RESET_VALUE;
+    }
+    memset(s->level, 0, sizeof(s->level));
+    for (i = 0; i < RH850_INTC_MAX_PE; i++) {
+        RH850INTCPEState *pe = &s->pe[i];
+
+        for (j = 0; j < RH850_INTC1_NUM_IRQ; j++) {
+            pe->eic1[j] = EIC_RESET_VALUE;
+        }
+        pe->level1 = 0;
+        memset(pe->pending, 0, sizeof(pe->pending));
+    }
+    rh850_intc_update(s);
+}
+
+static void rh850_intc_realize(DeviceState *dev, Error **errp)
+{
+    SysBusDevice *d = SYS_BUS_DEVICE(dev);
+    RH850INTCState *s = RH850_INTC(dev);
+    int i;
+
+    if (s->num_irq > RH850_INTC_MAX_IRQ) {
+        error_setg(errp, "num-irq %u exceeds INTC maximum %d",
+                   s->num_irq, RH850_INTC_MAX_IRQ);
+        return;
+    }
+    if (s->num_pe < 1 || s->num_pe > RH850_INTC_MAX_PE) {
+        error_setg(errp, "num-pe %u must be between 1 and %d",
+                   s->num_pe, RH850_INTC_MAX_PE);
+        return;
+    }
+
+    for (i = 1; i < s->num_pe; i++) {
+        RH850INTCPEState *pe = &s->pe[i];
+
+        memory_region_init_io(&pe->intc1_iomem, OBJECT(dev),
+                              &rh850_intc1_ops, pe, "rh850-intc1", INTC1_SIZE);
+        sysbus_init_mmio(d, &pe->intc1_iomem);
+        sysbus_init_irq(d, &pe->irq);
+    }
+
+    qdev_init_gpio_in(dev, rh850_intc_set_irq,
+                      s->num_irq + (s->num_pe - 1) * RH850_INTC1_NUM_IRQ);
+}
+
+static void rh850_intc_init(Object *obj)
+{
+    SysBusDevice *d = SYS_BUS_DEVICE(obj);
+    RH850INTCState *s = RH850_INTC(obj);
+    int i;
+
+    for (i = 0; i < RH850_INTC_MAX_PE; i++) {
+        s->pe[i].intc = s;
+        s->pe[i].pe = i;
+    }
+
+    memory_region_init_io(&s->pe[0].intc1_iomem, obj, &rh850_intc1_ops,
+                          &s->pe[0], "rh850-intc1", INTC1_SIZE);
+    sysbus_init_mmio(d, &s->pe[0].intc1_iomem);
+    memory_region_init_io(&s->intc2_iomem, obj, &rh850_intc2_ops, s,
+                          "rh850-intc2", INTC2_SIZE);
+    sysbus_init_mmio(d, &s->intc2_iomem);
+    sysbus_init_irq(d, &s->pe[0].irq);
+}
+
+static int rh850_intc_post_load(void *opaque, int version_id)
+{
+    RH850INTCState *s = opaque;
+    int i, j;
+
+    for (i = 0; i < s->num_pe; i++) {
+        for (j = 0; j < RH850_INTC1_NUM_IRQ; j++) {
+            rh850_intc_sync_pending(s, i, j);
+        }
+    }
+    for (j = RH850_INTC1_NUM_IRQ; j < s->num_irq; j++) {
+        rh850_intc_sync_pending(s, 0, j);
+    }
+    rh850_intc_update(s);
+    return 0;
+}
+
+static const VMStateDescription vmstate_rh850_intc_pe = {
+    .name = "rh850-intc-pe",
+    .version_id = 1,
+    .minimum_version_id = 1,
+    .fields = (VMStateField[]) {
+        VMSTATE_UINT16_ARRAY(eic1, RH850INTCPEState, RH850_INTC1_NUM_IRQ),
+        VMSTATE_UINT32(level1, RH850INTCPEState),
+        VMSTATE_END_OF_LIST()
+    }
+};
+
+static const VMStateDescription vmstate_rh850_intc = {
+    .name = "rh850-intc",
+    .version_id = 2,
+    .minimum_version_id = 2,
+    .post_load = rh850_intc_post_load,
+    .fields = (VMStateField[]) {
+        VMSTATE_UINT16_ARRAY(eic, RH850INTCState, RH850_INTC_MAX_IRQ),
+        VMSTATE_UINT32_ARRAY(eibd, RH850INTCState, RH850_INTC_MAX_IRQ),
+        VMSTATE_UINT32_ARRAY(level, RH850INTCState, RH850_INTC_MAX_IRQ / 32),
+        VMSTATE_STRUCT_ARRAY(pe, RH850INTCState, RH850_INTC_MAX_PE, 1,
+                             vmstate_rh850_intc_pe, RH850INTCPEState),
+        VMSTATE_END_OF_LIST()
+    }
+};
+
+static Property rh850_intc_properties[] = {
+    DEFINE_PROP_UINT32("num-irq", RH850INTCState, num_irq,
+                       RH850_INTC_MAX_IRQ),
+    DEFINE_PROP_UINT32("num-pe", RH850INTCState, num_pe, 1),
+    DEFINE_PROP_END_OF_LIST(),
+};
+static void rh850_intc_class_init(ObjectClass *klass, void *data)
+{
+    DeviceClass *dc = DEVICE_CLASS(klass);
+
+    dc->realize = rh850_intc_realize;
+    dc->reset = rh850_intc_reset;
+    dc->vmsd = &vmstate_rh850_intc;
+    device_class_set_props(dc, rh850_intc_properties);
+}
+
+static const TypeInfo rh850_intc_info = {
+    .name = TYPE_RH850_INTC,
+    .parent = TYPE_SYS_BUS_DEVICE,
+    .instance_size = sizeof(RH850INTCState),
+    .instance_init = rh850_intc_init,
+    .class_init = rh850_intc_class_init,
+};
+
+static void rh850_intc_register_types(void)
+{
+    type_register_static(&rh850_intc_info);
+}
+
+type_init(rh850_intc_register_types)
@@ -0,0 +1,187 @@
+/*
+ * iSYSTEM profiler port
+ *
+ * Records the events of isystem_profile_write() with timestamps, so that
+ * profiler timelines can be obtained at full speed, without a debugger.
+ *
+ * Copyright (c) 2021 iSYSTEM Labs d.o.o.
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/bswap.h"
+#include "qemu/error-report.h"
+#include "qemu/module.h"
+#include "qemu/timer.h"
+#include "qapi/error.h"
+#include "hw/qdev-properties.h"
+#include "hw/misc/isystem_profiler.h"
+#include "migration/vmstate.h"
+#include "sysemu/sysemu.h"
+#include "trace.h"
+
+#define PROFILER_MAGIC          "IPRF"
+#define PROFILER_VERSION        1
+#define PROFILER_HEADER_SIZE    24
+
+static uint64_t profiler_read(void *opaque, hwaddr offset, unsigned size)
+{
+    ISystemProfilerState *s = opaque;
+
+    return s->port;
+}
+
+static void profiler_write(void *opaque, hwaddr offset, uint64_t val,
+                           unsigned size)
+{
+    ISystemProfilerState *s = opaque;
+    int64_t now;
+
+    s->port = val;
+    if ((val & s->marker) != s->marker) {
+        return;
+    }
+
+    now = qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL);
+    s->entries[s->count % s->num_entries] = (uint64_t)now << 16 |
+                                            (val & 0xffff);
+    s->count++;
+    trace_isystem_profiler_event(val, now);
+}
+
+static const MemoryRegionOps profiler_ops = {
+    .read = profiler_read,
+    .write = profiler_write,
+    .endianness = DEVICE_LITTLE_ENDIAN,
+    .impl = {
+        .min_access_size = 4,
+        .max_access_size = 4,
+    },
+    .valid = {
+        .min_access_size = 1,
+        .max_access_size = 4,
+    },
+};
+
+static bool profiler_save(ISystemProfilerState *s, Error **errp)
+{
+    uint32_t n = MIN(s->count, s->num_entries);
+    uint64_t first = s->count - n;
+    size_t size = PROFILER_HEADER_SIZE + n * sizeof(uint64_t);
+    g_autofree uint8_t *buf = g_malloc(size);
+    g_autoptr(GError) gerr = NULL;
+    uint32_t i;
+
+    memcpy(buf, PROFILER_MAGIC, 4);
+    stl_le_p(buf + 4, PROFILER_VERSION);
+    stl_le_p(buf + 8, s->marker);
+    stl_le_p(buf + 12, n);
+    stq_le_p(buf + 16, first);
+    for (i = 0; i < n; i++) {
+        stq_le_p(buf + PROFILER_HEADER_SIZE + i * sizeof(uint64_t),
+                 s->entries[(first + i) % s->num_entries]);
+    }
+
+    if (!g_file_set_contents(s->file, (const char *)buf, size, &gerr)) {
+        error_setg(errp, "Cannot write profiler file: %s", gerr->message);
+        return false;
+    }
+    return true;
+}
+
+static void profiler_exit(Notifier *n, void *data)
+{
+    ISystemProfilerState *s = container_of(n, ISystemProfilerState,
+                                           exit_notifier);
+    Error *err = NULL;
+
+    if (!profiler_save(s, &err)) {
+        warn_report_err(err);
+    }
+}
+
+static void profiler_reset(DeviceState *dev)
+{
+    ISystemProfilerState *s = ISYSTEM_PROFILER(dev);
+
+    /* Events are kept over resets, the timeline covers the whole run */
+    s->port = 0;
+}
+
+static void profiler_init(Object *obj)
+{
+    SysBusDevice *sbd = SYS_BUS_DEVICE(obj);
+    ISystemProfilerState *s = ISYSTEM_PROFILER(obj);
+
+    memory_region_init_io(&s->iomem, obj, &profiler_ops, s,
+                          "isystem-profiler", 4);
+    sysbus_init_mmio(sbd, &s->iomem);
+}
+
+static void profiler_realize(DeviceState *dev, Error **errp)
+{
+    ISystemProfilerState *s = ISYSTEM_PROFILER(dev);
+
+    if (!s->file) {
+        error_setg(errp, "isystem-profiler: file property must be set");
+        return;
+    }
+    if (s->marker == 0) {
+        error_setg(errp, "isystem-profiler: marker must not be 0");
+        return;
+    }
+    if (s->num_entries == 0) {
+        error_setg(errp, "isystem-profiler: entries must not be 0");
+        return;
+    }
+
+    s->entries = g_new(uint64_t, s->num_entries);
+    s->exit_notifier.notify = profiler_exit;
+    qemu_add_exit_notifier(&s->exit_notifier);
+}
+
+/* Recorded events are output of the run, not state of the machine */
+static const VMStateDescription vmstate_profiler = {
+    .name = "isystem-profiler",
+    .version_id = 1,
+    .minimum_version_id = 1,
+    .fields = (VMStateField[]) {
+        VMSTATE_UINT32(port, ISystemProfilerState),
+        VMSTATE_END_OF_LIST()
+    }
+};
+
+static Property profiler_properties[] = {
+    DEFINE_PROP_STRING("file", ISystemProfilerState, file),
+    DEFINE_PROP_UINT32("marker", ISystemProfilerState, marker, 0x8000),
+    DEFINE_PROP_UINT32("entries", ISystemProfilerState, num_entries,
+                       1 << 20),
+    DEFINE_PROP_END_OF_LIST(),
+};
+
+static void profiler_class_init(ObjectClass *klass, void *data)
+{
+    DeviceClass *dc = DEVICE_CLASS(klass);
+
+    dc->realize = profiler_realize;
+    dc->reset = profiler_reset;
+    dc->vmsd = &vmstate_profiler;
+    device_class_set_props(dc, profiler_properties);
+}
+
+static const TypeInfo profiler_info = {
+    .name = TYPE_ISYSTEM_PROFILER,
+    .parent = TYPE_SYS_BUS_DEVICE,
+    .instance_size = sizeof(ISystemProfilerState),
+    .instance_init = profiler_init,
+    .class_init = profiler_class_init,
+};
+
+static void profiler_register_types(void)
+{
+    type_register_static(&profiler_info);
+}
+
+type_init(profiler_register_types)
@@ -67,6 +67,8 @@ static void unimp_realize(DeviceState *dev, Error **errp)
 
     memory_region_init_io(&s->iomem, OBJECT(s), &unimp_ops, s,
                           s->name, s->size);
+    /* Accesses only log, so don't take the BQL for firmware polling them */
+    memory_region_clear_global_locking(&s->iomem);
     sysbus_init_mmio(SYS_BUS_DEVICE(s), &s->iomem);
 }
 
@@ -0,0 +1,385 @@
+/*
+ * STM32F2xx/STM32F4xx flash interface
+ *
+ * Reference Manuals: RM0033 (STM32F205xx), section 2.3 Embedded Flash memory
+ *                    RM0090 (STM32F405xx), section 3 Embedded Flash memory
+ *
+ * Copyright (c) 2021 iSYSTEM Labs d.o.o.
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/units.h"
+#include "qapi/error.h"
+#include "qemu/log.h"
+#include "qemu/module.h"
+#include "hw/irq.h"
+#include "hw/registerfields.h"
+#include "hw/qdev-properties.h"
+#include "hw/nvram/stm32f2xx_flash.h"
+#include "migration/vmstate.h"
+
+REG32(ACR, 0x00)
+    FIELD(ACR, LATENCY, 0, 4)
+#define ACR_MASK 0x00001f0f
+REG32(KEYR, 0x04)
+REG32(OPTKEYR, 0x08)
+REG32(SR, 0x0c)
+    FIELD(SR, EOP, 0, 1)
+    FIELD(SR, OPERR, 1, 1)
+    FIELD(SR, WRPERR, 4, 1)
+    FIELD(SR, PGAERR, 5, 1)
+    FIELD(SR, PGPERR, 6, 1)
+    FIELD(SR, PGSERR, 7, 1)
+    FIELD(SR, BSY, 16, 1)
+#define SR_W1C_MASK 0x000000f3
+REG32(CR, 0x10)
+    FIELD(CR, PG, 0, 1)
+    FIELD(CR, SER, 1, 1)
+    FIELD(CR, MER, 2, 1)
+    FIELD(CR, SNB, 3, 4)
+    FIELD(CR, PSIZE, 8, 2)
+    FIELD(CR, STRT, 16, 1)
+    FIELD(CR, EOPIE, 24, 1)
+    FIELD(CR, ERRIE, 25, 1)
+    FIELD(CR, LOCK, 31, 1)
+#define CR_MASK 0x030103ff
+REG32(OPTCR, 0x14)
+    FIELD(OPTCR, OPTLOCK, 0, 1)
+    FIELD(OPTCR, OPTSTRT, 1, 1)
+#define OPTCR_MASK 0x0fffffec
+#define OPTCR_RESET 0x0fffaaed
+
+#define FLASH_KEY1 0x45670123
+#define FLASH_KEY2 0xcdef89ab
+#define FLASH_OPTKEY1 0x08192a3b
+#define FLASH_OPTKEY2 0x4c5d6e7f
+
+/* Progress of an unlock sequence through KEYR or OPTKEYR */
+enum {
+    KEY_NONE,
+    KEY_FIRST,
+    KEY_BLOCKED,    /* a wrong key locks the register until reset */
+};
+
+/*
+ * Sectors 0-3 are 16 KiB, sector 4 is 64 KiB and the rest are 128 KiB.
+ * Returns false if sector n is not within flash.
+ */
+static bool stm32f2xx_flash_sector(STM32F2XXFlashState *s, unsigned n,
+                                   uint32_t *offset, uint32_t *size)
+{
+    if (n < 4) {
+        *offset = n * 16 * KiB;
+        *size = 16 * KiB;
+    } else if (n == 4) {
+        *offset = 64 * KiB;
+        *size = 64 * KiB;
+    } else {
+        *offset = (n - 4) * 128 * KiB;
+        *size = 128 * KiB;
+    }
+    return *offset + *size <= s->flash_size;
+}
+
+static void stm32f2xx_flash_update_irq(STM32F2XXFlashState *s)
+{
+    bool level = (FIELD_EX32(s->sr, SR, EOP) && FIELD_EX32(s->cr, CR, EOPIE)) ||
+                 (FIELD_EX32(s->sr, SR, OPERR) && FIELD_EX32(s->cr, CR, ERRIE));
+
+    qemu_set_irq(s->irq, level);
+}
+
+/* EOP and OPERR are only set if their interrupts are enabled */
+static void stm32f2xx_flash_done(STM32F2XXFlashState *s, uint32_t error)
+{
+    if (error) {
+        s->sr |= error;
+        if (FIELD_EX32(s->cr, CR, ERRIE)) {
+            s->sr = FIELD_DP32(s->sr, SR, OPERR, 1);
+        }
+    } else if (FIELD_EX32(s->cr, CR, EOPIE)) {
+        s->sr = FIELD_DP32(s->sr, SR, EOP, 1);
+    }
+    stm32f2xx_flash_update_irq(s);
+}
+
+static void stm32f2xx_flash_erase(STM32F2XXFlashState *s)
+{
+    uint32_t offset, size;
+
+    if (FIELD_EX32(s->cr, CR, MER)) {
+        offset = 0;
+        size = s->flash_size;
+    } else if (FIELD_EX32(s->cr, CR, SER)) {
+        if (!stm32f2xx_flash_sector(s, FIELD_EX32(s->cr, CR, SNB),
+                                    &offset, &size)) {
+            qemu_log_mask(LOG_GUEST_ERROR,
+                          "%s: erase of sector %u beyond flash\n", __func__,
+                          (unsigned)FIELD_EX32(s->cr, CR, SNB));
+            stm32f2xx_flash_done(s, R_SR_PGSERR_MASK);
+            return;
+        }
+    } else {
+        return;
+    }
+
+    /* Only the erased pages have their translated code invalidated */
+    memset(s->storage + offset, 0xff, size);
+    memory_region_flush_rom_device(&s->flash, offset, size);
+    stm32f2xx_flash_done(s, 0);
+}
+
+static uint64_t stm32f2xx_flash_read(void *opaque, hwaddr offset,
+                                     unsigned size)
+{
+    STM32F2XXFlashState *s = opaque;
+
+    switch (offset) {
+    case A_ACR:
+        return s->acr;
+    case A_KEYR:
+    case A_OPTKEYR:
+        return 0;
+    case A_SR:
+        /* Operations complete immediately, so BSY is never set */
+        return s->sr;
+    case A_CR:
+        return s->cr;
+    case A_OPTCR:
+        return s->optcr;
+    default:
+        qemu_log_mask(LOG_GUEST_ERROR,
+                      "%s: bad offset 0x%" HWADDR_PRIx "\n", __func__, offset);
+        return 0;
+    }
+}
+
+/* Returns true once the second key of an unlock sequence is written */
+static bool stm32f2xx_flash_unlock(uint8_t *state, uint32_t value,
+                                   uint32_t key1, uint32_t key2)
+{
+    if (*state == KEY_NONE && value == key1) {
+        *state = KEY_FIRST;
+    } else if (*state == KEY_FIRST && value == key2) {
+        *state = KEY_NONE;
+        return true;
+    } else {
+        qemu_log_mask(LOG_GUEST_ERROR,
+                      "stm32f2xx_flash: wrong key 0x%" PRIx32
+                      ", locked until reset\n", value);
+        *state = KEY_BLOCKED;
+    }
+    return false;
+}
+
+static void stm32f2xx_flash_write(void *opaque, hwaddr offset,
+                                  uint64_t val64, unsigned size)
+{
+    STM32F2XXFlashState *s = opaque;
+    uint32_t value = val64;
+
+    switch (offset) {
+    case A_ACR:
+        /* Wait states are kept for the guest, accesses are not slowed down */
+        s->acr = value & ACR_MASK;
+        break;
+    case A_KEYR:
+        if (FIELD_EX32(s->cr, CR, LOCK) &&
+            stm32f2xx_flash_unlock(&s->key_state, value,
+                                   FLASH_KEY1, FLASH_KEY2)) {
+            s->cr = FIELD_DP32(s->cr, CR, LOCK, 0);
+        }
+        break;
+    case A_OPTKEYR:
+        if (FIELD_EX32(s->optcr, OPTCR, OPTLOCK) &&
+            stm32f2xx_flash_unlock(&s->optkey_state, value,
+                                   FLASH_OPTKEY1, FLASH_OPTKEY2)) {
+            s->optcr = FIELD_DP32(s->optcr, OPTCR, OPTLOCK, 0);
+        }
+        break;
+    case A_SR:
+        s->sr &= ~(value & SR_W1C_MASK);
+        stm32f2xx_flash_update_irq(s);
+        break;
+    case A_CR:
+        if (FIELD_EX32(s->cr, CR, LOCK)) {
+            qemu_log_mask(LOG_GUEST_ERROR,
+                          "%s: FLASH_CR written while locked\n", __func__);
+            break;
+        }
+        s->cr = value & CR_MASK;
+        if (FIELD_EX32(value, CR, STRT)) {
+            stm32f2xx_flash_erase(s);
+            s->cr = FIELD_DP32(s->cr, CR, STRT, 0);
+        }
+        if (FIELD_EX32(value, CR, LOCK)) {
+            s->cr = FIELD_DP32(s->cr, CR, LOCK, 1);
+        }
+        stm32f2xx_flash_update_irq(s);
+        break;
+    case A_OPTCR:
+        if (FIELD_EX32(s->optcr, OPTCR, OPTLOCK)) {
+            qemu_log_mask(LOG_GUEST_ERROR,
+                          "%s: FLASH_OPTCR written while locked\n", __func__);
+            break;
+        }
+        /* Option bytes take effect at once, OPTSTRT completes immediately */
+        s->optcr = value & (OPTCR_MASK | R_OPTCR_OPTLOCK_MASK);
+        if (FIELD_EX32(value, OPTCR, OPTSTRT)) {
+            stm32f2xx_flash_done(s, 0);
+        }
+        break;
+    default:
+        qemu_log_mask(LOG_GUEST_ERROR,
+                      "%s: bad offset 0x%" HWADDR_PRIx "\n", __func__, offset);
+    }
+}
+
+static const MemoryRegionOps stm32f2xx_flash_ops = {
+    .read = stm32f2xx_flash_read,
+    .write = stm32f2xx_flash_write,
+    .impl.min_access_size = 4,
+    .impl.max_access_size = 4,
+    .endianness = DEVICE_LITTLE_ENDIAN,
+};
+
+static uint64_t stm32f2xx_flash_mem_read(void *opaque, hwaddr offset,
+                                         unsigned size)
+{
+    /*
+     * This is a rom_device MemoryRegion which is always in
+     * romd_mode (we never put it in MMIO mode), so reads always
+     * go directly to RAM and never come here.
+     */
+    g_assert_not_reached();
+}
+
+static void stm32f2xx_flash_mem_write(void *opaque, hwaddr offset,
+                                      uint64_t value, unsigned size)
+{
+    STM32F2XXFlashState *s = opaque;
+    unsigned psize = FIELD_EX32(s->cr, CR, PSIZE);
+    uint32_t oldval;
+
+    if (FIELD_EX32(s->cr, CR, LOCK) || !FIELD_EX32(s->cr, CR, PG)) {
+        qemu_log_mask(LOG_GUEST_ERROR,
+                      "%s: flash write 0x%" HWADDR_PRIx
+                      " while flash not writable\n", __func__, offset);
+        stm32f2xx_flash_done(s, R_SR_PGSERR_MASK);
+        return;
+    }
+    /* x64 parallelism needs an external Vpp, program it as words */
+    if (size != 1 << MIN(psize, 2)) {
+        stm32f2xx_flash_done(s, R_SR_PGPERR_MASK);
+        return;
+    }
+
+    assert(offset + size <= s->flash_size);
+
+    /* NOR Flash only allows bits to be flipped from 1's to 0's on write */
+    oldval = ldn_le_p(s->storage + offset, size);
+    stn_le_p(s->storage + offset, size, oldval & value);
+
+    memory_region_flush_rom_device(&s->flash, offset, size);
+    stm32f2xx_flash_done(s, 0);
+}
+
+static const MemoryRegionOps stm32f2xx_flash_mem_ops = {
+    .read = stm32f2xx_flash_mem_read,
+    .write = stm32f2xx_flash_mem_write,
+    .valid.min_access_size = 1,
+    .valid.max_access_size = 4,
+    .endianness = DEVICE_LITTLE_ENDIAN,
+};
+
+static void stm32f2xx_flash_init(Object *obj)
+{
+    STM32F2XXFlashState *s = STM32F2XX_FLASH(obj);
+    SysBusDevice *sbd = SYS_BUS_DEVICE(obj);
+
+    memory_region_init_io(&s->mmio, obj, &stm32f2xx_flash_ops, s,
+                          "stm32f2xx_flash", STM32F2XX_FLASH_REGS_SIZE);
+    sysbus_init_mmio(sbd, &s->mmio);
+    sysbus_init_irq(sbd, &s->irq);
+}
+
+static void stm32f2xx_flash_realize(DeviceState *dev, Error **errp)
+{
+    STM32F2XXFlashState *s = STM32F2XX_FLASH(dev);
+    Error *err = NULL;
+
+    memory_region_init_rom_device(&s->flash, OBJECT(dev),
+                                  &stm32f2xx_flash_mem_ops, s,
+                                  "stm32f2xx_flash.flash", s->flash_size,
+                                  &err);
+    if (err) {
+        error_propagate(errp, err);
+        return;
+    }
+
+    s->storage = memory_region_get_ram_ptr(&s->flash);
+    memset(s->storage, 0xff, s->flash_size);
+    sysbus_init_mmio(SYS_BUS_DEVICE(dev), &s->flash);
+}
+
+static void stm32f2xx_flash_reset(DeviceState *dev)
+{
+    STM32F2XXFlashState *s = STM32F2XX_FLASH(dev);
+
+    s->acr = 0;
+    s->sr = 0;
+    s->cr = R_CR_LOCK_MASK;
+    s->optcr = OPTCR_RESET;
+    s->key_state = KEY_NONE;
+    s->optkey_state = KEY_NONE;
+    stm32f2xx_flash_update_irq(s);
+}
+
+static Property stm32f2xx_flash_properties[] = {
+    DEFINE_PROP_UINT32("flash-size", STM32F2XXFlashState, flash_size,
+                       1 * MiB),
+    DEFINE_PROP_END_OF_LIST(),
+};
+
+static const VMStateDescription vmstate_stm32f2xx_flash = {
+    .name = TYPE_STM32F2XX_FLASH,
+    .version_id = 1,
+    .minimum_version_id = 1,
+    .fields = (VMStateField[]) {
+        VMSTATE_UINT32(acr, STM32F2XXFlashState),
+        VMSTATE_UINT32(sr, STM32F2XXFlashState),
+        VMSTATE_UINT32(cr, STM32F2XXFlashState),
+        VMSTATE_UINT32(optcr, STM32F2XXFlashState),
+        VMSTATE_UINT8(key_state, STM32F2XXFlashState),
+        VMSTATE_UINT8(optkey_state, STM32F2XXFlashState),
+        VMSTATE_END_OF_LIST()
+    }
+};
+
+static void stm32f2xx_flash_class_init(ObjectClass *klass, void *data)
+{
+    DeviceClass *dc = DEVICE_CLASS(klass);
+
+    device_class_set_props(dc, stm32f2xx_flash_properties);
+    dc->vmsd = &vmstate_stm32f2xx_flash;
+    dc->realize = stm32f2xx_flash_realize;
+    dc->reset = stm32f2xx_flash_reset;
+}
+
+static const TypeInfo stm32f2xx_flash_info = {
+    .name          = TYPE_STM32F2XX_FLASH,
+    .parent        = TYPE_SYS_BUS_DEVICE,
+    .instance_size = sizeof(STM32F2XXFlashState),
+    .instance_init = stm32f2xx_flash_init,
+    .class_init    = stm32f2xx_flash_class_init,
+};
+
+static void stm32f2xx_flash_register_types(void)
+{
+    type_register_static(&stm32f2xx_flash_info);
+}
+
+type_init(stm32f2xx_flash_register_types)
@@ -20,19 +20,38 @@
 #include "qemu/error-report.h"
 #include "exec/address-spaces.h"
 
+/* INTC1 and INTC2 addresses of RH850/F1x devices */
+#define RH850_INTC1_BASE 0xfffeea00
+#define RH850_INTC2_BASE 0xffffb000
+
+/* OSTM0 of RH850/F1L, counting CPUCLK_L and requesting INTOSTM0 */
+#define RH850_OSTM0_BASE 0xffd70000
+#define RH850_OSTM0_IRQ  84
+#define RH850_OSTM0_FREQ 40000000
+
+/*
+ * Local RAM of multicore RH850/F1KM devices. Each PE sees its own local
+ * RAM in the self area, which ends at the same address on all PEs, and
+ * local RAM of all PEs at their global addresses.
+ */
+#define RH850_LRAM_SELF_END             0xfee00000
+#define RH850_LRAM_GLOBAL_END(pe)       (0xfec00000 - (pe) * 0x200000)
+
 static void rh850_soc_instance_init(Object *obj)
 {
-    // RH850_SOC_State *s = RH850_SOC(obj);
+    RH850_SOC_State *s = RH850_SOC(obj);
 
     /* Can't init the cpu here, we don't yet know which model to use */
 
     // Is this needed? MK
     // memory_region_init(&s->container, obj, "rh850-container", UINT32_MAX);
 
-//     object_initialize(&s->nvic, sizeof(s->nvic), TYPE_NVIC);
-//    qdev_set_parent_bus(DEVICE(&s->nvic), sysbus_get_default());
-//    object_property_add_alias(obj, "num-irq",
-//                              OBJECT(&s->nvic), "num-irq", &error_abort);
+    object_initialize_child(obj, "intc", &s->intc, TYPE_RH850_INTC);
+    object_property_add_alias(obj, "num-irq", OBJECT(&s->intc), "num-irq");
+
+    object_initialize_child(obj, "ostm0", &s->ostm, TYPE_RH850_OSTM);
+    qdev_prop_set_uint64(DEVICE(&s->ostm), "clock-frequency",
+                         RH850_OSTM0_FREQ);
 }
 
 
@@ -47,50 +66,91 @@ main() -> machne.c:machine_run_board_init() -> rh850mini.c:rh850mini_init() -> a
 static void rh850_soc_realize(DeviceState *dev, Error **errp)
 {
     RH850_SOC_State *s = RH850_SOC(dev);
-    Error *err = NULL;
-
-//    if (!s->board_memory) {
-//        error_setg(errp, "memory property was not set");
-//        return;
-//    }
-
-//    memory_region_add_subregion_overlap(&s->container, 0, s->board_memory, -1);
-
-    s->cpu = RH850_CPU(object_new(s->cpu_type));
-
-    // Commented line with 'OBJECT(&s->container)' adds container memory to CPU,
-    // but container is empty - we'd have to add FLASH and RAM to container.
-    // Line with OBJECT(get_system_memory()) adds system memory to CPU, which contains
-    // FLASH and RAM. Use monitor command 'info mtree' to see memory tree.
-    //object_property_set_link(OBJECT(s->cpu), OBJECT(&s->container), "memory",
-    object_property_set_link(OBJECT(s->cpu), OBJECT(get_system_memory()), "memory",
-                             &error_abort);
-    object_property_set_bool(OBJECT(s->cpu), true, "realized", &err);
-    if (err != NULL) {
-        error_propagate(errp, err);
+    MemoryRegion *board_memory = s->board_memory ? s->board_memory
+                                                 : get_system_memory();
+    SysBusDevice *sbd;
+    int i;
+
+    if (s->num_pes < 1 || s->num_pes > RH850_SOC_MAX_PES) {
+        error_setg(errp, "num-pes %u must be between 1 and %d",
+                   s->num_pes, RH850_SOC_MAX_PES);
         return;
     }
 
-    /* Note that we must realize the NVIC after the CPU */
-//    object_property_set_bool(OBJECT(&s->nvic), true, "realized", &err);
-//    if (err != NULL) {
-//        error_propagate(errp, err);
-//        return;
-//    }
+    for (i = 0; i < s->num_pes; i++) {
+        Object *obj = OBJECT(dev);
+
+        memory_region_init(&s->container[i], obj, "rh850-pe-container",
+                           UINT64_C(0x100000000));
+        memory_region_init_alias(&s->board_alias[i], obj, "rh850-board-memory",
+                                 board_memory, 0,
+                                 memory_region_size(board_memory));
+        memory_region_add_subregion_overlap(&s->container[i], 0,
+                                            &s->board_alias[i], -1);
+
+        if (s->lram_size) {
+            g_autofree char *name = g_strdup_printf("rh850.lram_pe%d", i);
+            Error *err = NULL;
+
+            memory_region_init_ram(&s->lram[i], obj, name, s->lram_size, &err);
+            if (err) {
+                error_propagate(errp, err);
+                return;
+            }
+            memory_region_add_subregion(get_system_memory(),
+                                        RH850_LRAM_GLOBAL_END(i) - s->lram_size,
+                                        &s->lram[i]);
+            memory_region_init_alias(&s->lram_self[i], obj, "rh850.lram_self",
+                                     &s->lram[i], 0, s->lram_size);
+            memory_region_add_subregion(&s->container[i],
+                                        RH850_LRAM_SELF_END - s->lram_size,
+                                        &s->lram_self[i]);
+        }
+
+        s->cpu[i] = RH850_CPU(object_new(s->cpu_type));
+        object_property_set_uint(OBJECT(s->cpu[i]), "pe-id", i + 1,
+                                 &error_abort);
+        object_property_set_link(OBJECT(s->cpu[i]), "memory",
+                                 OBJECT(&s->container[i]), &error_abort);
+        if (!qdev_realize(DEVICE(s->cpu[i]), NULL, errp)) {
+            return;
+        }
+    }
+
+    /* Note that we must realize the INTC after the CPU */
+    qdev_prop_set_uint32(DEVICE(&s->intc), "num-pe", s->num_pes);
+    if (!sysbus_realize(SYS_BUS_DEVICE(&s->intc), errp)) {
+        return;
+    }
 
-    /* Alias the NVIC's input and output GPIOs as our own so the board
+    /* Alias the INTC's input GPIOs as our own so the board
      * code can wire them up. (We do this in realize because the
-     * NVIC doesn't create the input GPIO array until realize.)
+     * INTC doesn't create the input GPIO array until realize.)
      */
-/*    qdev_pass_gpios(DEVICE(&s->nvic), dev, NULL);
-    qdev_pass_gpios(DEVICE(&s->nvic), dev, "SYSRESETREQ");
+    qdev_pass_gpios(DEVICE(&s->intc), dev, NULL);
+
+    // Wire the INTC up to the CPUs, INTC1 is visible only to its own PE
+    sbd = SYS_BUS_DEVICE(&s->intc);
+    for (i = 0; i < s->num_pes; i++) {
+        sysbus_connect_irq(sbd, i,
+                           qdev_get_gpio_in(DEVICE(s->cpu[i]), RH850_INT_EIINT));
+        s->cpu[i]->env.intc = &s->intc.pe[i];
+        memory_region_add_subregion(&s->container[i], RH850_INTC1_BASE,
+                                    sysbus_mmio_get_region(sbd,
+                                                           i ? 1 + i : 0));
+    }
+    memory_region_add_subregion(get_system_memory(), RH850_INTC2_BASE,
+                                sysbus_mmio_get_region(sbd, 1));
 
-    // Wire the NVIC up to the CPU
-    sbd = SYS_BUS_DEVICE(&s->nvic);
+    if (!sysbus_realize(SYS_BUS_DEVICE(&s->ostm), errp)) {
+        return;
+    }
+    sbd = SYS_BUS_DEVICE(&s->ostm);
     sysbus_connect_irq(sbd, 0,
-                       qdev_get_gpio_in(DEVICE(s->cpu), ARM_CPU_IRQ));
-    s->cpu->env.nvic = &s->nvic;
-*/
+                       qdev_get_gpio_in(DEVICE(&s->intc), RH850_OSTM0_IRQ));
+    memory_region_add_subregion(get_system_memory(), RH850_OSTM0_BASE,
+                                sysbus_mmio_get_region(sbd, 0));
+
 /*    memory_region_add_subregion(&s->container, 0xe000e000,
                                 sysbus_mmio_get_region(sbd, 0));
 
@@ -123,6 +183,8 @@ static void rh850_soc_realize(DeviceState *dev, Error **errp)
  */
 static Property rh850_soc_properties[] = {
     DEFINE_PROP_STRING("cpu-type", RH850_SOC_State, cpu_type),
+    DEFINE_PROP_UINT32("num-pes", RH850_SOC_State, num_pes, 1),
+    DEFINE_PROP_UINT32("lram-size", RH850_SOC_State, lram_size, 0),
     DEFINE_PROP_LINK("memory", RH850_SOC_State, board_memory, TYPE_MEMORY_REGION,
                      MemoryRegion *),
 //    DEFINE_PROP_LINK("idau", ARMv7MState, idau, TYPE_IDAU_INTERFACE, Object *),
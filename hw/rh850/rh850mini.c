@@ -3,8 +3,8 @@
  *
  * Copyright (c) 2018 iSYSTEM Labs d.o.o.
  *
- * This file implements simple board with RH850 microcontroller and
- * no peripherals.
+ * This file implements simple board with RH850 microcontroller. The only
+ * peripheral is interrupt controller (INTC1/INTC2), which is part of SoC.
  *
  *
  * This program is free software; you can redistribute it and/or modify it
@@ -26,7 +26,7 @@
 #include "qapi/error.h"
 #include "hw/loader.h"
 #include "elf.h"
-//#include "hw/sysbus.h"
+#include "hw/sysbus.h"
 //#include "hw/ssi/ssi.h"
 #include "hw/rh850/rh850_soc.h"
 //#include "hw/devices.h"
@@ -34,6 +34,8 @@
 //#include "hw/i2c/i2c.h"
 //#include "net/net.h"
 #include "hw/boards.h"
+#include "hw/memory-map.h"
+#include "hw/misc/isystem_profiler.h"
 #include "hw/qdev-properties.h"
 #include "exec/memory.h"
 //#include "qemu/log.h"
@@ -52,6 +54,9 @@ const uint32_t SRAM_SIZE_0 = 192 * (1 << 10); // 192 kB
 const uint32_t FLASH_START_0 = 0;
 const uint32_t SRAM_START_0 = 0xfedd8000;  // start of RAM for F1L devices, is not the same for other RH850 devices
 
+/* Local RAM of each PE when more than one is used (-smp), as on F1KM */
+const uint32_t LRAM_SIZE = 128 * (1 << 10); // 128 kB
+
 const uint32_t FLASH_SIZE_1 = 0;
 const uint32_t SRAM_SIZE_1 = 0;
 const uint32_t FLASH_START_1 = 0;
@@ -75,6 +80,18 @@ const uint32_t SRAM_SIZE_4 = 0;
 const uint32_t FLASH_START_4 = 0;
 const uint32_t SRAM_START_4 = 0;
 
+/* Port P1 data register, written by isystem_profile_write() of sample HALs */
+#define RH850_P1_BASE 0xffc10004
+
+#define TYPE_RH850MINI_MACHINE MACHINE_TYPE_NAME("rh850mini")
+OBJECT_DECLARE_SIMPLE_TYPE(RH850MiniMachineState, RH850MINI_MACHINE)
+
+struct RH850MiniMachineState {
+    MachineState parent_obj;
+
+    char *profile;
+};
+
 
 static void rh850_reset(void *opaque)
 {
@@ -84,10 +101,48 @@ static void rh850_reset(void *opaque)
 }
 
 
-static void add_memory(const char *mem_prefix,
+/**
+ * Maps flash from the image of kernel_filename in cache_dir, which is
+ * shared by all instances started with the same file. Returns false if
+ * the cache is not used, then flash is allocated and loaded as usual.
+ */
+static bool init_cached_flash(MemoryRegion *flash, const char *name,
+                              uint32_t flash_start, uint32_t flash_size,
+                              const char *kernel_filename,
+                              const char *cache_dir)
+{
+    Error *err = NULL;
+
+    if (!kernel_filename || !cache_dir) {
+        return false;
+    }
+    if (!load_elf_flash_cached(flash, NULL, name, flash_start, flash_size,
+                               kernel_filename, cache_dir, 0, EM_RH850,
+                               &err)) {
+        // V850 is subset of RH850, see load_rh_kernel()
+        if (!load_elf_flash_cached(flash, NULL, name, flash_start,
+                                   flash_size, kernel_filename, cache_dir,
+                                   0, EM_V850, NULL)) {
+            warn_report_err(err);
+            return false;
+        }
+        error_free(err);
+    }
+    return true;
+}
+
+
+/**
+ * Returns true if kernel_filename was loaded into flash from cache_dir.
+ * Both are NULL for memory areas, which are not loaded from cache.
+ */
+static bool add_memory(const char *mem_prefix,
                        uint32_t flash_start, uint32_t flash_size,
-                       uint32_t ram_start, uint32_t ram_size)
+                       uint32_t ram_start, uint32_t ram_size,
+                       const char *kernel_filename, const char *cache_dir)
 {
+    bool kernel_loaded = false;
+
     get_memory_ranges(mem_prefix, &flash_start, &flash_size, &ram_start, &ram_size);
 
     MemoryRegion *system_memory = get_system_memory();
@@ -97,8 +152,13 @@ static void add_memory(const char *mem_prefix,
         /* Flash programming is done via the SCU, so pretend it is ROM.  */
         char mem_name[20] = {"rh850.flash_"};
         pstrcat(mem_name, sizeof(mem_name), mem_prefix);
-        memory_region_init_ram(flash, NULL, mem_name, flash_size, &error_fatal);
-        memory_region_set_readonly(flash, true);
+        kernel_loaded = init_cached_flash(flash, mem_name, flash_start,
+                                          flash_size, kernel_filename,
+                                          cache_dir);
+        if (!kernel_loaded) {
+            memory_region_init_ram(flash, NULL, mem_name, flash_size, &error_fatal);
+            memory_region_set_readonly(flash, true);
+        }
         memory_region_add_subregion(system_memory, flash_start, flash);
     }
 
@@ -109,22 +169,28 @@ static void add_memory(const char *mem_prefix,
         memory_region_init_ram(sram, NULL, mem_name, ram_size, &error_fatal);
         memory_region_add_subregion(system_memory, ram_start, sram);
     }
+
+    return kernel_loaded;
 }
 
 
 // main() -> machne.c:machine_run_board_init() -> rh850mini.c:rh850mini_init() -> add_cpu()
-static void add_cpu(const char *cpu_type)
+static void add_cpu(const char *cpu_type, unsigned int num_pes)
 {
     DeviceState *rh850cpu;
 
-    rh850cpu = qdev_create(NULL, TYPE_RH850_SOC);
+    rh850cpu = qdev_new(TYPE_RH850_SOC);
 
     // qdev_prop_set_uint32(rh850cpu, "num-irq", 1);
     qdev_prop_set_string(rh850cpu, "cpu-type", cpu_type);
-    object_property_set_link(OBJECT(rh850cpu), OBJECT(get_system_memory()),
-                                     "memory", &error_abort);
+    qdev_prop_set_uint32(rh850cpu, "num-pes", num_pes);
+    if (num_pes > 1) {
+        qdev_prop_set_uint32(rh850cpu, "lram-size", LRAM_SIZE);
+    }
+    object_property_set_link(OBJECT(rh850cpu), "memory",
+                             OBJECT(get_system_memory()), &error_abort);
     /* This will exit with an error if the user passed us a bad cpu_type */
-    qdev_init_nofail(rh850cpu);
+    sysbus_realize_and_unref(SYS_BUS_DEVICE(rh850cpu), &error_fatal);
 
 }
 
@@ -175,25 +241,54 @@ static void load_rh_kernel(RH850CPU *cpu, const char *kernel_filename, int mem_s
         }
     }
 
-    /* CPU objects (unlike devices) are not automatically reset on system
-     * reset, so we must always register a handler to do so.
-     */
-    qemu_register_reset(rh850_reset, cpu);
 }
 
 
 // main() -> machne.c:machine_run_board_init() -> rh850mini.c:rh850mini_init()
 static void rh850mini_init(MachineState *ms)
 {
-    // modern multicore RH850 devices have many memory areas.
-    add_memory("0", FLASH_START_0, FLASH_SIZE_0, SRAM_START_0, SRAM_SIZE_0);
-    add_memory("1", FLASH_START_1, FLASH_SIZE_1, SRAM_START_1, SRAM_SIZE_1);
-    add_memory("2", FLASH_START_2, FLASH_SIZE_2, SRAM_START_2, SRAM_SIZE_2);
-    add_memory("3", FLASH_START_3, FLASH_SIZE_3, SRAM_START_3, SRAM_SIZE_3);
-    add_memory("4", FLASH_START_4, FLASH_SIZE_4, SRAM_START_4, SRAM_SIZE_4);
+    RH850MiniMachineState *rms = RH850MINI_MACHINE(ms);
+    CPUState *cs;
+    bool kernel_loaded = false;
+
+    if (ms->memory_map) {
+        memory_map_init(ms->memory_map, get_system_memory(), &error_fatal);
+    } else {
+        // modern multicore RH850 devices have many memory areas.
+        kernel_loaded = add_memory("0", FLASH_START_0, FLASH_SIZE_0,
+                                   SRAM_START_0, SRAM_SIZE_0,
+                                   ms->kernel_filename, ms->flash_cache);
+        add_memory("1", FLASH_START_1, FLASH_SIZE_1, SRAM_START_1,
+                   SRAM_SIZE_1, NULL, NULL);
+        add_memory("2", FLASH_START_2, FLASH_SIZE_2, SRAM_START_2,
+                   SRAM_SIZE_2, NULL, NULL);
+        add_memory("3", FLASH_START_3, FLASH_SIZE_3, SRAM_START_3,
+                   SRAM_SIZE_3, NULL, NULL);
+        add_memory("4", FLASH_START_4, FLASH_SIZE_4, SRAM_START_4,
+                   SRAM_SIZE_4, NULL, NULL);
+    }
 
-    add_cpu(ms->cpu_type);
-    load_rh_kernel(RH850_CPU(first_cpu), ms->kernel_filename, FLASH_SIZE_0);
+    add_cpu(ms->cpu_type, ms->smp.cpus);
+    if (!kernel_loaded) {
+        load_rh_kernel(RH850_CPU(first_cpu), ms->kernel_filename,
+                       FLASH_SIZE_0);
+    }
+
+    /* CPU objects (unlike devices) are not automatically reset on system
+     * reset, so we must always register a handler to do so. All PEs start
+     * at the reset vector, software tells them apart by HTCFG0.PEID.
+     */
+    CPU_FOREACH(cs) {
+        qemu_register_reset(rh850_reset, RH850_CPU(cs));
+    }
+
+    if (rms->profile) {
+        DeviceState *profiler = qdev_new(TYPE_ISYSTEM_PROFILER);
+
+        qdev_prop_set_string(profiler, "file", rms->profile);
+        sysbus_realize_and_unref(SYS_BUS_DEVICE(profiler), &error_fatal);
+        sysbus_mmio_map(SYS_BUS_DEVICE(profiler), 0, RH850_P1_BASE);
+    }
 
 //    nvic = armv7m_init(system_memory, flash_size, NUM_IRQ_LINES,
 //                       ms->kernel_filename, ms->cpu_type);
@@ -224,6 +319,22 @@ static void rh850mini_init(MachineState *ms)
 }
 
 
+static char *rh850mini_get_profile(Object *obj, Error **errp)
+{
+    RH850MiniMachineState *rms = RH850MINI_MACHINE(obj);
+
+    return g_strdup(rms->profile);
+}
+
+static void rh850mini_set_profile(Object *obj, const char *value,
+                                  Error **errp)
+{
+    RH850MiniMachineState *rms = RH850MINI_MACHINE(obj);
+
+    g_free(rms->profile);
+    rms->profile = g_strdup(value);
+}
+
 static void rh850mini_class_init(ObjectClass *oc, void *data)
 {
     MachineClass *mc = MACHINE_CLASS(oc);
@@ -232,11 +343,18 @@ static void rh850mini_class_init(ObjectClass *oc, void *data)
     mc->init = rh850mini_init;
     mc->ignore_memory_transaction_failures = true;
     mc->default_cpu_type = RH850_CPU_TYPE_NAME("any");
+    mc->max_cpus = RH850_SOC_MAX_PES;
+
+    object_class_property_add_str(oc, "profile", rh850mini_get_profile,
+                                  rh850mini_set_profile);
+    object_class_property_set_description(oc, "profile",
+        "File to record events of isystem_profile_write() into");
 }
 
 static const TypeInfo rh850mini_type = {
-    .name = MACHINE_TYPE_NAME("rh850mini"),
+    .name = TYPE_RH850MINI_MACHINE,
     .parent = TYPE_MACHINE,
+    .instance_size = sizeof(RH850MiniMachineState),
     .class_init = rh850mini_class_init,
 };
 
@@ -39,24 +39,83 @@ static inline int64_t systick_scale(SysTickState *s)
     }
 }
 
+/*
+ * The counter is not stepped by a timer. While the SysTick is enabled, it
+ * is computed from the virtual clock: s->count is its value at time
+ * s->tick, and it decrements every s->period ns. After reaching 0 it is
+ * reloaded from SYST_RVR on the next clock, or stays at 0 if SYST_RVR is 0.
+ * COUNTFLAG is also set lazily, when the registers are accessed, so the
+ * QEMUTimer is only armed when counting to 0 pends the SysTick exception.
+ * The exception is pended by whichever of a register access or the timer
+ * callback notices the wrap first.
+ */
+static void systick_sync(SysTickState *s, int64_t now)
+{
+    uint64_t n, k;
+    uint32_t count;
+    bool wrapped;
+
+    if (!(s->control & SYSTICK_ENABLE) || now <= s->tick) {
+        return;
+    }
+    n = (now - s->tick) / s->period;
+    if (n == 0) {
+        return;
+    }
+
+    if (n <= s->count) {
+        count = s->count - n;
+        wrapped = count == 0;
+    } else if (s->reload == 0) {
+        count = 0;
+        wrapped = s->count != 0;
+    } else {
+        /* k clocks after the first reload from SYST_RVR */
+        k = n - s->count - 1;
+        count = s->reload - k % (s->reload + 1);
+        wrapped = s->count != 0 || k >= s->reload;
+    }
+
+    s->count = count;
+    s->tick += n * s->period;
+    if (wrapped) {
+        s->control |= SYSTICK_COUNTFLAG;
+        if (s->control & SYSTICK_TICKINT) {
+            /* Tell the NVIC to pend the SysTick exception */
+            qemu_irq_pulse(s->irq);
+        }
+    }
+}
+
+/* Arms the timer for the next time the counter reaches 0 from 1 */
+static void systick_update_timer(SysTickState *s)
+{
+    uint64_t n;
+
+    if ((s->control & (SYSTICK_ENABLE | SYSTICK_TICKINT)) !=
+        (SYSTICK_ENABLE | SYSTICK_TICKINT)) {
+        timer_del(s->timer);
+        return;
+    }
+    if (s->count != 0) {
+        n = s->count;
+    } else if (s->reload != 0) {
+        n = s->reload + 1;
+    } else {
+        timer_del(s->timer);
+        return;
+    }
+    timer_mod(s->timer, s->tick + n * s->period);
+}
+
 static void systick_timer_tick(void *opaque)
 {
     SysTickState *s = (SysTickState *)opaque;
 
     trace_systick_timer_tick();
 
-    s->control |= SYSTICK_COUNTFLAG;
-    if (s->control & SYSTICK_TICKINT) {
-        /* Tell the NVIC to pend the SysTick exception */
-        qemu_irq_pulse(s->irq);
-    }
-    if (ptimer_get_limit(s->ptimer) == 0) {
-        /*
-         * Timer expiry with SYST_RVR zero disables the timer
-         * (but doesn't clear SYST_CSR.ENABLE)
-         */
-        ptimer_stop(s->ptimer);
-    }
+    systick_sync(s, qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL));
+    systick_update_timer(s);
 }
 
 static MemTxResult systick_read(void *opaque, hwaddr addr, uint64_t *data,
@@ -70,16 +129,18 @@ static MemTxResult systick_read(void *opaque, hwaddr addr, uint64_t *data,
         return MEMTX_ERROR;
     }
 
+    systick_sync(s, qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL));
+
     switch (addr) {
     case 0x0: /* SysTick Control and Status.  */
         val = s->control;
         s->control &= ~SYSTICK_COUNTFLAG;
         break;
     case 0x4: /* SysTick Reload Value.  */
-        val = ptimer_get_limit(s->ptimer);
+        val = s->reload;
         break;
     case 0x8: /* SysTick Current Value.  */
-        val = ptimer_get_count(s->ptimer);
+        val = s->count;
         break;
     case 0xc: /* SysTick Calibration Value.  */
         val = 10000;
@@ -101,6 +162,7 @@ static MemTxResult systick_write(void *opaque, hwaddr addr,
                                  MemTxAttrs attrs)
 {
     SysTickState *s = opaque;
+    int64_t now = qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL);
 
     if (attrs.user) {
         /* Generate BusFault for unprivileged accesses */
@@ -109,12 +171,13 @@ static MemTxResult systick_write(void *opaque, hwaddr addr,
 
     trace_systick_write(addr, value, size);
 
+    systick_sync(s, now);
+
     switch (addr) {
     case 0x0: /* SysTick Control and Status.  */
     {
         uint32_t oldval;
 
-        ptimer_transaction_begin(s->ptimer);
         oldval = s->control;
         s->control &= 0xfffffff8;
         s->control |= value & 7;
@@ -127,21 +190,16 @@ static MemTxResult systick_write(void *opaque, hwaddr addr,
                  * global with a more sensible API then we might be able
                  * to set the period only when it actually changes.
                  */
-                ptimer_set_period(s->ptimer, systick_scale(s));
-                ptimer_run(s->ptimer, 0);
-            } else {
-                ptimer_stop(s->ptimer);
+                s->period = systick_scale(s);
+                s->tick = now;
             }
         } else if ((oldval ^ value) & SYSTICK_CLKSOURCE) {
-            ptimer_set_period(s->ptimer, systick_scale(s));
+            s->period = systick_scale(s);
         }
-        ptimer_transaction_commit(s->ptimer);
         break;
     }
     case 0x4: /* SysTick Reload Value.  */
-        ptimer_transaction_begin(s->ptimer);
-        ptimer_set_limit(s->ptimer, value & 0xffffff, 0);
-        ptimer_transaction_commit(s->ptimer);
+        s->reload = value & 0xffffff;
         break;
     case 0x8: /* SysTick Current Value. */
         /*
@@ -149,18 +207,14 @@ static MemTxResult systick_write(void *opaque, hwaddr addr,
          * SYST_CSR.COUNTFLAG. The counter will then reload from SYST_RVR
          * on the next clock edge unless SYST_RVR is zero.
          */
-        ptimer_transaction_begin(s->ptimer);
-        if (ptimer_get_limit(s->ptimer) == 0) {
-            ptimer_stop(s->ptimer);
-        }
-        ptimer_set_count(s->ptimer, 0);
+        s->count = 0;
         s->control &= ~SYSTICK_COUNTFLAG;
-        ptimer_transaction_commit(s->ptimer);
         break;
     default:
         qemu_log_mask(LOG_GUEST_ERROR,
                       "SysTick: Bad write offset 0x%" HWADDR_PRIx "\n", addr);
     }
+    systick_update_timer(s);
     return MEMTX_OK;
 }
 
@@ -184,13 +238,12 @@ static void systick_reset(DeviceState *dev)
      */
     assert(system_clock_scale != 0);
 
-    ptimer_transaction_begin(s->ptimer);
     s->control = 0;
-    ptimer_stop(s->ptimer);
-    ptimer_set_count(s->ptimer, 0);
-    ptimer_set_limit(s->ptimer, 0, 0);
-    ptimer_set_period(s->ptimer, systick_scale(s));
-    ptimer_transaction_commit(s->ptimer);
+    s->reload = 0;
+    s->count = 0;
+    s->tick = 0;
+    s->period = systick_scale(s);
+    timer_del(s->timer);
 }
 
 static void systick_instance_init(Object *obj)
@@ -206,21 +259,20 @@ static void systick_instance_init(Object *obj)
 static void systick_realize(DeviceState *dev, Error **errp)
 {
     SysTickState *s = SYSTICK(dev);
-    s->ptimer = ptimer_init(systick_timer_tick, s,
-                            PTIMER_POLICY_WRAP_AFTER_ONE_PERIOD |
-                            PTIMER_POLICY_NO_COUNTER_ROUND_DOWN |
-                            PTIMER_POLICY_NO_IMMEDIATE_RELOAD |
-                            PTIMER_POLICY_TRIGGER_ONLY_ON_DECREMENT);
+    s->timer = timer_new_ns(QEMU_CLOCK_VIRTUAL, systick_timer_tick, s);
 }
 
 static const VMStateDescription vmstate_systick = {
     .name = "armv7m_systick",
-    .version_id = 2,
-    .minimum_version_id = 2,
+    .version_id = 3,
+    .minimum_version_id = 3,
     .fields = (VMStateField[]) {
         VMSTATE_UINT32(control, SysTickState),
+        VMSTATE_UINT32(reload, SysTickState),
+        VMSTATE_UINT32(count, SysTickState),
         VMSTATE_INT64(tick, SysTickState),
-        VMSTATE_PTIMER(ptimer, SysTickState),
+        VMSTATE_INT64(period, SysTickState),
+        VMSTATE_TIMER_PTR(timer, SysTickState),
         VMSTATE_END_OF_LIST()
     }
 };
@@ -0,0 +1,325 @@
+/*
+ * RH850 OS timer (OSTM)
+ *
+ * Datasheet: RH850/F1L Group User's Manual: Hardware
+ *            (R01UH0390EJ0110), section 23 OS Timer
+ *
+ * Copyright (c) 2021 iSYSTEM Labs d.o.o.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2 or later, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "qemu/osdep.h"
+#include "qemu/log.h"
+#include "qemu/module.h"
+#include "qapi/error.h"
+#include "hw/irq.h"
+#include "hw/registerfields.h"
+#include "hw/qdev-properties.h"
+#include "hw/timer/rh850_ostm.h"
+#include "migration/vmstate.h"
+
+REG32(CMP, 0x00)
+REG32(CNT, 0x04)
+REG8(TO, 0x08)
+REG8(TOE, 0x0c)
+REG8(TE, 0x10)
+REG8(TS, 0x14)
+REG8(TT, 0x18)
+REG8(CTL, 0x20)
+    FIELD(CTL, MD0, 0, 1)       /* interrupt request at start of counting */
+    FIELD(CTL, MD1, 1, 1)       /* 0 - interval timer, 1 - free-run compare */
+
+#define OSTM_CNT_RESET 0xffffffff
+
+static bool ostm_free_run(RH850OSTMState *s)
+{
+    return FIELD_EX8(s->ctl, CTL, MD1);
+}
+
+static uint64_t ostm_ticks_to_ns(RH850OSTMState *s, uint64_t ticks)
+{
+    /* Round up, so that the counter has really reached the event */
+    return (ticks * NANOSECONDS_PER_SECOND + s->freq - 1) / s->freq;
+}
+
+static uint64_t ostm_elapsed(RH850OSTMState *s, int64_t now)
+{
+    if (now <= s->tick) {
+        return 0;
+    }
+    return muldiv64(now - s->tick, s->freq, NANOSECONDS_PER_SECOND);
+}
+
+static uint32_t ostm_count(RH850OSTMState *s, uint64_t elapsed)
+{
+    if (ostm_free_run(s)) {
+        return s->cnt + elapsed;
+    }
+    /* The timer fires on underflow, so a late callback must not wrap */
+    return elapsed < s->cnt ? s->cnt - elapsed : 0;
+}
+
+static uint32_t ostm_read_cnt(RH850OSTMState *s)
+{
+    if (!s->te) {
+        return s->cnt;
+    }
+    return ostm_count(s, ostm_elapsed(s,
+                                      qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL)));
+}
+
+/* Number of count clocks from the snapshot in cnt to the next interrupt */
+static uint64_t ostm_ticks_to_event(RH850OSTMState *s)
+{
+    uint32_t delta;
+
+    if (ostm_free_run(s)) {
+        delta = s->cmp - s->cnt;
+        return delta ? delta : 1ULL << 32;
+    }
+    return (uint64_t)s->cnt + 1;
+}
+
+static void ostm_update_events(RH850OSTMState *s)
+{
+    if (!s->te) {
+        timer_del(&s->timer);
+        return;
+    }
+    timer_mod(&s->timer,
+              s->tick + ostm_ticks_to_ns(s, ostm_ticks_to_event(s)));
+}
+
+/* Move the snapshot to the current time, on the last count clock edge */
+static void ostm_sync(RH850OSTMState *s)
+{
+    uint64_t elapsed = ostm_elapsed(s, qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL));
+
+    s->cnt = ostm_count(s, elapsed);
+    s->tick += ostm_ticks_to_ns(s, elapsed);
+}
+
+static void ostm_timer_event(void *opaque)
+{
+    RH850OSTMState *s = opaque;
+
+    /*
+     * Advance the snapshot by exactly one period instead of taking the
+     * current time, so that a late callback does not make the timer drift.
+     */
+    s->tick += ostm_ticks_to_ns(s, ostm_ticks_to_event(s));
+    s->cnt = s->cmp;
+    ostm_update_events(s);
+    qemu_irq_pulse(s->irq);
+}
+
+static void ostm_start(RH850OSTMState *s)
+{
+    if (s->te && ostm_free_run(s)) {
+        /* Ignored while counting in free-run compare mode */
+        return;
+    }
+    s->te = 1;
+    s->tick = qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL);
+    s->cnt = ostm_free_run(s) ? 0 : s->cmp;
+    ostm_update_events(s);
+    if (FIELD_EX8(s->ctl, CTL, MD0)) {
+        qemu_irq_pulse(s->irq);
+    }
+}
+
+static void ostm_stop(RH850OSTMState *s)
+{
+    if (s->te) {
+        s->cnt = ostm_read_cnt(s);
+        s->te = 0;
+        timer_del(&s->timer);
+    }
+}
+
+static uint64_t ostm_read(void *opaque, hwaddr offset, unsigned size)
+{
+    RH850OSTMState *s = opaque;
+
+    switch (offset) {
+    case A_CMP:
+        return s->cmp;
+    case A_CNT:
+        return ostm_read_cnt(s);
+    case A_TO:
+        return s->to;
+    case A_TOE:
+        return s->toe;
+    case A_TE:
+        return s->te;
+    case A_TS:
+    case A_TT:
+        return 0;
+    case A_CTL:
+        return s->ctl;
+    default:
+        qemu_log_mask(LOG_GUEST_ERROR, "rh850_ostm: Register 0x%" HWADDR_PRIX
+                      " is not implemented\n", offset);
+        return 0;
+    }
+}
+
+static void ostm_write(void *opaque, hwaddr offset, uint64_t val,
+                       unsigned size)
+{
+    RH850OSTMState *s = opaque;
+
+    switch (offset) {
+    case A_CMP:
+        if (s->te && ostm_free_run(s)) {
+            /* New compare value takes effect immediately */
+            ostm_sync(s);
+            s->cmp = val;
+            ostm_update_events(s);
+        } else {
+            /* Interval mode reloads it on the next underflow */
+            s->cmp = val;
+        }
+        break;
+    case A_CNT:
+    case A_TE:
+        qemu_log_mask(LOG_GUEST_ERROR, "rh850_ostm: Register 0x%" HWADDR_PRIX
+                      " is read-only\n", offset);
+        break;
+    case A_TO:
+        s->to = val & 1;
+        break;
+    case A_TOE:
+        s->toe = val & 1;
+        break;
+    case A_TS:
+        if (val & 1) {
+            ostm_start(s);
+        }
+        break;
+    case A_TT:
+        if (val & 1) {
+            ostm_stop(s);
+        }
+        break;
+    case A_CTL:
+        if (s->te) {
+            qemu_log_mask(LOG_GUEST_ERROR, "rh850_ostm: CTL written while "
+                          "the counter is enabled\n");
+            break;
+        }
+        s->ctl = val & (R_CTL_MD0_MASK | R_CTL_MD1_MASK);
+        break;
+    default:
+        qemu_log_mask(LOG_GUEST_ERROR, "rh850_ostm: Register 0x%" HWADDR_PRIX
+                      " is not implemented\n", offset);
+        break;
+    }
+}
+
+static const MemoryRegionOps ostm_ops = {
+    .read = ostm_read,
+    .write = ostm_write,
+    .endianness = DEVICE_LITTLE_ENDIAN,
+    .impl = {
+        .min_access_size = 1,
+        .max_access_size = 4,
+    },
+    .valid = {
+        .min_access_size = 1,
+        .max_access_size = 4,
+    },
+};
+
+static void ostm_reset(DeviceState *dev)
+{
+    RH850OSTMState *s = RH850_OSTM(dev);
+
+    timer_del(&s->timer);
+    s->cmp = 0;
+    s->cnt = OSTM_CNT_RESET;
+    s->tick = 0;
+    s->te = 0;
+    s->to = 0;
+    s->toe = 0;
+    s->ctl = 0;
+}
+
+static void ostm_init(Object *obj)
+{
+    SysBusDevice *sbd = SYS_BUS_DEVICE(obj);
+    RH850OSTMState *s = RH850_OSTM(obj);
+
+    memory_region_init_io(&s->iomem, obj, &ostm_ops, s, "rh850-ostm", 0x100);
+    sysbus_init_mmio(sbd, &s->iomem);
+    sysbus_init_irq(sbd, &s->irq);
+    timer_init_ns(&s->timer, QEMU_CLOCK_VIRTUAL, ostm_timer_event, s);
+}
+
+static void ostm_realize(DeviceState *dev, Error **errp)
+{
+    RH850OSTMState *s = RH850_OSTM(dev);
+
+    if (s->freq == 0) {
+        error_setg(errp, "rh850_ostm: clock-frequency property must be set");
+        return;
+    }
+}
+
+static const VMStateDescription vmstate_ostm = {
+    .name = "rh850-ostm",
+    .version_id = 1,
+    .minimum_version_id = 1,
+    .fields = (VMStateField[]) {
+        VMSTATE_UINT32(cmp, RH850OSTMState),
+        VMSTATE_UINT8(te, RH850OSTMState),
+        VMSTATE_UINT8(to, RH850OSTMState),
+        VMSTATE_UINT8(toe, RH850OSTMState),
+        VMSTATE_UINT8(ctl, RH850OSTMState),
+        VMSTATE_UINT32(cnt, RH850OSTMState),
+        VMSTATE_INT64(tick, RH850OSTMState),
+        VMSTATE_TIMER(timer, RH850OSTMState),
+        VMSTATE_END_OF_LIST()
+    }
+};
+
+static Property ostm_properties[] = {
+    DEFINE_PROP_UINT64("clock-frequency", RH850OSTMState, freq, 0),
+    DEFINE_PROP_END_OF_LIST(),
+};
+
+static void ostm_class_init(ObjectClass *klass, void *data)
+{
+    DeviceClass *dc = DEVICE_CLASS(klass);
+
+    dc->realize = ostm_realize;
+    dc->reset = ostm_reset;
+    dc->vmsd = &vmstate_ostm;
+    device_class_set_props(dc, ostm_properties);
+}
+
+static const TypeInfo ostm_info = {
+    .name = TYPE_RH850_OSTM,
+    .parent = TYPE_SYS_BUS_DEVICE,
+    .instance_size = sizeof(RH850OSTMState),
+    .instance_init = ostm_init,
+    .class_init = ostm_class_init,
+};
+
+static void ostm_register_types(void)
+{
+    type_register_static(&ostm_info);
+}
+
+type_init(ostm_register_types)
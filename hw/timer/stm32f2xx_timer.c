@@ -42,56 +42,89 @@
 
 #define DB_PRINT(fmt, args...) DB_PRINT_L(1, fmt, ## args)
 
-static void stm32f2xx_timer_set_alarm(STM32F2XXTimerState *s, int64_t now);
+static inline int64_t stm32f2xx_ns_to_ticks(STM32F2XXTimerState *s, int64_t t)
+{
+    return muldiv64(t, s->freq_hz, 1000000000ULL) / (s->tim_psc + 1);
+}
 
-static void stm32f2xx_timer_interrupt(void *opaque)
+/* Returns the first time at which at least ticks have elapsed */
+static inline int64_t stm32f2xx_ticks_to_ns(STM32F2XXTimerState *s,
+                                            int64_t ticks)
 {
-    STM32F2XXTimerState *s = opaque;
+    return muldiv64(ticks * (s->tim_psc + 1), 1000000000ULL, s->freq_hz) + 1;
+}
 
-    DB_PRINT("Interrupt\n");
+/*
+ * The counter is computed from the virtual clock: while CEN is set, it
+ * counted 0 at tick_offset and wraps to 0 after reaching ARR, and while
+ * it is stopped, its value is kept in tim_cnt. Overflows are accounted
+ * for here, whenever the timer is accessed, so that the QEMUTimer only
+ * has to be armed when the update interrupt is enabled.
+ */
+static uint32_t stm32f2xx_timer_sync(STM32F2XXTimerState *s, int64_t now)
+{
+    int64_t elapsed;
 
-    if (s->tim_dier & TIM_DIER_UIE && s->tim_cr1 & TIM_CR1_CEN) {
-        s->tim_sr |= 1;
-        qemu_irq_pulse(s->irq);
-        stm32f2xx_timer_set_alarm(s, s->hit_time);
+    if (!(s->tim_cr1 & TIM_CR1_CEN)) {
+        return s->tim_cnt;
     }
-
-    if (s->tim_ccmr1 & (TIM_CCMR1_OC2M2 | TIM_CCMR1_OC2M1) &&
-        !(s->tim_ccmr1 & TIM_CCMR1_OC2M0) &&
-        s->tim_ccmr1 & TIM_CCMR1_OC2PE &&
-        s->tim_ccer & TIM_CCER_CC2E) {
-        /* PWM 2 - Mode 1 */
-        DB_PRINT("PWM2 Duty Cycle: %d%%\n",
-                s->tim_ccr2 / (100 * (s->tim_psc + 1)));
+    elapsed = stm32f2xx_ns_to_ticks(s, now) - s->tick_offset;
+    if (s->tim_arr == 0) {
+        /* The counter does not count while ARR is 0 */
+        s->tick_offset += elapsed;
+        return 0;
+    }
+    if (elapsed > s->tim_arr) {
+        s->tick_offset += elapsed / ((int64_t)s->tim_arr + 1) *
+                          ((int64_t)s->tim_arr + 1);
+        elapsed %= (int64_t)s->tim_arr + 1;
+        s->tim_sr |= 1;
+        if (s->tim_dier & TIM_DIER_UIE) {
+            qemu_irq_pulse(s->irq);
+        }
     }
+    return elapsed;
 }
 
-static inline int64_t stm32f2xx_ns_to_ticks(STM32F2XXTimerState *s, int64_t t)
+/* Restarts the counter from count, at the current time */
+static void stm32f2xx_timer_set_count(STM32F2XXTimerState *s, int64_t now,
+                                      uint32_t count)
 {
-    return muldiv64(t, s->freq_hz, 1000000000ULL) / (s->tim_psc + 1);
+    s->tim_cnt = count;
+    s->tick_offset = stm32f2xx_ns_to_ticks(s, now) - count;
 }
 
-static void stm32f2xx_timer_set_alarm(STM32F2XXTimerState *s, int64_t now)
+static void stm32f2xx_timer_set_alarm(STM32F2XXTimerState *s)
 {
-    uint64_t ticks;
-    int64_t now_ticks;
-
-    if (s->tim_arr == 0) {
+    if (!(s->tim_dier & TIM_DIER_UIE) || !(s->tim_cr1 & TIM_CR1_CEN) ||
+        s->tim_arr == 0) {
+        timer_del(s->timer);
         return;
     }
 
     DB_PRINT("Alarm set at: 0x%x\n", s->tim_cr1);
 
-    now_ticks = stm32f2xx_ns_to_ticks(s, now);
-    ticks = s->tim_arr - (now_ticks - s->tick_offset);
+    timer_mod(s->timer, stm32f2xx_ticks_to_ns(s, s->tick_offset +
+                                                 s->tim_arr + 1));
+}
 
-    DB_PRINT("Alarm set in %d ticks\n", (int) ticks);
+static void stm32f2xx_timer_interrupt(void *opaque)
+{
+    STM32F2XXTimerState *s = opaque;
 
-    s->hit_time = muldiv64((ticks + (uint64_t) now_ticks) * (s->tim_psc + 1),
-                               1000000000ULL, s->freq_hz);
+    DB_PRINT("Interrupt\n");
 
-    timer_mod(s->timer, qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL) + s->hit_time);
-    DB_PRINT("Wait Time: %" PRId64 " ticks\n", s->hit_time);
+    stm32f2xx_timer_sync(s, qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL));
+    stm32f2xx_timer_set_alarm(s);
+
+    if (s->tim_ccmr1 & (TIM_CCMR1_OC2M2 | TIM_CCMR1_OC2M1) &&
+        !(s->tim_ccmr1 & TIM_CCMR1_OC2M0) &&
+        s->tim_ccmr1 & TIM_CCMR1_OC2PE &&
+        s->tim_ccer & TIM_CCER_CC2E) {
+        /* PWM 2 - Mode 1 */
+        DB_PRINT("PWM2 Duty Cycle: %d%%\n",
+                s->tim_ccr2 / (100 * (s->tim_psc + 1)));
+    }
 }
 
 static void stm32f2xx_timer_reset(DeviceState *dev)
@@ -118,16 +151,20 @@ static void stm32f2xx_timer_reset(DeviceState *dev)
     s->tim_dmar = 0;
     s->tim_or = 0;
 
-    s->tick_offset = stm32f2xx_ns_to_ticks(s, now);
+    stm32f2xx_timer_set_count(s, now, 0);
+    timer_del(s->timer);
 }
 
 static uint64_t stm32f2xx_timer_read(void *opaque, hwaddr offset,
                            unsigned size)
 {
     STM32F2XXTimerState *s = opaque;
+    uint32_t count;
 
     DB_PRINT("Read 0x%"HWADDR_PRIx"\n", offset);
 
+    count = stm32f2xx_timer_sync(s, qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL));
+
     switch (offset) {
     case TIM_CR1:
         return s->tim_cr1;
@@ -148,8 +185,7 @@ static uint64_t stm32f2xx_timer_read(void *opaque, hwaddr offset,
     case TIM_CCER:
         return s->tim_ccer;
     case TIM_CNT:
-        return stm32f2xx_ns_to_ticks(s, qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL)) -
-               s->tick_offset;
+        return count;
     case TIM_PSC:
         return s->tim_psc;
     case TIM_ARR:
@@ -182,14 +218,21 @@ static void stm32f2xx_timer_write(void *opaque, hwaddr offset,
     STM32F2XXTimerState *s = opaque;
     uint32_t value = val64;
     int64_t now = qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL);
-    uint32_t timer_val = 0;
+    uint32_t count;
 
     DB_PRINT("Write 0x%x, 0x%"HWADDR_PRIx"\n", value, offset);
 
+    count = stm32f2xx_timer_sync(s, now);
+
     switch (offset) {
     case TIM_CR1:
-        s->tim_cr1 = value;
-        return;
+        if ((s->tim_cr1 ^ value) & TIM_CR1_CEN) {
+            s->tim_cr1 = value;
+            stm32f2xx_timer_set_count(s, now, count);
+        } else {
+            s->tim_cr1 = value;
+        }
+        break;
     case TIM_CR2:
         s->tim_cr2 = value;
         return;
@@ -198,7 +241,7 @@ static void stm32f2xx_timer_write(void *opaque, hwaddr offset,
         return;
     case TIM_DIER:
         s->tim_dier = value;
-        return;
+        break;
     case TIM_SR:
         /* This is set by hardware and cleared by software */
         s->tim_sr &= value;
@@ -206,7 +249,7 @@ static void stm32f2xx_timer_write(void *opaque, hwaddr offset,
     case TIM_EGR:
         s->tim_egr = value;
         if (s->tim_egr & TIM_EGR_UG) {
-            timer_val = 0;
+            stm32f2xx_timer_set_count(s, now, 0);
             break;
         }
         return;
@@ -220,16 +263,15 @@ static void stm32f2xx_timer_write(void *opaque, hwaddr offset,
         s->tim_ccer = value;
         return;
     case TIM_PSC:
-        timer_val = stm32f2xx_ns_to_ticks(s, now) - s->tick_offset;
         s->tim_psc = value & 0xFFFF;
+        stm32f2xx_timer_set_count(s, now, count);
         break;
     case TIM_CNT:
-        timer_val = value;
+        stm32f2xx_timer_set_count(s, now, value);
         break;
     case TIM_ARR:
         s->tim_arr = value;
-        stm32f2xx_timer_set_alarm(s, now);
-        return;
+        break;
     case TIM_CCR1:
         s->tim_ccr1 = value;
         return;
@@ -257,11 +299,10 @@ static void stm32f2xx_timer_write(void *opaque, hwaddr offset,
         return;
     }
 
-    /* This means that a register write has affected the timer in a way that
-     * requires a refresh of both tick_offset and the alarm.
+    /* This means that a register write has affected when the next update
+     * interrupt is due.
      */
-    s->tick_offset = stm32f2xx_ns_to_ticks(s, now) - timer_val;
-    stm32f2xx_timer_set_alarm(s, now);
+    stm32f2xx_timer_set_alarm(s);
 }
 
 static const MemoryRegionOps stm32f2xx_timer_ops = {
@@ -270,10 +311,19 @@ static const MemoryRegionOps stm32f2xx_timer_ops = {
     .endianness = DEVICE_NATIVE_ENDIAN,
 };
 
+static int stm32f2xx_timer_post_load(void *opaque, int version_id)
+{
+    STM32F2XXTimerState *s = opaque;
+
+    stm32f2xx_timer_set_alarm(s);
+    return 0;
+}
+
 static const VMStateDescription vmstate_stm32f2xx_timer = {
     .name = TYPE_STM32F2XX_TIMER,
-    .version_id = 1,
+    .version_id = 2,
     .minimum_version_id = 1,
+    .post_load = stm32f2xx_timer_post_load,
     .fields = (VMStateField[]) {
         VMSTATE_INT64(tick_offset, STM32F2XXTimerState),
         VMSTATE_UINT32(tim_cr1, STM32F2XXTimerState),
@@ -294,6 +344,7 @@ static const VMStateDescription vmstate_stm32f2xx_timer = {
         VMSTATE_UINT32(tim_dcr, STM32F2XXTimerState),
         VMSTATE_UINT32(tim_dmar, STM32F2XXTimerState),
         VMSTATE_UINT32(tim_or, STM32F2XXTimerState),
+        VMSTATE_UINT32_V(tim_cnt, STM32F2XXTimerState, 2),
         VMSTATE_END_OF_LIST()
     }
 };
@@ -27,6 +27,10 @@ struct BitBandState {
     MemoryRegion iomem;
     uint32_t base;
     MemoryRegion *source_memory;
+    /* RAM at the start of the bit-banded range, refreshed by listener */
+    MemoryRegionCache ram_cache;
+    hwaddr ram_cache_len;
+    MemoryListener listener;
 };
 
 #define TYPE_ARMV7M "armv7m"
@@ -33,6 +33,27 @@ typedef enum {
  */
 void armv7m_load_kernel(ARMCPU *cpu, const char *kernel_filename, int mem_size);
 
+/**
+ * armv7m_init_cached_flash:
+ * @flash: flash memory region to initialize
+ * @owner: the object that tracks the region's reference count
+ * @name: name of the region
+ * @base: address of flash
+ * @size: size of flash
+ * @kernel_filename: file to load, may be NULL
+ * @cache_dir: directory with cached flash images, may be NULL
+ *
+ * Initializes @flash as read-only memory mapped from the image of
+ * @kernel_filename in @cache_dir, see load_elf_flash_cached(). Returns false
+ * without initializing @flash if the cache is not used or the image can't
+ * be cached, then the board initializes flash as usual and passes
+ * @kernel_filename to armv7m_load_kernel(), otherwise it passes NULL.
+ */
+bool armv7m_init_cached_flash(MemoryRegion *flash, Object *owner,
+                              const char *name, hwaddr base, uint64_t size,
+                              const char *kernel_filename,
+                              const char *cache_dir);
+
 /* arm_boot.c */
 struct arm_boot_info {
     uint64_t ram_size;
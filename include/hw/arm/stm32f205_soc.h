@@ -31,6 +31,7 @@
 #include "hw/adc/stm32f2xx_adc.h"
 #include "hw/or-irq.h"
 #include "hw/ssi/stm32f2xx_spi.h"
+#include "hw/nvram/stm32f2xx_flash.h"
 #include "hw/arm/armv7m.h"
 #include "qom/object.h"
 
@@ -54,6 +55,10 @@ struct STM32F205State {
     /*< public >*/
 
     char *cpu_type;
+    char *flash_image;          /* ELF file mapped from flash-cache */
+    char *flash_cache;
+    bool flash_image_loaded;    /* flash_image needs no loading */
+    char *memory_map;           /* JSON file replacing flash and SRAM */
 
     ARMv7MState armv7m;
 
@@ -62,6 +67,7 @@ struct STM32F205State {
     STM32F2XXTimerState timer[STM_NUM_TIMERS];
     STM32F2XXADCState adc[STM_NUM_ADCS];
     STM32F2XXSPIState spi[STM_NUM_SPIS];
+    STM32F2XXFlashState flash;  /* not realized with a cached flash image */
 
     qemu_or_irq *adc_irqs;
 };
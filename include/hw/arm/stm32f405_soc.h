@@ -32,6 +32,7 @@
 #include "hw/misc/stm32f4xx_exti.h"
 #include "hw/or-irq.h"
 #include "hw/ssi/stm32f2xx_spi.h"
+#include "hw/nvram/stm32f2xx_flash.h"
 #include "hw/arm/armv7m.h"
 #include "qom/object.h"
 
@@ -64,9 +65,9 @@ struct STM32F405State {
     qemu_or_irq adc_irqs;
     STM32F2XXADCState adc[STM_NUM_ADCS];
     STM32F2XXSPIState spi[STM_NUM_SPIS];
+    STM32F2XXFlashState flash;
 
     MemoryRegion sram;
-    MemoryRegion flash;
     MemoryRegion flash_alias;
 };
 
@@ -308,6 +308,8 @@ struct MachineState {
     bool usb;
     bool usb_disabled;
     char *firmware;
+    char *flash_cache;
+    char *memory_map;
     bool iommu;
     bool suppress_vmdesc;
     bool enable_graphics;
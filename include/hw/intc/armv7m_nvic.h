@@ -11,6 +11,7 @@
 #define HW_ARM_ARMV7M_NVIC_H
 
 #include "target/arm/cpu.h"
+#include "qemu/bitmap.h"
 #include "hw/sysbus.h"
 #include "hw/timer/armv7m_systick.h"
 #include "qom/object.h"
@@ -64,6 +65,15 @@ struct NVICState {
     /* v8M NVIC_ITNS state (stored as a bool per bit) */
     bool itns[NVIC_MAX_VECTORS];
 
+    /* Exceptions which may be pending or active, so that recomputing the
+     * state only needs to look at these rather than at all num_irq
+     * vectors. Bit n stands for vectors[n] and bit NVIC_MAX_VECTORS + n
+     * for sec_vectors[n]. A set bit is only a hint: bits are set whenever
+     * an exception becomes pending and cleared again by the recompute
+     * once the exception is neither pending nor active.
+     */
+    DECLARE_BITMAP(live, NVIC_MAX_VECTORS + NVIC_INTERNAL_VECTORS);
+
     /* The following fields are all cached state that can be recalculated
      * from the vectors[] and sec_vectors[] arrays and the prigroup field:
      *  - vectpending
@@ -0,0 +1,95 @@
+/*
+ * RH850 interrupt controller (INTC1/INTC2)
+ *
+ * Copyright (c) 2021 iSYSTEM Labs d.o.o.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2 or later, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HW_INTC_RH850_INTC_H
+#define HW_INTC_RH850_INTC_H
+
+#include "hw/sysbus.h"
+#include "qom/object.h"
+
+#define TYPE_RH850_INTC "rh850-intc"
+OBJECT_DECLARE_SIMPLE_TYPE(RH850INTCState, RH850_INTC)
+
+/* Channels 0..31 are handled by INTC1 of each PE, the rest by INTC2 */
+#define RH850_INTC1_NUM_IRQ     32
+#define RH850_INTC_MAX_IRQ      512
+#define RH850_INTC_NUM_PRIO     16
+#define RH850_INTC_MAX_PE       4
+
+/*
+ * RH850INTCPEState: the part of the controller private to one PE, its
+ * INTC1 channels and the state of all channels requesting EIINT on it.
+ * env->intc of the PE points here.
+ */
+typedef struct RH850INTCPEState {
+    RH850INTCState *intc;
+    int pe;
+
+    MemoryRegion intc1_iomem;
+    qemu_irq irq;
+
+    uint16_t eic1[RH850_INTC1_NUM_IRQ];
+    uint32_t level1;
+
+    /*
+     * Derived state, recomputed on every change by rh850_intc_update():
+     * pending has a bit set for each channel of this PE with EIRF=1 and
+     * EIMK=0 (INTC1 channels in word 0, INTC2 channels bound to this PE
+     * by EIBD in the others), prio_pending has a bit set for each
+     * priority level with at least one pending channel, and prio_irq
+     * holds the lowest pending channel number at each level (the one
+     * which wins arbitration).
+     */
+    uint32_t pending[RH850_INTC_MAX_IRQ / 32];
+    uint32_t prio_pending;
+    uint16_t prio_irq[RH850_INTC_NUM_PRIO];
+} RH850INTCPEState;
+
+/*
+ * RH850INTCState:
+ * + Unnamed GPIO input lines: interrupt request channels, a rising edge
+ *   sets EIRFn. Lines 0..num-irq-1 are INTC1 channels of the first PE
+ *   and INTC2 channels, INTC1 channel n of PE p > 0 is line
+ *   num-irq + (p - 1) * 32 + n.
+ * + sysbus IRQ p: EIINT request to PE p, asserted while at least one
+ *   unmasked channel of the PE has its request flag set
+ * + sysbus MMIO region 0: INTC1 (EIC0..EIC31, IMR0) of the first PE
+ * + sysbus MMIO region 1: INTC2 (EIC32..EICn, IMR1..IMRm, EIBD32..EIBDn)
+ * + sysbus MMIO region 1 + p: INTC1 of PE p > 0
+ * + Property "num-irq": number of interrupt channels
+ * + Property "num-pe": number of PEs
+ */
+struct RH850INTCState {
+    /*< private >*/
+    SysBusDevice parent_obj;
+    /*< public >*/
+
+    MemoryRegion intc2_iomem;
+
+    uint32_t num_irq;
+    uint32_t num_pe;
+
+    /* INTC2 channels, entries below RH850_INTC1_NUM_IRQ are not used */
+    uint16_t eic[RH850_INTC_MAX_IRQ];
+    uint32_t eibd[RH850_INTC_MAX_IRQ];
+    uint32_t level[RH850_INTC_MAX_IRQ / 32];
+
+    RH850INTCPEState pe[RH850_INTC_MAX_PE];
+};
+
+#endif /* HW_INTC_RH850_INTC_H */
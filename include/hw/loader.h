@@ -290,6 +290,34 @@ void rom_transaction_begin(void);
  */
 void rom_transaction_end(bool commit);
 
+/**
+ * load_elf_flash_cached:
+ * @mr: the #MemoryRegion to be initialized as flash
+ * @owner: the object that tracks the region's reference count
+ * @name: name of the region
+ * @base: address of flash in the guest address space
+ * @size: size of flash
+ * @filename: Path of ELF file, which must be loaded entirely into flash
+ * @cache_dir: directory with cached flash images
+ * @bigendian: Expected ELF endianness. 0 for LE otherwise BE
+ * @elf_machine: Expected ELF machine type, see load_elf_ram_sym()
+ * @errp: pointer to Error*, to store an error if it happens
+ *
+ * Initializes @mr as read-only flash, which is mapped from a pre-linked
+ * image of @filename in @cache_dir. The image is named by the hash of the
+ * ELF file and is created on first use, so that later starts don't parse
+ * the ELF file again and all instances running the same file share one
+ * copy of flash in the host page cache. ROM blobs are not registered, as
+ * flash is not writable by the guest and needs no reload on reset.
+ *
+ * Returns true on success. On failure @mr is not initialized, and the
+ * caller should allocate flash and load the ELF file as usual.
+ */
+bool load_elf_flash_cached(MemoryRegion *mr, Object *owner, const char *name,
+                           hwaddr base, uint64_t size, const char *filename,
+                           const char *cache_dir, int big_endian,
+                           int elf_machine, Error **errp);
+
 int rom_copy(uint8_t *dest, hwaddr addr, size_t size);
 void *rom_ptr(hwaddr addr, size_t size);
 /**
@@ -0,0 +1,50 @@
+/*
+ * Board memory map described in a JSON file
+ *
+ * Copyright (c) 2021 iSYSTEM Labs d.o.o.
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+
+#ifndef HW_MEMORY_MAP_H
+#define HW_MEMORY_MAP_H
+
+/**
+ * memory_map_init:
+ * @filename: JSON file with the memory map
+ * @sysmem: container to map regions into, usually get_system_memory()
+ * @errp: pointer to Error*, to store an error if it happens
+ *
+ * Creates flash, RAM and alias regions of a microcontroller as described
+ * in @filename, so that a derivative with a different memory layout needs
+ * no new board code. The file contains an object with member "regions",
+ * which is an array of objects with members:
+ *
+ *  "name"     - unique name of the region, also its RAMBlock name
+ *  "type"     - "flash" (read-only for the guest), "ram" or "alias"
+ *  "base"     - guest address
+ *  "size"     - size of the region, optional for aliases
+ *  "alias"    - for aliases, name of the aliased flash or RAM region
+ *  "offset"   - for aliases, offset in the aliased region, 0 by default
+ *  "priority" - priority of overlapping regions, 0 by default
+ *
+ * Numbers may also be strings, in hex with "0x" prefix or with a size
+ * suffix, for example "0xfedd8000" or "192k". Aliases are views of the
+ * same memory, nothing is copied.
+ *
+ * Example:
+ *   { "regions": [
+ *     { "name": "flash", "type": "flash", "base": "0x8000000",
+ *       "size": "1M" },
+ *     { "name": "flash.alias", "type": "alias", "base": 0,
+ *       "alias": "flash" },
+ *     { "name": "sram", "type": "ram", "base": "0x20000000",
+ *       "size": "128k" } ] }
+ *
+ * Returns true on success.
+ */
+bool memory_map_init(const char *filename, MemoryRegion *sysmem,
+                     Error **errp);
+
+#endif
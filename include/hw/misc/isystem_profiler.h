@@ -0,0 +1,62 @@
+/*
+ * iSYSTEM profiler port
+ *
+ * Copyright (c) 2021 iSYSTEM Labs d.o.o.
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+
+#ifndef HW_MISC_ISYSTEM_PROFILER_H
+#define HW_MISC_ISYSTEM_PROFILER_H
+
+#include "hw/sysbus.h"
+#include "qemu/notify.h"
+#include "qom/object.h"
+
+#define TYPE_ISYSTEM_PROFILER "isystem-profiler"
+OBJECT_DECLARE_SIMPLE_TYPE(ISystemProfilerState, ISYSTEM_PROFILER)
+
+/*
+ * Profiled code calls isystem_profile_write(ID, VAL) of the sample HALs,
+ * which writes 0, (marker | VAL << 2 | ID) and 0 to a GPIO port. Each
+ * write with all marker bits set is an event, which is recorded with the
+ * virtual clock into a ring buffer. When QEMU exits, the buffer is saved
+ * to a file:
+ *
+ *   offset  size  contents
+ *   0       4     "IPRF"
+ *   4       4     version, 1
+ *   8       4     marker
+ *   12      4     number of records n
+ *   16      8     number of older events, which were overwritten
+ *   24      8 * n records, the oldest first: bits 63..16 are the virtual
+ *                 time in ns, bits 15..0 the value written to the port
+ *
+ * All fields are little endian.
+ *
+ * ISystemProfilerState:
+ * + sysbus MMIO region 0: the port data register
+ * + Property "file": name of the file, written at exit
+ * + Property "marker": bits set in event writes, 0xE000 in the GHS HAL and
+ *   0x8000 in the IAR one. The default 0x8000 matches both.
+ * + Property "entries": capacity of the ring buffer
+ */
+struct ISystemProfilerState {
+    /*< private >*/
+    SysBusDevice parent_obj;
+    /*< public >*/
+
+    MemoryRegion iomem;
+    Notifier exit_notifier;
+
+    char *file;
+    uint32_t marker;
+    uint32_t num_entries;
+
+    uint32_t port;
+    uint64_t *entries;
+    uint64_t count;             /* events recorded since QEMU was started */
+};
+
+#endif /* HW_MISC_ISYSTEM_PROFILER_H */
@@ -0,0 +1,46 @@
+/*
+ * STM32F2xx/STM32F4xx flash interface
+ *
+ * Copyright (c) 2021 iSYSTEM Labs d.o.o.
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+
+#ifndef HW_STM32F2XX_FLASH_H
+#define HW_STM32F2XX_FLASH_H
+
+#include "hw/sysbus.h"
+#include "qom/object.h"
+
+#define TYPE_STM32F2XX_FLASH "stm32f2xx-flash"
+OBJECT_DECLARE_SIMPLE_TYPE(STM32F2XXFlashState, STM32F2XX_FLASH)
+
+#define STM32F2XX_FLASH_REGS_SIZE 0x400
+
+/*
+ * The device has two MMIO regions: 0 is the register block, 1 is the flash
+ * memory itself. Flash is read and executed as ROM, while CPU writes to it
+ * are programming operations, accepted only when FLASH_CR.PG is set.
+ */
+struct STM32F2XXFlashState {
+    /* <private> */
+    SysBusDevice parent_obj;
+
+    /* <public> */
+    MemoryRegion mmio;
+    MemoryRegion flash;
+    qemu_irq irq;
+
+    uint32_t flash_size;
+    uint8_t *storage;
+
+    uint32_t acr;
+    uint32_t sr;
+    uint32_t cr;
+    uint32_t optcr;
+    uint8_t key_state;
+    uint8_t optkey_state;
+};
+
+#endif /* HW_STM32F2XX_FLASH_H */
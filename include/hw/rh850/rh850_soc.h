@@ -2,35 +2,45 @@
 
 #include "hw/sysbus.h"
 #include "target/rh850/cpu.h"
+#include "hw/intc/rh850_intc.h"
+#include "hw/timer/rh850_ostm.h"
 #include "hw/rh850/rh850_soc.h"
 
 #define TYPE_RH850_SOC "rh850_soc"
 #define RH850_SOC(obj) OBJECT_CHECK(RH850_SOC_State, (obj), TYPE_RH850_SOC)
 
+#define RH850_SOC_MAX_PES RH850_INTC_MAX_PE
+
 /* RH850_SOC container object.
- * + Unnamed GPIO input lines: external IRQ lines for the NVIC
- * + Named GPIO output SYSRESETREQ: signalled for guest AIRCR.SYSRESETREQ
+ * + Unnamed GPIO input lines: interrupt channels of the INTC
  * + Property "cpu-type": CPU type to instantiate
- * + Property "num-irq": number of external IRQ lines
+ * + Property "num-irq": number of INTC channels
+ * + Property "num-pes": number of PEs (CPU cores)
+ * + Property "lram-size": size of local RAM of each PE, 0 for none
  * + Property "memory": MemoryRegion defining the physical address space
- *   that CPU accesses see. (The NVIC, bitbanding and other CPU-internal
- *   devices will be automatically layered on top of this view.)
- * + Property "idau": IDAU interface (forwarded to CPU object)
- * + Property "init-svtor": secure VTOR reset value (forwarded to CPU object)
+ *   that CPU accesses see.
  */
 typedef struct RH850_SOC_State {
     /*< private >*/
     SysBusDevice parent_obj;
     /*< public >*/
-    RH850CPU *cpu;
+    RH850CPU *cpu[RH850_SOC_MAX_PES];
+    RH850INTCState intc;
+    RH850OSTMState ostm;
 
-    /* MemoryRegion we pass to the CPU, with our devices layered on
-     * top of the ones the board provides in board_memory.
+    /* MemoryRegion we pass to each PE, with its INTC1 and the self area
+     * of its local RAM layered on top of the ones the board provides in
+     * board_memory.
      */
-    MemoryRegion container;
+    MemoryRegion container[RH850_SOC_MAX_PES];
+    MemoryRegion board_alias[RH850_SOC_MAX_PES];
+    MemoryRegion lram[RH850_SOC_MAX_PES];
+    MemoryRegion lram_self[RH850_SOC_MAX_PES];
 
     /* Properties */
     char *cpu_type;
+    uint32_t num_pes;
+    uint32_t lram_size;
     /* MemoryRegion the board provides to us (with its devices, RAM, etc) */
     MemoryRegion *board_memory;
 } RH850_SOC_State;
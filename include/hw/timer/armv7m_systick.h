@@ -14,7 +14,7 @@
 
 #include "hw/sysbus.h"
 #include "qom/object.h"
-#include "hw/ptimer.h"
+#include "qemu/timer.h"
 
 #define TYPE_SYSTICK "armv7m_systick"
 
@@ -27,8 +27,10 @@ struct SysTickState {
 
     uint32_t control;
     uint32_t reload;
+    uint32_t count;     /* SYST_CVR at time tick, if enabled */
     int64_t tick;
-    ptimer_state *ptimer;
+    int64_t period;     /* ns per clock */
+    QEMUTimer *timer;
     MemoryRegion iomem;
     qemu_irq irq;
 };
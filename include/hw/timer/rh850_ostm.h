@@ -0,0 +1,63 @@
+/*
+ * RH850 OS timer (OSTM)
+ *
+ * Copyright (c) 2021 iSYSTEM Labs d.o.o.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2 or later, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HW_TIMER_RH850_OSTM_H
+#define HW_TIMER_RH850_OSTM_H
+
+#include "qemu/timer.h"
+#include "hw/sysbus.h"
+#include "qom/object.h"
+
+#define TYPE_RH850_OSTM "rh850-ostm"
+OBJECT_DECLARE_SIMPLE_TYPE(RH850OSTMState, RH850_OSTM)
+
+/*
+ * RH850OSTMState:
+ * + sysbus IRQ 0: INTOSTMn, pulsed on underflow (interval mode) or
+ *   compare match (free-run mode)
+ * + sysbus MMIO region 0: OSTMn registers
+ * + Property "clock-frequency": frequency of the count clock in Hz
+ */
+struct RH850OSTMState {
+    /*< private >*/
+    SysBusDevice parent_obj;
+    /*< public >*/
+
+    MemoryRegion iomem;
+    QEMUTimer timer;
+    qemu_irq irq;
+
+    uint64_t freq;
+
+    uint32_t cmp;
+    uint8_t te;
+    uint8_t to;
+    uint8_t toe;
+    uint8_t ctl;
+
+    /*
+     * The counter is not stored while counting. It is derived from the
+     * virtual clock: cnt holds the counter value at time tick, and the
+     * timer is armed only for the next underflow or compare match, so
+     * an idle guest costs nothing between interrupts.
+     */
+    uint32_t cnt;
+    int64_t tick;
+};
+
+#endif /* HW_TIMER_RH850_OSTM_H */
@@ -76,7 +76,6 @@ struct STM32F2XXTimerState {
     qemu_irq irq;
 
     int64_t tick_offset;
-    uint64_t hit_time;
     uint64_t freq_hz;
 
     uint32_t tim_cr1;
@@ -88,6 +87,7 @@ struct STM32F2XXTimerState {
     uint32_t tim_ccmr1;
     uint32_t tim_ccmr2;
     uint32_t tim_ccer;
+    uint32_t tim_cnt; /* counter value while CEN is clear */
     uint32_t tim_psc;
     uint32_t tim_arr;
     uint32_t tim_ccr1;
@@ -197,6 +197,10 @@ typedef uint64_t TCGRegSet;
 #else
 #define TCG_TARGET_MAYBE_vec            1
 #endif
+
+#ifndef TCG_TARGET_HAS_tb_reloc
+#define TCG_TARGET_HAS_tb_reloc         0
+#endif
 #ifndef TCG_TARGET_HAS_v64
 #define TCG_TARGET_HAS_v64              0
 #endif
@@ -533,6 +537,24 @@ typedef struct TCGProfile {
     int64_t table_op_count[NB_OPS];
 } TCGProfile;
 
+/*
+ * Host addresses outside of the current TB, which are referenced by its code.
+ * Backends with TCG_TARGET_HAS_tb_reloc record them, so that the persistent
+ * TB cache can relocate the code when it is loaded by another process.
+ */
+typedef enum TCGTBRelocType {
+    TCG_TB_RELOC_PC32,          /* 32-bit displacement from the field end */
+    TCG_TB_RELOC_ABS64,         /* 64-bit absolute address */
+} TCGTBRelocType;
+
+typedef struct TCGTBReloc {
+    uint32_t offset;            /* of the field from the start of TB code */
+    TCGTBRelocType type;
+    const void *target;
+} TCGTBReloc;
+
+#define TCG_MAX_TB_RELOCS 128
+
 struct TCGContext {
     uint8_t *pool_cur, *pool_end;
     TCGPool *pool_first, *pool_current, *pool_first_large;
@@ -623,6 +645,12 @@ struct TCGContext {
     uint16_t gen_insn_end_off[TCG_MAX_INSNS];
     target_ulong gen_insn_data[TCG_MAX_INSNS][TARGET_INSN_START_WORDS];
 
+    /* Relocations of the current TB, recorded if tb_reloc is set */
+    bool tb_reloc;
+    bool tb_reloc_failed;       /* code refers to an unrecorded address */
+    int nb_tb_relocs;
+    TCGTBReloc tb_relocs[TCG_MAX_TB_RELOCS];
+
     /* Exit to translator on overflow. */
     sigjmp_buf jmp_trans;
 };
@@ -1147,6 +1175,40 @@ static inline size_t tcg_current_code_size(TCGContext *s)
     return tcg_ptr_byte_diff(s->code_ptr, s->code_buf);
 }
 
+/**
+ * tcg_tb_reloc_add
+ * @s: the tcg context
+ * @field: the field in the code buffer which refers to @target
+ * @type: how the field encodes @target
+ * @target: host address
+ *
+ * Record a host address in the code of the current TB, if relocations
+ * are recorded for it.  Branches within the TB need no relocation.
+ */
+
+static inline void tcg_tb_reloc_add(TCGContext *s, const tcg_insn_unit *field,
+                                    TCGTBRelocType type, const void *target)
+{
+    TCGTBReloc *r;
+
+    if (!s->tb_reloc) {
+        return;
+    }
+    if (type == TCG_TB_RELOC_PC32 &&
+        target >= tcg_splitwx_to_rx(s->code_buf) &&
+        target <= tcg_splitwx_to_rx(s->code_ptr)) {
+        return;
+    }
+    if (s->nb_tb_relocs == TCG_MAX_TB_RELOCS) {
+        s->tb_reloc_failed = true;
+        return;
+    }
+    r = &s->tb_relocs[s->nb_tb_relocs++];
+    r->offset = tcg_ptr_byte_diff(field, s->code_buf);
+    r->type = type;
+    r->target = target;
+}
+
 /* Combine the MemOp and mmu_idx parameters into a single value.  */
 typedef uint32_t TCGMemOpIdx;
 
@@ -17,25 +17,21 @@
 
 #define NecAdrToSymbol(A) StandardAdrToSymbol(A, maPhysicalV850, 4)
 
-CDisassemblerNEC850 *p = NULL;
-
-void disasm_wrap(char *buf, size_t buflen, uint64_t pc, uint64_t inst, int insLen)
+// Each thread has its own engine, as vCPUs translate in parallel. It is
+// destroyed when the thread exits.
+int disasm_wrap(char *buf, size_t buflen, const uint8_t *insn, int avail)
 {
+	static thread_local CDisassemblerNEC850 engine;
 	jstring rjstrDasm;
 	BYTE instr[8];
+	int len;
 
-	if (!p)
-		p = new CDisassemblerNEC850();
-
-	for ( int i=0; i<8; i++)
-		instr[i] = 0;
-	for ( int i=0; i<insLen; i++)
-		instr[i] = (inst >> (8*i)) & 0x0FF;
-
-	p->Disasm( instr, rjstrDasm, buflen);
-	//printf("%s\n", rjstrDasm.c_str());
-	strcpy( buf, rjstrDasm.c_str());
+	memset(instr, 0, sizeof(instr));
+	memcpy(instr, insn, avail < 8 ? avail : 8);
 
+	len = engine.Disasm(instr, rjstrDasm, avail);
+	snprintf(buf, buflen, "%s", len ? rjstrDasm.c_str() : "");
+	return len;
 }
 
 void SignExtend(LONG & lDisp, uint8_t n)
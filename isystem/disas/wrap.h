@@ -10,7 +10,11 @@
 extern "C" {
 #endif
 
-void disasm_wrap(char *buf, size_t buflen, uint64_t pc, uint64_t inst, int insLen);
+/*
+ * Disassembles the instruction at insn, of which avail bytes are valid.
+ * Returns its length, or 0 if it is not a valid instruction.
+ */
+int disasm_wrap(char *buf, size_t buflen, const uint8_t *insn, int avail);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,77 @@
+.text
+
+# This test runs a motor-control style loop to test FPU performance: Clarke
+# and Park transforms, two PI controllers with output limits and conversion
+# of the result to PWM compare value. All values stay in registers, so the
+# run time is dominated by FPU instructions.
+# Build with -mv850e3v5 (FPU instructions).
+
+    mov 0x00010020, r1      # PSW.CU0 - FPU enabled, interrupts disabled
+    ldsr r1, psw
+
+    mov 0x3F000000, r10     # ia = 0.5
+    mov 0xBE800000, r11     # ib = -0.25
+    mov 0x3F000000, r12     # sin(theta) = 0.5
+    mov 0x3F5DB3D7, r13     # cos(theta) = 0.866
+    mov 0x00000000, r14     # id_ref = 0.0
+    mov 0x3F400000, r15     # iq_ref = 0.75
+    mov 0x3DCCCCCD, r16     # kp = 0.1
+    mov 0x3C23D70A, r17     # ki = 0.01
+    mov 0x00000000, r18     # id integrator
+    mov 0x00000000, r19     # iq integrator
+    mov 0x3F13CD3A, r20     # 1 / sqrt(3)
+    mov 0x3F733333, r21     # +0.95 output limit
+    mov 0xBF733333, r22     # -0.95 output limit
+    mov 0x447A0000, r23     # PWM period 1000.0
+    mov 0x3A83126F, r24     # theta step 0.001
+
+    mov 0x0400000, r7
+    mov 0, r6
+
+lbl:
+    # Clarke: alpha = ia, beta = (ia + 2 * ib) / sqrt(3)
+    addf.s r11, r11, r25
+    addf.s r10, r25, r25
+    mulf.s r20, r25, r25    # beta
+
+    # Park: d = alpha * cos + beta * sin, q = beta * cos - alpha * sin
+    mulf.s r13, r10, r26
+    fmaf.s r12, r25, r26    # d
+    mulf.s r12, r10, r27
+    fmsf.s r13, r25, r27    # q
+
+    # PI controller for d axis
+    subf.s r26, r14, r28    # err_d = id_ref - d
+    fmaf.s r17, r28, r18    # int_d += ki * err_d
+    mov r18, r29
+    fmaf.s r16, r28, r29    # out_d = int_d + kp * err_d
+    minf.s r21, r29, r29
+    maxf.s r22, r29, r29
+
+    # PI controller for q axis
+    subf.s r27, r15, r28    # err_q = iq_ref - q
+    fmaf.s r17, r28, r19    # int_q += ki * err_q
+    mov r19, r9
+    fmaf.s r16, r28, r9     # out_q = int_q + kp * err_q
+    minf.s r21, r9, r9
+    maxf.s r22, r9, r9
+
+    # anti windup - reset q integrator when the output saturates
+    cmpf.s eq, r9, r21, 1
+    cmovf.s 1, r0, r19, r19
+
+    # duty cycles
+    mulf.s r23, r29, r29
+    mulf.s r23, r9, r9
+    trncf.sw r29, r29
+    trncf.sw r9, r9
+
+    # advance angle, rotate sin/cos by a small step
+    fmaf.s r24, r13, r12    # sin += step * cos
+    fnmsf.s r24, r12, r13   # cos -= step * sin
+
+    addi 1, r6, r6
+    cmp r6, r7
+    bne lbl
+
+    halt
@@ -0,0 +1,31 @@
+.text
+
+# This test measures interrupt entry and return. It requests EIINT on INTC
+# channel 5 by setting EIRF5 in a loop, handler counts interrupts in r20.
+# Handler uses direct vector method with priority 7, RBASE = 0.
+
+    jr start
+
+    .org 0x170              # RBASE + 0x100 + priority * 0x10
+    addi 1, r20, r20
+    eiret
+
+    .org 0x200
+start:
+    mov 0xfffeea0a, r10     # EIC5, INTC1 base + 2 * 5
+    mov 0x0007, r11         # EIMK5 = 0, EIP5 = 7
+    st.h r11, 0[r10]
+    mov 0x1007, r12         # EIRF5 = 1, EIMK5 = 0, EIP5 = 7
+    mov 0, r20
+    ei
+
+    mov 0x0400000, r7
+    mov 0, r6
+
+lbl:
+    st.h r12, 0[r10]
+    addi 1, r6, r6
+    cmp r6, r7
+    bne lbl
+
+    halt
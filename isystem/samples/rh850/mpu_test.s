@@ -0,0 +1,66 @@
+.text
+
+# This test measures loads and stores in user mode with MPU enabled. Region 0
+# allows execution of code, region 1 allows access to 4 KiB of RAM, and
+# region 2 ends in the middle of the next RAM page, so that page is checked
+# on every access. The final store is outside of all regions and must raise
+# MDP, which halts with FEIC (0x91) in r21 and MEA in r22.
+
+    jr start
+
+    .org 0x90               # RBASE + 0x90, MIP and MDP
+    stsr 14, r21, 0         # FEIC
+    stsr 6, r22, 2          # MEA
+    halt
+
+    .org 0x200
+start:
+    mov 0x00000000, r10     # region 0: code, SX | UX | SR | UR
+    ldsr r10, 0, 6          # MPLA0
+    mov 0x0000fffc, r10
+    ldsr r10, 1, 6          # MPUA0
+    mov 0x000000ed, r10     # E | G | SX | SR | UX | UR
+    ldsr r10, 2, 6          # MPAT0
+
+    mov 0xfede0000, r10     # region 1: RAM, one page
+    ldsr r10, 4, 6          # MPLA1
+    mov 0xfede0ffc, r10
+    ldsr r10, 5, 6          # MPUA1
+    mov 0x000000db, r10     # E | G | SW | SR | UW | UR
+    ldsr r10, 6, 6          # MPAT1
+
+    mov 0xfede1000, r10     # region 2: half of the next page
+    ldsr r10, 8, 6          # MPLA2
+    mov 0xfede17fc, r10
+    ldsr r10, 9, 6          # MPUA2
+    mov 0x000000db, r10
+    ldsr r10, 10, 6         # MPAT2
+
+    mov 3, r10              # MPE | SVP
+    ldsr r10, 0, 5          # MPM
+
+    mov user, r10           # enter user mode with FERET
+    ldsr r10, 2, 0          # FEPC
+    mov 0x40000020, r10     # PSW.UM | PSW.ID
+    ldsr r10, 3, 0          # FEPSW
+    feret
+
+user:
+    mov 0xfede0000, r10
+    mov 0xfede1000, r11
+    mov 0x0400000, r7
+    mov 0, r6
+
+lbl:
+    ld.w 0[r10], r12
+    addi 1, r12, r12
+    st.w r12, 0[r10]
+    ld.w 0x100[r11], r13
+    addi 1, r13, r13
+    st.w r13, 0x100[r11]
+    addi 1, r6, r6
+    cmp r6, r7
+    bne lbl
+
+    st.w r12, 0x800[r11]    # outside of region 2, raises MDP
+    halt
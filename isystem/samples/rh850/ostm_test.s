@@ -0,0 +1,41 @@
+.text
+
+# This test lets OSTM0 run in interval mode and waits for its interrupts in
+# HALT. Handler counts interrupts in r20, the test ends after 1000 of them.
+# With 40 MHz count clock and CMP = 39999 the interrupt period is 1 ms, so
+# the test spends 1 s of virtual time, most of it in HALT.
+# Handler uses direct vector method with priority 7, RBASE = 0.
+
+    jr start
+
+    .org 0x170              # RBASE + 0x100 + priority * 0x10
+    addi 1, r20, r20
+    eiret
+
+    .org 0x200
+start:
+    mov 0xffffb0a8, r10     # EIC84 (INTOSTM0), INTC2 base + 2 * 84
+    mov 0x0007, r11         # EIMK84 = 0, EIP84 = 7
+    st.h r11, 0[r10]
+
+    mov 0xffd70000, r10     # OSTM0 base
+    mov 0, r11
+    st.b r11, 0x20[r10]     # CTL: interval mode, no interrupt at start
+    mov 39999, r11
+    st.w r11, 0x00[r10]     # CMP
+    mov 1, r11
+    st.b r11, 0x14[r10]     # TS - start counting
+
+    mov 0, r20
+    mov 1000, r7
+    ei
+
+lbl:
+    halt
+    cmp r20, r7
+    bne lbl
+
+    mov 1, r11
+    st.b r11, 0x18[r10]     # TT - stop counting
+    di
+    halt
@@ -0,0 +1,46 @@
+.text
+
+# This test prints a message and writes it to file 'semihosting.txt' with
+# semihosting, then exits QEMU. Run it with -semihosting. Parameters of
+# SYS_WRITE and SYS_CLOSE are stored to RAM, as they contain the file handle.
+
+    jr start
+
+    .org 0x200
+start:
+    mov 4, r6               # SYS_WRITE0
+    mov msg, r7
+    dbtrap
+
+    mov 1, r6               # SYS_OPEN
+    mov open_args, r7
+    dbtrap
+
+    mov 0xfede0000, r11     # handle, buffer and length
+    st.w r10, 0[r11]
+    mov msg, r12
+    st.w r12, 4[r11]
+    mov 13, r12
+    st.w r12, 8[r11]
+
+    mov 5, r6               # SYS_WRITE
+    mov r11, r7
+    dbtrap
+
+    mov 2, r6               # SYS_CLOSE
+    mov r11, r7
+    dbtrap
+
+    mov 0x18, r6            # SYS_EXIT
+    mov 0x20026, r7         # ADP_Stopped_ApplicationExit
+    dbtrap
+    halt
+
+    .align 2
+open_args:
+    .word fname, 4, 15      # mode "w", length of name
+
+msg:
+    .asciz "semihosting!\n"
+fname:
+    .asciz "semihosting.txt"
@@ -0,0 +1,39 @@
+.text
+
+# This test checks LDL.W/STC.W on a multicore machine, run it with -smp 2.
+# Both PEs start at the reset vector and add 1 to a counter in global RAM
+# 0x100000 times each. The PE with HTCFG0.PEID = 1 then waits until the
+# counter reaches 0x200000, so a lost update makes it spin forever.
+
+    jr start
+
+    .org 0x200
+start:
+    mov 0xfedd8000, r10     # shared counter, below the local RAM self area
+    mov 0x100000, r7
+    mov 0, r6
+
+lbl:
+    ldl.w [r10], r11
+    addi 1, r11, r11
+    stc.w r11, [r10]        # r11 = 1 on success
+    cmp 0, r11
+    be lbl
+    addi 1, r6, r6
+    cmp r6, r7
+    bne lbl
+
+    stsr 0, r12, 2          # HTCFG0
+    shr 16, r12
+    andi 7, r12, r12        # PEID
+    cmp 1, r12
+    bne done
+
+    mov 0x200000, r7
+wait:
+    ld.w 0[r10], r11
+    cmp r11, r7
+    bne wait
+
+done:
+    halt
@@ -55,6 +55,7 @@
 #include "qemu/main-loop.h"
 #include "block/snapshot.h"
 #include "qemu/cutils.h"
+#include "qemu/units.h"
 #include "io/channel-buffer.h"
 #include "io/channel-file.h"
 #include "sysemu/replay.h"
@@ -2980,6 +2981,113 @@ void qmp_xen_load_devices_state(const char *filename, Error **errp)
     migration_incoming_state_destroy();
 }
 
+/*
+ * VM state saved by x-snapshot-save-memory. Unlike savevm, it doesn't need
+ * a block device, which embedded boards usually don't have, and it is
+ * restored without any file I/O.
+ */
+#define MEMORY_SNAPSHOT_BASE_SIZE (4 * MiB)
+
+static uint8_t *memory_snapshot;
+static size_t memory_snapshot_size;
+
+void qmp_x_snapshot_save_memory(Error **errp)
+{
+    QIOChannelBuffer *bioc;
+    QEMUFile *f;
+    int saved_vm_running;
+    int ret;
+
+    if (migration_is_blocked(errp)) {
+        return;
+    }
+
+    if (!replay_can_snapshot()) {
+        error_setg(errp, "Record/replay does not allow making snapshot "
+                   "right now. Try once more later.");
+        return;
+    }
+
+    saved_vm_running = runstate_is_running();
+
+    if (global_state_store()) {
+        error_setg(errp, "Error saving global state");
+        return;
+    }
+    vm_stop(RUN_STATE_SAVE_VM);
+
+    bioc = qio_channel_buffer_new(MEMORY_SNAPSHOT_BASE_SIZE);
+    qio_channel_set_name(QIO_CHANNEL(bioc), "migration-memory-snapshot");
+    f = qemu_fopen_channel_output(QIO_CHANNEL(bioc));
+    ret = qemu_savevm_state(f, errp);
+    qemu_fflush(f);
+    if (ret == 0) {
+        /* Take over the buffer, so that closing the channel doesn't free it */
+        g_free(memory_snapshot);
+        memory_snapshot = bioc->data;
+        memory_snapshot_size = bioc->usage;
+        bioc->data = NULL;
+        bioc->capacity = bioc->usage = bioc->offset = 0;
+    }
+    qemu_fclose(f);
+    object_unref(OBJECT(bioc));
+
+    if (saved_vm_running) {
+        vm_start();
+    }
+}
+
+void qmp_x_snapshot_load_memory(Error **errp)
+{
+    MigrationIncomingState *mis = migration_incoming_get_current();
+    QIOChannelBuffer *bioc;
+    QEMUFile *f;
+    int saved_vm_running;
+    int ret;
+
+    if (!memory_snapshot) {
+        error_setg(errp, "No snapshot was saved with x-snapshot-save-memory");
+        return;
+    }
+
+    saved_vm_running = runstate_is_running();
+    vm_stop(RUN_STATE_RESTORE_VM);
+
+    /*
+     * Flush the record/replay queue. Now the VM state is going
+     * to change. Therefore we don't need to preserve its consistency
+     */
+    replay_flush_events();
+
+    /* Loading consumes the buffer, so the snapshot is kept for next time */
+    bioc = qio_channel_buffer_new(memory_snapshot_size);
+    memcpy(bioc->data, memory_snapshot, memory_snapshot_size);
+    bioc->usage = memory_snapshot_size;
+    qio_channel_set_name(QIO_CHANNEL(bioc), "migration-memory-snapshot");
+    f = qemu_fopen_channel_input(QIO_CHANNEL(bioc));
+    object_unref(OBJECT(bioc));
+
+    qemu_system_reset(SHUTDOWN_CAUSE_NONE);
+    mis->from_src_file = f;
+
+    if (!yank_register_instance(MIGRATION_YANK_INSTANCE, errp)) {
+        qemu_fclose(f);
+        mis->from_src_file = NULL;
+        return;
+    }
+    ret = qemu_loadvm_state(f);
+    migration_incoming_state_destroy();
+
+    if (ret < 0) {
+        error_setg(errp, "Error %d while loading VM state", ret);
+        return;
+    }
+
+    if (saved_vm_running) {
+        vm_start();
+    }
+}
+
 bool load_snapshot(const char *name, const char *vmstate,
                    bool has_devices, strList *devices, Error **errp)
 {
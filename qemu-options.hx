@@ -36,7 +36,9 @@ DEF("machine", HAS_ARG, QEMU_OPTION_machine, \
     "                nvdimm=on|off controls NVDIMM support (default=off)\n"
     "                memory-encryption=@var{} memory encryption object to use (default=none)\n"
     "                hmat=on|off controls ACPI HMAT support (default=off)\n"
-    "                memory-backend='backend-id' specifies explicitly provided backend for main RAM (default=none)\n",
+    "                memory-backend='backend-id' specifies explicitly provided backend for main RAM (default=none)\n"
+    "                flash-cache=dir maps flash from images of -kernel cached in dir (default=none)\n"
+    "                memory-map=file creates flash, RAM and aliases described in JSON file (default=none)\n",
     QEMU_ARCH_ALL)
 SRST
 ``-machine [type=]name[,prop=value[,...]]``
@@ -120,6 +122,36 @@ SRST
         -object memory-backend-ram,id=pc.ram,size=512M,x-use-canonical-path-for-ramblock-id=off
         -machine memory-backend=pc.ram
         -m 512M
+
+    ``flash-cache=dir``
+        On microcontroller boards which load ``-kernel`` into flash
+        (rh850mini, lm3s6965evb, lm3s811evb and netduino2), flash is
+        mapped read-only from an image of the ELF file in directory
+        ``dir``. The image is named by the hash of the ELF file and is
+        created on the first start, later starts only map it and all
+        instances running the same file share one copy of flash in the
+        host page cache. If the ELF file also loads outside of flash,
+        the board falls back to loading it as usual.
+
+    ``memory-map=file``
+        On microcontroller boards (rh850mini, lm3s6965evb, lm3s811evb
+        and netduino2), flash, RAM and their aliases are created as
+        described in JSON file ``file`` instead of the board's default
+        layout and the ``-flash`` and ``-ram`` options. Aliases map the
+        same memory at another address, nothing is copied. The format is
+        described in ``include/hw/memory-map.h``, for example:
+
+        ::
+
+            { "regions": [
+              { "name": "flash", "type": "flash", "base": "0x8000000",
+                "size": "1M" },
+              { "name": "flash.alias", "type": "alias", "base": 0,
+                "alias": "flash" },
+              { "name": "sram", "type": "ram", "base": "0x20000000",
+                "size": "128k" } ] }
+
+        ``flash-cache`` is not used with a memory map.
 ERST
 
 HXCOMM Deprecated by -machine
@@ -141,6 +173,7 @@ DEF("accel", HAS_ARG, QEMU_OPTION_accel,
     "                kvm-shadow-mem=size of KVM shadow MMU in bytes\n"
     "                split-wx=on|off (enable TCG split w^x mapping)\n"
     "                tb-size=n (TCG translation block cache size)\n"
+    "                tb-cache=dir (persistent cache of TCG code translated from ROM)\n"
     "                dirty-ring-size=n (KVM dirty ring GFN count, default 0)\n"
     "                thread=single|multi (enable multi-threaded TCG)\n", QEMU_ARCH_ALL)
 SRST
@@ -175,6 +208,17 @@ SRST
     ``tb-size=n``
         Controls the size (in MiB) of the TCG translation block cache.
 
+    ``tb-cache=dir``
+        Saves host code translated from ROM into a file in directory
+        ``dir`` when QEMU exits, and loads it in the next run instead of
+        translating the same guest code again. The file is specific to the
+        QEMU executable, the host CPU, the guest CPU configuration and the
+        contents of ROM. Runs which share ``dir`` merge their code into the
+        file, and only the 16 most recently used files are kept. Code
+        is not loaded from the cache while breakpoints are set or
+        single-stepping. This option is only available on x86-64 Linux
+        hosts.
+
     ``thread=single|multi``
         Controls number of TCG threads. When the TCG is multi-threaded
         there will be one thread per vCPU therefore taking advantage of
@@ -4426,10 +4470,11 @@ ERST
 DEF("semihosting", 0, QEMU_OPTION_semihosting,
     "-semihosting    semihosting mode\n",
     QEMU_ARCH_ARM | QEMU_ARCH_M68K | QEMU_ARCH_XTENSA |
-    QEMU_ARCH_MIPS | QEMU_ARCH_NIOS2 | QEMU_ARCH_RISCV)
+    QEMU_ARCH_MIPS | QEMU_ARCH_NIOS2 | QEMU_ARCH_RISCV | QEMU_ARCH_RH850)
 SRST
 ``-semihosting``
-    Enable semihosting mode (ARM, M68K, Xtensa, MIPS, Nios II, RISC-V only).
+    Enable semihosting mode (ARM, M68K, Xtensa, MIPS, Nios II, RISC-V, RH850
+    only).
 
     Note that this allows guest direct access to the host filesystem, so
     should only be used with a trusted guest OS.
@@ -4441,11 +4486,11 @@ DEF("semihosting-config", HAS_ARG, QEMU_OPTION_semihosting_config,
     "-semihosting-config [enable=on|off][,target=native|gdb|auto][,chardev=id][,arg=str[,...]]\n" \
     "                semihosting configuration\n",
 QEMU_ARCH_ARM | QEMU_ARCH_M68K | QEMU_ARCH_XTENSA |
-QEMU_ARCH_MIPS | QEMU_ARCH_NIOS2 | QEMU_ARCH_RISCV)
+QEMU_ARCH_MIPS | QEMU_ARCH_NIOS2 | QEMU_ARCH_RISCV | QEMU_ARCH_RH850)
 SRST
 ``-semihosting-config [enable=on|off][,target=native|gdb|auto][,chardev=id][,arg=str[,...]]``
-    Enable and configure semihosting (ARM, M68K, Xtensa, MIPS, Nios II, RISC-V
-    only).
+    Enable and configure semihosting (ARM, M68K, Xtensa, MIPS, Nios II, RISC-V,
+    RH850 only).
 
     Note that this allows guest direct access to the host filesystem, so
     should only be used with a trusted guest OS.
@@ -4461,6 +4506,10 @@ SRST
 
     On RISC-V this implements the standard semihosting API, version 0.2.
 
+    On RH850 the Arm semihosting API is called with the ``DBTRAP``
+    instruction in supervisor mode, with the operation number in r6, the
+    parameter block in r7 and the result in r10.
+
     ``target=native|gdb|auto``
         Defines where the semihosting calls will be addressed, to QEMU
         (``native``) or to GDB (``gdb``). The default is ``auto``, which
@@ -264,6 +264,43 @@ common_semi_rambase(CPUState *cs)
 
 #endif
 
+#ifdef TARGET_RH850
+/* DBTRAP passes the operation in r6 and the parameter block in r7 */
+static inline target_ulong
+common_semi_arg(CPUState *cs, int argno)
+{
+    RH850CPU *cpu = RH850_CPU(cs);
+    CPURH850State *env = &cpu->env;
+    return env->gpRegs[6 + argno];
+}
+
+static inline void
+common_semi_set_ret(CPUState *cs, target_ulong ret)
+{
+    RH850CPU *cpu = RH850_CPU(cs);
+    CPURH850State *env = &cpu->env;
+    env->gpRegs[10] = ret;
+}
+
+static inline bool
+common_semi_sys_exit_extended(CPUState *cs, int nr)
+{
+    return nr == TARGET_SYS_EXIT_EXTENDED;
+}
+
+#ifndef CONFIG_USER_ONLY
+
+static inline target_ulong
+common_semi_rambase(CPUState *cs)
+{
+    RH850CPU *cpu = RH850_CPU(cs);
+    CPURH850State *env = &cpu->env;
+    return common_semi_find_region_base(env->gpRegs[3]);
+}
+#endif
+
+#endif
+
 /*
  * Allocate a new guest file descriptor and return it; if we
  * couldn't allocate a new fd then return -1.
@@ -446,6 +483,12 @@ static target_ulong common_semi_flen_buf(CPUState *cs)
 
     sp = env->gpr[xSP];
 #endif
+#ifdef TARGET_RH850
+    RH850CPU *cpu = RH850_CPU(cs);
+    CPURH850State *env = &cpu->env;
+
+    sp = env->gpRegs[3];
+#endif
 
     return sp - 64;
 }
@@ -776,6 +819,8 @@ static inline bool is_64bit_semihosting(CPUArchState *env)
     return is_a64(env);
 #elif defined(TARGET_RISCV)
     return !riscv_cpu_is_32bit(env);
+#elif defined(TARGET_RH850)
+    return false;
 #else
 #error un-handled architecture
 #endif
@@ -1278,7 +1323,7 @@ target_ulong do_common_semihosting(CPUState *cs)
             return 0;
         }
 #endif
-#ifdef TARGET_RISCV
+#if defined(TARGET_RISCV) || defined(TARGET_RH850)
         return 0;
 #endif
         /* fall through -- invalid for A32/T32 */
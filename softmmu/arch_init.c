@@ -70,6 +70,8 @@ int graphic_depth = 32;
 #define QEMU_ARCH QEMU_ARCH_PPC
 #elif defined(TARGET_RISCV)
 #define QEMU_ARCH QEMU_ARCH_RISCV
+#elif defined(TARGET_RH850)
+#define QEMU_ARCH QEMU_ARCH_RH850
 #elif defined(TARGET_RX)
 #define QEMU_ARCH QEMU_ARCH_RX
 #elif defined(TARGET_S390X)
@@ -20,9 +20,11 @@
 #include "qemu/log.h"
 #include "qemu/qemu-print.h"
 #include "qemu/ctype.h"
+#include "qemu/timer.h"
 #include "cpu.h"
 #include "exec/exec-all.h"
 #include "qapi/error.h"
+#include "hw/qdev-properties.h"
 #include "migration/vmstate.h"
 
 /* RH850 CPU definitions */
@@ -73,7 +75,7 @@ const char * const rh850_sys_regnames[][MAX_SYS_REGS_IN_BANK] = {
   NULL,    NULL,    NULL,     NULL,    "icctrl",NULL,    "iccfg",  NULL,    "icerr", NULL
 },
 { // SELECTION ID 5
-  "mpm",   "mprc",  NULL,     NULL,    "mpbrgn","mptrgn",NULL,     NULL,    "mca",   "mcs"
+  "mpm",   "mprc",  NULL,     NULL,    "mpbrgn","mptrgn",NULL,     NULL,    "mca",   "mcs",
   "mcc",   "mcr"
 },
 { // SELECTION ID 6
@@ -122,13 +124,13 @@ const uint32_t rh850_sys_reg_read_only_masks[][MAX_SYS_REGS_IN_BANK] = {
 	0xFFFFFFFF, 0x0000013F
 },
 {	//SELECTION ID 6
-	0xFFFFFFFC, 0xFFFFFFFC, 0x03FF00FF, 0x0, 		0xFFFFFFFC, 0xFFFFFFFC, 0x03FF00FF, 0x0, 		0xFFFFFFFC, 0xFFFFFFFF,
+	0xFFFFFFFC, 0xFFFFFFFC, 0x03FF00FF, 0x0, 		0xFFFFFFFC, 0xFFFFFFFC, 0x03FF00FF, 0x0, 		0xFFFFFFFC, 0xFFFFFFFC,
 	0x03FF00FF, 0x0, 		0xFFFFFFFC, 0xFFFFFFFC, 0x03FF00FF, 0x0, 		0xFFFFFFFC, 0xFFFFFFFC, 0x03FF00FF, 0x0,
 	0xFFFFFFFC, 0xFFFFFFFC, 0x03FF00FF, 0x0, 		0xFFFFFFFC, 0xFFFFFFFC, 0x03FF00FF, 0x0, 		0xFFFFFFFC, 0xFFFFFFFC,
 	0x03FF00FF, 0x0
 },
 {	//SELECTION ID 7
-	0xFFFFFFFC, 0xFFFFFFFC, 0x03FF00FF, 0x0, 		0xFFFFFFFC, 0xFFFFFFFC, 0x03FF00FF, 0x0, 		0xFFFFFFFC, 0xFFFFFFFF,
+	0xFFFFFFFC, 0xFFFFFFFC, 0x03FF00FF, 0x0, 		0xFFFFFFFC, 0xFFFFFFFC, 0x03FF00FF, 0x0, 		0xFFFFFFFC, 0xFFFFFFFC,
 	0x03FF00FF, 0x0, 		0xFFFFFFFC, 0xFFFFFFFC, 0x03FF00FF, 0x0, 		0xFFFFFFFC, 0xFFFFFFFC, 0x03FF00FF, 0x0,
 	0xFFFFFFFC, 0xFFFFFFFC, 0x03FF00FF, 0x0, 		0xFFFFFFFC, 0xFFFFFFFC, 0x03FF00FF, 0x0, 		0xFFFFFFFC, 0xFFFFFFFC,
 	0x03FF00FF, 0x0
@@ -201,24 +203,19 @@ const char * const rh850_excp_names[] = {
     "exec_page_fault",
     "load_page_fault",
     "reserved",
-    "store_page_fault"
+    "store_page_fault",
+    "fpu_exception",
+    "reserved_instruction",
+    "coprocessor_unusable",
+    "mip",
+    "mdp",
+    "semihost"
 };
 
 const char * const rh850_intr_names[] = {
-    "u_software",
-    "s_software",
-    "h_software",
-    "m_software",
-    "u_timer",
-    "s_timer",
-    "h_timer",
-    "m_timer",
-    "u_external",
-    "s_external",
-    "h_external",
-    "m_external",
-    "coprocessor",
-    "host"
+    "eiint",
+    "feint",
+    "fenmi"
 };
 
 typedef struct RH850CPUInfo {
@@ -386,6 +383,10 @@ static void rh850_cpu_dump_state(CPUState *cs, FILE *f, int flags)
 	qemu_fprintf(f, " %s " TARGET_FMT_lx,
 				rh850_sys_databuff_regnames[0], env->sysDatabuffRegs[0]);
 	qemu_fprintf(f, "\n");
+
+    if (cpu->cycle_timing) {
+        qemu_fprintf(f, " %-7s %" PRIu64 "\n", "cycles", env->cycles);
+    }
 }
 
 static void rh850_cpu_set_pc(CPUState *cs, vaddr value)
@@ -404,6 +405,9 @@ static bool rh850_tlb_fill(CPUState *cs, vaddr addr, int size,
     int ret;
     ret = rh850_cpu_handle_mmu_fault(cs, addr, size, access_type, mmu_idx);
     if (ret == TRANSLATE_FAIL) {
+        if (probe) {
+            return false;
+        }
         RH850CPU *cpu = RH850_CPU(cs);
         CPURH850State *env = &cpu->env;
         do_raise_exception_err(env, cs->exception_index, retaddr);
@@ -412,7 +416,8 @@ static bool rh850_tlb_fill(CPUState *cs, vaddr addr, int size,
 }
 
 
-static void rh850_cpu_synchronize_from_tb(CPUState *cs, TranslationBlock *tb)
+static void rh850_cpu_synchronize_from_tb(CPUState *cs,
+                                          const TranslationBlock *tb)
 {
     RH850CPU *cpu = RH850_CPU(cs);
     CPURH850State *env = &cpu->env;
@@ -421,17 +426,28 @@ static void rh850_cpu_synchronize_from_tb(CPUState *cs, TranslationBlock *tb)
 
 static bool rh850_cpu_has_work(CPUState *cs)
 {
-#ifndef CONFIG_USER_ONLY
-    return true;
-#else
-    return true;
-#endif
+    RH850CPU *cpu = RH850_CPU(cs);
+    CPURH850State *env = &cpu->env;
+
+    if (env->snooze_deadline &&
+        qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL) >= env->snooze_deadline) {
+        return true;
+    }
+    return rh850_cpu_has_pending_interrupt(cs);
+}
+
+static void rh850_cpu_snooze_timer_cb(void *opaque)
+{
+    /* the vCPU re-evaluates has_work and leaves SNOOZE */
+    qemu_cpu_kick(CPU(opaque));
 }
 
 void restore_state_to_opc(CPURH850State *env, TranslationBlock *tb,
                           target_ulong *data)
 {
     env->pc = data[0];
+    rh850_cpu_compute_flags(env, data[1]);
+    env->cycles -= data[2];
 }
 
 
@@ -461,10 +477,10 @@ int rh850_gen_dynamic_xml(CPUState *cs)
 
 static const char *rh850_gdb_get_dynamic_xml(CPUState *cs, const char *xmlname)
 {
-    // RH850CPU *cpu = RH850_CPU(cs);
+    RH850CPU *cpu = RH850_CPU(cs);
 
     if (strcmp(xmlname, "system-registers.xml") == 0) {
-        return "rh850-core.xml";
+        return cpu->dyn_sysreg_xml.desc;
     }
     return NULL;
 }
@@ -624,7 +640,8 @@ static void rh850_cpu_reset(DeviceState *dev)
     env->systemRegs[BANK_ID_BASIC_0][CTPSW_IDX] = 0;
     env->systemRegs[BANK_ID_BASIC_0][CTBP_IDX] = 0;   // only bit 0 must be set to 0
     env->systemRegs[BANK_ID_BASIC_2][ASID_IDX2] = 0;   // only bits 31-10 must be set to 0
-    env->systemRegs[BANK_ID_BASIC_2][HTCFG0_IDX2] = 0x00018000;   // const value
+    env->systemRegs[BANK_ID_BASIC_2][HTCFG0_IDX2] =
+        0x00008000 | (cpu->pe_id << HTCFG0_PEID_SHIFT);
     env->systemRegs[BANK_ID_BASIC_2][MEI_IDX2] = 0;    // only some bits must be 0
     env->systemRegs[BANK_ID_BASIC_1][RBASE_IDX1] = 0;
     env->systemRegs[BANK_ID_BASIC_1][EBASE_IDX1] = 0;  // only bits 8-1 must be 0
@@ -640,6 +657,22 @@ static void rh850_cpu_reset(DeviceState *dev)
     env->systemRegs[BANK_ID_BASIC_2][PMR_IDX2] = 0;
     env->systemRegs[BANK_ID_BASIC_2][ICSR_IDX2] = 0;
     env->systemRegs[BANK_ID_BASIC_2][INTCFG_IDX2] = 0;
+
+    env->systemRegs[BANK_ID_BASIC_0][FPEPC_IDX] = 0;
+    cpu_rh850_set_fpsr(env, FPSR_RESET_VALUE);
+
+    // MPU is disabled and all regions have MPATn.E cleared
+    memset(env->systemRegs[BANK_ID_MPU_CTRL], 0,
+           sizeof(env->systemRegs[BANK_ID_MPU_CTRL]));
+    for (int selID = BANK_ID_MPU_REGIONS; selID < NUM_SYS_REG_BANKS; selID++) {
+        memset(env->systemRegs[selID], 0, sizeof(env->systemRegs[selID]));
+    }
+    env->UM_flag = 0;
+    rh850_mpu_update(env);
+
+    env->cycles = 0;
+    env->snooze_deadline = 0;
+    timer_del(env->snooze_timer);
 }
 
 static void rh850_cpu_disas_set_info(CPUState *s, disassemble_info *info)
@@ -663,12 +696,36 @@ static void rh850_cpu_realize(DeviceState *dev, Error **errp)
         return;
     }
 
+    RH850_CPU(dev)->env.snooze_timer =
+        timer_new_ns(QEMU_CLOCK_VIRTUAL, rh850_cpu_snooze_timer_cb, cs);
+
+    rh850_cpu_register_gdb_regs(cs);
+
     qemu_init_vcpu(cs);
     cpu_reset(cs);
 
     mcc->parent_realize(dev, errp);
 }
 
+#ifndef CONFIG_USER_ONLY
+/* GPIO input n requests interrupt cause n, see RH850_INT_* */
+static void rh850_cpu_set_irq(void *opaque, int irq, int level)
+{
+    static const int mask[] = {
+        [RH850_INT_EIINT] = CPU_INTERRUPT_HARD,
+        [RH850_INT_FEINT] = CPU_INTERRUPT_FEINT,
+        [RH850_INT_FENMI] = CPU_INTERRUPT_FENMI,
+    };
+    CPUState *cs = CPU(opaque);
+
+    if (level) {
+        cpu_interrupt(cs, mask[irq]);
+    } else if (irq != RH850_INT_FENMI) {
+        cpu_reset_interrupt(cs, mask[irq]);
+    }
+}
+#endif
+
 static void rh850_cpu_init(Object *obj)
 {
     CPUState *cs = CPU(obj);
@@ -676,11 +733,42 @@ static void rh850_cpu_init(Object *obj)
 
     cpu_set_cpustate_pointers(cpu); // all targets call that
     cs->env_ptr = &cpu->env;
+#ifndef CONFIG_USER_ONLY
+    qdev_init_gpio_in(DEVICE(cpu), rh850_cpu_set_irq, 3);
+#endif
+    object_property_add_uint64_ptr(obj, "cycles", &cpu->env.cycles,
+                                   OBJ_PROP_FLAG_READ);
 }
 
-static const VMStateDescription vmstate_rh850_cpu = {
-    .name = "cpu",
-    .unmigratable = 1,
+#ifndef CONFIG_USER_ONLY
+#include "hw/core/sysemu-cpu-ops.h"
+
+static const struct SysemuCPUOps rh850_sysemu_ops = {
+    .get_phys_page_debug = rh850_cpu_get_phys_page_debug,
+    .legacy_vmsd = &vmstate_rh850_cpu,
+};
+#endif
+
+#include "hw/core/tcg-cpu-ops.h"
+
+static const struct TCGCPUOps rh850_tcg_ops = {
+    .initialize = rh850_translate_init,
+    .synchronize_from_tb = rh850_cpu_synchronize_from_tb,
+    .cpu_exec_interrupt = rh850_cpu_exec_interrupt,
+    .tlb_fill = rh850_tlb_fill,
+    .debug_excp_handler = rh850_debug_excp_handler,
+    .debug_check_watchpoint = rh850_debug_check_watchpoint,
+
+#ifndef CONFIG_USER_ONLY
+    .do_interrupt = rh850_cpu_do_interrupt,
+    .do_unaligned_access = rh850_cpu_do_unaligned_access,
+#endif /* !CONFIG_USER_ONLY */
+};
+
+static Property rh850_cpu_properties[] = {
+    DEFINE_PROP_UINT32("pe-id", RH850CPU, pe_id, 1),
+    DEFINE_PROP_BOOL("cycle-timing", RH850CPU, cycle_timing, false),
+    DEFINE_PROP_END_OF_LIST(),
 };
 
 static void rh850_cpu_class_init(ObjectClass *c, void *data)
@@ -696,12 +784,8 @@ static void rh850_cpu_class_init(ObjectClass *c, void *data)
 
     cc->class_by_name = rh850_cpu_class_by_name;
     cc->has_work = rh850_cpu_has_work;
-    cc->do_interrupt = rh850_cpu_do_interrupt;
-    cc->cpu_exec_interrupt = rh850_cpu_exec_interrupt;
     cc->dump_state = rh850_cpu_dump_state;
     cc->set_pc = rh850_cpu_set_pc;
-    cc->tlb_fill = rh850_tlb_fill;
-    cc->synchronize_from_tb = rh850_cpu_synchronize_from_tb;
     cc->gdb_read_register = rh850_cpu_gdb_read_register;
     cc->gdb_write_register = rh850_cpu_gdb_write_register;
     // see rh850/gdbstub.c:: rh850_cpu_gdb_read_register for number of regs supported for gdb
@@ -712,25 +796,15 @@ static void rh850_cpu_class_init(ObjectClass *c, void *data)
     cc->gdb_core_xml_file = "rh850-core.xml";
     cc->gdb_arch_name = rh850_gdb_arch_name;
     cc->gdb_get_dynamic_xml = rh850_gdb_get_dynamic_xml;
-    cc->gdb_stop_before_watchpoint = true;
-    cc->debug_excp_handler = rh850_debug_excp_handler;
-    cc->debug_check_watchpoint = rh850_debug_check_watchpoint;
 
     cc->disas_set_info = rh850_cpu_disas_set_info;
 
-#ifdef CONFIG_USER_ONLY
-    cc->handle_mmu_fault = rh850_cpu_handle_mmu_fault;
-#else
-    cc->do_unaligned_access = rh850_cpu_do_unaligned_access;
-    cc->get_phys_page_debug = rh850_cpu_get_phys_page_debug;
-#endif
-#ifdef CONFIG_TCG
-    cc->tcg_initialize = rh850_translate_init;
+#ifndef CONFIG_USER_ONLY
+    cc->sysemu_ops = &rh850_sysemu_ops;
 #endif
-    /* For now, mark unmigratable: */
-    cc->vmsd = &vmstate_rh850_cpu;
+    cc->tcg_ops = &rh850_tcg_ops;
 
-    // device_class_set_props(dc, riscv_cpu_properties);
+    device_class_set_props(dc, rh850_cpu_properties);
 }
 
 char *rh850_isa_string(RH850CPU *cpu)
@@ -82,23 +82,46 @@ enum {
 
 #define TRANSLATE_FAIL 1
 #define TRANSLATE_SUCCESS 0
-#define MMU_USER_IDX 3
-
-#define MAX_RH850_PMPS (16)
+#define MMU_SV_IDX 0     /* supervisor mode, PSW.UM = 0 */
+#define MMU_UM_IDX 1     /* user mode, PSW.UM = 1 */
 
 typedef struct CPURH850State CPURH850State;
 
-#include "pmp.h"
+#include "mpu.h"
 
 #include "register_indices.h"
 
 #define NUM_GP_REGS 32
-#define NUM_SYS_REG_BANKS 7
+#define NUM_SYS_REG_BANKS 8
 #define MAX_SYS_REGS_IN_BANK 32
 #define BANK_ID_BASIC_0 0
 #define BANK_ID_BASIC_1 1
 #define BANK_ID_BASIC_2 2
 
+/*
+ * Z, S, OV and CY flags are evaluated lazily. The translator records the
+ * operands and result of the last flag setting instruction in cc_src1,
+ * cc_src2 and cc_dst, and materializes flags only when they are read.
+ * The pending operation is tracked at translation time and saved as extra
+ * insn_start word, so that restore_state_to_opc() can compute flags when
+ * an instruction faults in the middle of TB.
+ */
+enum {
+    CC_OP_FLAGS = 0,   /* Z_flag, S_flag, OV_flag and CY_flag are valid */
+    CC_OP_ADD,         /* cc_dst = cc_src1 + cc_src2 */
+    CC_OP_SUB,         /* cc_dst = cc_src1 - cc_src2 */
+    CC_OP_LOGIC,       /* cc_dst = result, OV = 0, CY_flag is valid */
+};
+
+/*
+ * When cycle timing is enabled, the translator charges each TB with the sum
+ * of approximate execution clocks of its instructions at TB start. The
+ * second extra insn_start word holds clocks of the instruction and of the
+ * rest of TB, which restore_state_to_opc() takes back when an instruction
+ * faults in the middle of TB.
+ */
+#define TARGET_INSN_START_EXTRA_WORDS 2
+
 struct CPURH850State {
 
 
@@ -127,6 +150,11 @@ struct CPURH850State {
     uint32_t CU2_flag;
     uint32_t UM_flag;
 
+    // operands of the last flag setting instruction, see CC_OP_*
+    uint32_t cc_src1;
+    uint32_t cc_src2;
+    uint32_t cc_dst;
+
     uint32_t condSatisfied;
 
     target_ulong misa;
@@ -136,11 +164,16 @@ struct CPURH850State {
 
     target_ulong cpu_LLbit;     // register for mutual exclusion (LDL.W, STC.W)
     target_ulong cpu_LLAddress;     // register for mutual exclusion (LDL.W, STC.W)
+    target_ulong cpu_LLValue;       // value loaded by LDL.W, compared by STC.W
 
     target_ulong load_res;      // inst addr for TCG
     target_ulong load_val;      // inst val for TCG
 
-    float_status fp_status;     // not used yet in rh850, left for floating-point support.
+    float_status fp_status;     // FPSR.XP flags are kept here, see fpu_helper.c
+
+    RH850MPUState mpu;          // derived from MPU system registers, see mpu.c
+
+    uint64_t cycles;            // CPU clocks, counted only with cycle-timing
 
     // the following items were copied from original proc, remove them
     uint32_t mip;
@@ -170,8 +203,6 @@ struct CPURH850State {
     target_ulong sbadaddr;
     target_ulong mbadaddr;
     target_ulong badaddr;       //changed to mea
-    // physical memory protection
-    pmp_table_t pmp_state;              //this should be modified
 /*
     target_ulong icsr;		//interrupt control status register
     target_ulong intcfg;	//interrupt function setting
@@ -193,8 +224,12 @@ struct CPURH850State {
 
 */
 
+    int64_t snooze_deadline;    /* QEMU_CLOCK_VIRTUAL end of SNOOZE or 0 */
+
     /* Fields from here on are preserved across CPU reset. */
     QEMUTimer *timer; /* Internal timer */
+    QEMUTimer *snooze_timer;    /* kicks the vCPU at snooze_deadline */
+    void *intc;       /* RH850INTCPEState of this PE, set by the SoC */
 };
 
 #define RH850_CPU_CLASS(klass) \
@@ -231,6 +266,17 @@ typedef struct RH850CPU {
     /*< public >*/
     CPUNegativeOffsetState neg;
     CPURH850State env;
+
+    /* Properties */
+    uint32_t pe_id;             /* HTCFG0.PEID, 1 for the first PE */
+    bool cycle_timing;          /* count approximate clocks in env.cycles */
+
+    /* System registers, which GDB sees after the core ones */
+    struct {
+        char *desc;
+        int num;
+        uint16_t *regs;         /* selID << 8 | regID */
+    } dyn_sysreg_xml;
 } RH850CPU;
 
 typedef RH850CPU ArchCPU;
@@ -269,7 +315,12 @@ extern const uint32_t rh850_sys_reg_read_only_masks[][MAX_SYS_REGS_IN_BANK];
 void rh850_cpu_do_interrupt(CPUState *cpu);
 int rh850_cpu_gdb_read_register(CPUState *cpu, GByteArray *buf, int reg);
 int rh850_cpu_gdb_write_register(CPUState *cpu, uint8_t *buf, int reg);
+void rh850_cpu_register_gdb_regs(CPUState *cs);
 bool rh850_cpu_exec_interrupt(CPUState *cs, int interrupt_request);
+bool rh850_cpu_has_pending_interrupt(CPUState *cs);
+
+/* SNOOZE period, 32 CPU clocks at 80 MHz */
+#define RH850_SNOOZE_PERIOD_NS 400
 int rh850_cpu_mmu_index(CPURH850State *env, bool ifetch);
 hwaddr rh850_cpu_get_phys_page_debug(CPUState *cpu, vaddr addr);
 void  rh850_cpu_do_unaligned_access(CPUState *cs, vaddr addr,
@@ -287,6 +338,30 @@ void rh850_cpu_list(void);
 #define cpu_mmu_index rh850_cpu_mmu_index
 
 void rh850_set_mode(CPURH850State *env, target_ulong newpriv);
+void rh850_cpu_compute_flags(CPURH850State *env, uint32_t cc_op);
+uint32_t rh850_cpu_get_psw(CPURH850State *env);
+
+/* Interface between CPU and INTC, implemented in hw/intc/rh850_intc.c */
+
+/**
+ * rh850_intc_get_pending_irq: return channel which should be taken next
+ * @opaque: the part of the INTC belonging to this PE, env->intc
+ * @prio_mask: bit n is set if EIINT with priority n may be accepted
+ * @pprio: if not NULL, set to priority of the returned channel
+ * @ptable_ref: if not NULL, set to true if the channel uses table
+ *     reference method for vector selection
+ *
+ * Returns the highest priority pending channel which is not masked by
+ * @prio_mask, or -1 if there is none.
+ */
+int rh850_intc_get_pending_irq(void *opaque, uint32_t prio_mask,
+                               int *pprio, bool *ptable_ref);
+/**
+ * rh850_intc_acknowledge_irq: clear request flag of accepted channel
+ * @opaque: the part of the INTC belonging to this PE, env->intc
+ * @irq: channel returned by rh850_intc_get_pending_irq()
+ */
+void rh850_intc_acknowledge_irq(void *opaque, int irq);
 
 void rh850_translate_init(void);
 RH850CPU *cpu_rh850_init(const char *cpu_model);
@@ -296,9 +371,23 @@ void QEMU_NORETURN do_raise_exception_err(CPURH850State *env,
 
 target_ulong cpu_rh850_get_fflags(CPURH850State *env);
 void cpu_rh850_set_fflags(CPURH850State *env, target_ulong);
+target_ulong cpu_rh850_get_fpsr(CPURH850State *env);
+void cpu_rh850_set_fpsr(CPURH850State *env, target_ulong fpsr);
+
+/* FPSR, FPST, FPCC and FPCFG are accessed with helpers, see fpu_helper.c */
+static inline bool rh850_is_fpsr_view(int regID)
+{
+    return regID == FPSR_IDX || regID == FPST_IDX || regID == FPCC_IDX ||
+           regID == FPCFG_IDX;
+}
+
+#ifndef CONFIG_USER_ONLY
+extern const VMStateDescription vmstate_rh850_cpu;
+#endif
 
 #define TB_FLAGS_MMU_MASK  3
 #define TB_FLAGS_FP_ENABLE MSTATUS_FS
+#define TB_FLAGS_CU0       (1 << 2)   /* PSW.CU0, FPU instructions usable */
 
 /*
  * This f. is called from  tcg_gen_lookup_and_goto_ptr() to obtain PC
@@ -314,16 +403,15 @@ static inline void cpu_get_tb_cpu_state(CPURH850State *env, target_ulong *pc,
 #else
     *flags = cpu_mmu_index(env, 0);
 #endif
+    if (env->CU0_flag) {
+        *flags |= TB_FLAGS_CU0;
+    }
 }
 
 void csr_write_helper(CPURH850State *env, target_ulong val_to_write,
         target_ulong csrno);
 target_ulong csr_read_helper(CPURH850State *env, target_ulong csrno);
 
-#ifndef CONFIG_USER_ONLY
-void rh850_set_local_interrupt(RH850CPU *cpu, target_ulong mask, int value);
-#endif
-
 extern const int NUM_GDB_REGS;
 
 #include "exec/cpu-all.h"
@@ -41,6 +41,25 @@
 #define FSR_NXA  (FPEXC_NX << FSR_AEXC_SHIFT)
 #define FSR_AEXC (FSR_NVA | FSR_OFA | FSR_UFA | FSR_DZA | FSR_NXA)
 
+/* FPSR fields, exception bits use the FPEXC_* layout (V Z O U I) */
+#define FPSR_CC_SHIFT  24
+#define FPSR_CC        (0xff << FPSR_CC_SHIFT)
+#define FPSR_FN        0x00800000
+#define FPSR_IF        0x00400000
+#define FPSR_PEM       0x00200000
+#define FPSR_RM_SHIFT  18
+#define FPSR_RM        (0x3 << FPSR_RM_SHIFT)
+#define FPSR_FS        0x00020000
+#define FPSR_XC_SHIFT  10
+#define FPSR_XC        (0x3f << FPSR_XC_SHIFT)
+#define FPSR_XC_E      0x00008000          /* unimplemented operation */
+#define FPSR_XE_SHIFT  5
+#define FPSR_XE        (0x1f << FPSR_XE_SHIFT)
+#define FPSR_XP_SHIFT  0
+#define FPSR_XP        (0x1f << FPSR_XP_SHIFT)
+
+#define FPSR_RESET_VALUE (FPSR_PEM | FPSR_FS)
+
 /* CSR numbers */
 #define CSR_FFLAGS 0x1
 #define CSR_FRM 0x2
@@ -398,10 +417,44 @@
 #define RH850_EXCP_INST_PAGE_FAULT         0xc /* since: priv-1.10.0 */
 #define RH850_EXCP_LOAD_PAGE_FAULT         0xd /* since: priv-1.10.0 */
 #define RH850_EXCP_STORE_PAGE_FAULT        0xf /* since: priv-1.10.0 */
+#define RH850_EXCP_FPE                     0x10 /* FPU exception, precise */
+#define RH850_EXCP_RIE                     0x11 /* reserved instruction */
+#define RH850_EXCP_UCPOP                   0x12 /* coprocessor unusable */
+#define RH850_EXCP_MIP                     0x13 /* MPU, instruction fetch */
+#define RH850_EXCP_MDP                     0x14 /* MPU, data access */
+#define RH850_EXCP_SEMIHOST                0x15 /* semihosting call, DBTRAP */
 
 #define RH850_EXCP_INT_FLAG                0x80000000
 #define RH850_EXCP_INT_MASK                0x7fffffff
 
+/*
+ * Interrupt causes, exception_index is RH850_EXCP_INT_FLAG | cause. They
+ * are also the numbers of CPU GPIO input lines, which request them.
+ */
+#define RH850_INT_EIINT                    0  /* from INTC */
+#define RH850_INT_FEINT                    1
+#define RH850_INT_FENMI                    2  /* edge triggered */
+
+#define CPU_INTERRUPT_FEINT                CPU_INTERRUPT_TGT_EXT_0
+#define CPU_INTERRUPT_FENMI                CPU_INTERRUPT_TGT_EXT_1
+
+/* exception cause codes written to EIIC/FEIC */
+#define RH850_EIIC_EIINT_BASE              0x1000
+#define RH850_FEIC_FEINT                   0xf0
+#define RH850_FEIC_FENMI                   0xe0
+#define RH850_FEIC_MIP                     0x90
+#define RH850_FEIC_MDP                     0x91
+
+/* RBASE/EBASE bit 0, all EIINT channels use the same vector */
+#define RH850_BASE_RINT                    0x00000001
+#define RH850_BASE_MASK                    0xfffffe00
+
+#define INTCFG_ISPC                        0x00000001
+
+/* HTCFG0.PEID, number of the PE, starting with 1 */
+#define HTCFG0_PEID_SHIFT                  16
+#define HTCFG0_PEID_MASK                   0x00070000
+
 /* page table entry (PTE) fields */
 #define PTE_V     0x001 /* Valid */
 #define PTE_R     0x002 /* Read */
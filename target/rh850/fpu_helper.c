@@ -22,6 +22,22 @@
 #include "qemu/host-utils.h"
 #include "exec/exec-all.h"
 #include "exec/helper-proto.h"
+#include "fpu/softfloat.h"
+
+/*
+ * Exception flags handling
+ *
+ * FPSR.XP (preserved exception flags) is not stored in FPSR, but in
+ * fp_status, where softfloat accumulates flags anyway. While all FPU
+ * exceptions are masked (FPSR.XE == 0), which is the common case, helpers
+ * only call softfloat and do not touch the flags. Since the inexact flag
+ * then stays set after the first inexact result, softfloat can use the
+ * host FPU for most operations.
+ *
+ * When any exception is enabled, each operation runs on cleared flags,
+ * so that FPSR.XC (cause) can be set and an enabled exception raised
+ * before the result is written. FPSR.XC is updated only in this mode.
+ */
 
 target_ulong cpu_rh850_get_fflags(CPURH850State *env)
 {
@@ -50,322 +66,431 @@ void cpu_rh850_set_fflags(CPURH850State *env, target_ulong hard)
     set_float_exception_flags(soft, &env->fp_status);
 }
 
-void helper_set_rounding_mode(CPURH850State *env, uint32_t rm)
+target_ulong cpu_rh850_get_fpsr(CPURH850State *env)
 {
-    int softrm;
-
-    if (rm == 7) {
-        rm = 0; //env->frm;
-    }
-    switch (rm) {
-    case 0:
-        softrm = float_round_nearest_even;
-        break;
-    case 1:
-        softrm = float_round_to_zero;
-        break;
-    case 2:
-        softrm = float_round_down;
-        break;
-    case 3:
-        softrm = float_round_up;
-        break;
-    case 4:
-        softrm = float_round_ties_away;
-        break;
-    default:
-        do_raise_exception_err(env, RH850_EXCP_ILLEGAL_INST, GETPC());
-    }
-
-    set_float_rounding_mode(softrm, &env->fp_status);
+    return deposit32(env->systemRegs[BANK_ID_BASIC_0][FPSR_IDX],
+                     FPSR_XP_SHIFT, 5, cpu_rh850_get_fflags(env));
 }
 
-uint64_t helper_fmadd_s(CPURH850State *env, uint64_t frs1, uint64_t frs2,
-                        uint64_t frs3)
+void cpu_rh850_set_fpsr(CPURH850State *env, target_ulong fpsr)
 {
-    return float32_muladd(frs1, frs2, frs3, 0, &env->fp_status);
-}
+    static const FloatRoundMode rm[4] = {
+        float_round_nearest_even,
+        float_round_to_zero,
+        float_round_up,
+        float_round_down,
+    };
+    bool fs = (fpsr & FPSR_FS) != 0;
 
-uint64_t helper_fmadd_d(CPURH850State *env, uint64_t frs1, uint64_t frs2,
-                        uint64_t frs3)
-{
-    return float64_muladd(frs1, frs2, frs3, 0, &env->fp_status);
+    env->systemRegs[BANK_ID_BASIC_0][FPSR_IDX] = fpsr;
+    set_float_rounding_mode(rm[extract32(fpsr, FPSR_RM_SHIFT, 2)],
+                            &env->fp_status);
+    set_flush_to_zero(fs, &env->fp_status);
+    set_flush_inputs_to_zero(fs, &env->fp_status);
+    cpu_rh850_set_fflags(env, extract32(fpsr, FPSR_XP_SHIFT, 5));
 }
 
-uint64_t helper_fmsub_s(CPURH850State *env, uint64_t frs1, uint64_t frs2,
-                        uint64_t frs3)
+static inline int fpu_begin(CPURH850State *env)
 {
-    return float32_muladd(frs1, frs2, frs3, float_muladd_negate_c,
-                          &env->fp_status);
-}
+    int flags = get_float_exception_flags(&env->fp_status);
 
-uint64_t helper_fmsub_d(CPURH850State *env, uint64_t frs1, uint64_t frs2,
-                        uint64_t frs3)
-{
-    return float64_muladd(frs1, frs2, frs3, float_muladd_negate_c,
-                          &env->fp_status);
+    if (unlikely(env->systemRegs[BANK_ID_BASIC_0][FPSR_IDX] & FPSR_XE)) {
+        set_float_exception_flags(0, &env->fp_status);
+    }
+    return flags;
 }
 
-uint64_t helper_fnmsub_s(CPURH850State *env, uint64_t frs1, uint64_t frs2,
-                         uint64_t frs3)
+static inline void fpu_end(CPURH850State *env, int old_flags, uintptr_t ra)
 {
-    return float32_muladd(frs1, frs2, frs3, float_muladd_negate_product,
-                          &env->fp_status);
-}
+    uint32_t fpsr = env->systemRegs[BANK_ID_BASIC_0][FPSR_IDX];
+    int flags;
+    uint32_t cause;
 
-uint64_t helper_fnmsub_d(CPURH850State *env, uint64_t frs1, uint64_t frs2,
-                         uint64_t frs3)
-{
-    return float64_muladd(frs1, frs2, frs3, float_muladd_negate_product,
-                          &env->fp_status);
-}
+    if (likely(!(fpsr & FPSR_XE))) {
+        return;
+    }
 
-uint64_t helper_fnmadd_s(CPURH850State *env, uint64_t frs1, uint64_t frs2,
-                         uint64_t frs3)
-{
-    return float32_muladd(frs1, frs2, frs3, float_muladd_negate_c |
-                          float_muladd_negate_product, &env->fp_status);
-}
+    flags = get_float_exception_flags(&env->fp_status);
+    cause = cpu_rh850_get_fflags(env);
+    env->systemRegs[BANK_ID_BASIC_0][FPSR_IDX] =
+        deposit32(fpsr, FPSR_XC_SHIFT, 6, cause);
 
-uint64_t helper_fnmadd_d(CPURH850State *env, uint64_t frs1, uint64_t frs2,
-                         uint64_t frs3)
-{
-    return float64_muladd(frs1, frs2, frs3, float_muladd_negate_c |
-                          float_muladd_negate_product, &env->fp_status);
+    if (cause & extract32(fpsr, FPSR_XE_SHIFT, 5)) {
+        /* precise exception, XP is not updated and result is not written */
+        set_float_exception_flags(old_flags, &env->fp_status);
+        do_raise_exception_err(env, RH850_EXCP_FPE, ra);
+    }
+    set_float_exception_flags(old_flags | flags, &env->fp_status);
 }
 
-uint64_t helper_fadd_s(CPURH850State *env, uint64_t frs1, uint64_t frs2)
+/* FPSR, FPST, FPCC and FPCFG are views of the same state */
+uint32_t helper_stsr_fpu(CPURH850State *env, uint32_t regID)
 {
-    return float32_add(frs1, frs2, &env->fp_status);
-}
+    uint32_t fpsr = cpu_rh850_get_fpsr(env);
 
-uint64_t helper_fsub_s(CPURH850State *env, uint64_t frs1, uint64_t frs2)
-{
-    return float32_sub(frs1, frs2, &env->fp_status);
+    switch (regID) {
+    case FPST_IDX:
+        return (extract32(fpsr, FPSR_XC_SHIFT, 6) << 8)
+             | (((fpsr & FPSR_IF) != 0) << 5)
+             | extract32(fpsr, FPSR_XP_SHIFT, 5);
+    case FPCC_IDX:
+        return extract32(fpsr, FPSR_CC_SHIFT, 8);
+    case FPCFG_IDX:
+        return (extract32(fpsr, FPSR_RM_SHIFT, 2) << 8)
+             | extract32(fpsr, FPSR_XE_SHIFT, 5);
+    default:
+        return fpsr;
+    }
 }
 
-uint64_t helper_fmul_s(CPURH850State *env, uint64_t frs1, uint64_t frs2)
+void helper_ldsr_fpu(CPURH850State *env, uint32_t regID, uint32_t val)
 {
-    return float32_mul(frs1, frs2, &env->fp_status);
-}
+    uint32_t fpsr = cpu_rh850_get_fpsr(env);
+    uint32_t mask = rh850_sys_reg_read_only_masks[BANK_ID_BASIC_0][regID];
 
-uint64_t helper_fdiv_s(CPURH850State *env, uint64_t frs1, uint64_t frs2)
-{
-    return float32_div(frs1, frs2, &env->fp_status);
+    val &= mask;
+    switch (regID) {
+    case FPST_IDX:
+        fpsr = deposit32(fpsr, FPSR_XC_SHIFT, 6, extract32(val, 8, 6));
+        fpsr = deposit32(fpsr, FPSR_XP_SHIFT, 5, extract32(val, 0, 5));
+        break;
+    case FPCC_IDX:
+        fpsr = deposit32(fpsr, FPSR_CC_SHIFT, 8, val);
+        break;
+    case FPCFG_IDX:
+        fpsr = deposit32(fpsr, FPSR_RM_SHIFT, 2, extract32(val, 8, 2));
+        fpsr = deposit32(fpsr, FPSR_XE_SHIFT, 5, extract32(val, 0, 5));
+        break;
+    default:
+        fpsr = (fpsr & ~mask) | val;
+        break;
+    }
+    cpu_rh850_set_fpsr(env, fpsr);
 }
 
-uint64_t helper_fmin_s(CPURH850State *env, uint64_t frs1, uint64_t frs2)
-{
-    return float32_minnum(frs1, frs2, &env->fp_status);
-}
+/* Floating Point - Single Precision */
 
-uint64_t helper_fmax_s(CPURH850State *env, uint64_t frs1, uint64_t frs2)
-{
-    return float32_maxnum(frs1, frs2, &env->fp_status);
+#define FPU_BINOP_S(name, op)                                               \
+uint32_t helper_##name##_s(CPURH850State *env, uint32_t a, uint32_t b)      \
+{                                                                           \
+    int flags = fpu_begin(env);                                             \
+    float32 r = op(make_float32(a), make_float32(b), &env->fp_status);      \
+    fpu_end(env, flags, GETPC());                                           \
+    return float32_val(r);                                                  \
 }
 
-uint64_t helper_fsqrt_s(CPURH850State *env, uint64_t frs1)
-{
-    return float32_sqrt(frs1, &env->fp_status);
-}
+FPU_BINOP_S(addf, float32_add)
+FPU_BINOP_S(subf, float32_sub)
+FPU_BINOP_S(mulf, float32_mul)
+FPU_BINOP_S(divf, float32_div)
+FPU_BINOP_S(maxf, float32_max)
+FPU_BINOP_S(minf, float32_min)
 
-target_ulong helper_fle_s(CPURH850State *env, uint64_t frs1, uint64_t frs2)
+uint32_t helper_fmaf_s(CPURH850State *env, uint32_t a, uint32_t b,
+                       uint32_t c, uint32_t negate)
 {
-    return float32_le(frs1, frs2, &env->fp_status);
+    int flags = fpu_begin(env);
+    float32 r = float32_muladd(make_float32(a), make_float32(b),
+                               make_float32(c), negate, &env->fp_status);
+    fpu_end(env, flags, GETPC());
+    return float32_val(r);
 }
 
-target_ulong helper_flt_s(CPURH850State *env, uint64_t frs1, uint64_t frs2)
+uint32_t helper_sqrtf_s(CPURH850State *env, uint32_t a)
 {
-    return float32_lt(frs1, frs2, &env->fp_status);
+    int flags = fpu_begin(env);
+    float32 r = float32_sqrt(make_float32(a), &env->fp_status);
+    fpu_end(env, flags, GETPC());
+    return float32_val(r);
 }
 
-target_ulong helper_feq_s(CPURH850State *env, uint64_t frs1, uint64_t frs2)
+/* RECIPF and RSQRTF are approximations on hardware, here they are exact */
+uint32_t helper_recipf_s(CPURH850State *env, uint32_t a)
 {
-    return float32_eq_quiet(frs1, frs2, &env->fp_status);
+    int flags = fpu_begin(env);
+    float32 r = float32_div(float32_one, make_float32(a), &env->fp_status);
+    fpu_end(env, flags, GETPC());
+    return float32_val(r);
 }
 
-target_ulong helper_fcvt_w_s(CPURH850State *env, uint64_t frs1)
+uint32_t helper_rsqrtf_s(CPURH850State *env, uint32_t a)
 {
-    return float32_to_int32(frs1, &env->fp_status);
+    int flags = fpu_begin(env);
+    float32 r = float32_sqrt(make_float32(a), &env->fp_status);
+    r = float32_div(float32_one, r, &env->fp_status);
+    fpu_end(env, flags, GETPC());
+    return float32_val(r);
 }
 
-target_ulong helper_fcvt_wu_s(CPURH850State *env, uint64_t frs1)
+/*
+ * Rounding of float to integer conversions is selected by the low bits of
+ * the reg1 field: ROUNDF, TRNCF, CEILF, FLOORF or CVTF (FPSR.RM).
+ */
+static FloatRoundMode fpu_cvt_round_mode(CPURH850State *env, uint32_t code)
 {
-    return (int32_t)float32_to_uint32(frs1, &env->fp_status);
+    switch (code & 0x7) {
+    case 0:
+        return float_round_ties_away;
+    case 1:
+        return float_round_to_zero;
+    case 2:
+        return float_round_up;
+    case 3:
+        return float_round_down;
+    default:
+        return get_float_rounding_mode(&env->fp_status);
+    }
 }
 
-#if defined(TARGET_RH85064)
-uint64_t helper_fcvt_l_s(CPURH850State *env, uint64_t frs1)
-{
-    return float32_to_int64(frs1, &env->fp_status);
-}
+/* bit 4 of the conversion code selects unsigned integer */
+#define CVT_UNSIGNED(code) ((code) & 0x10)
 
-uint64_t helper_fcvt_lu_s(CPURH850State *env, uint64_t frs1)
+uint32_t helper_cvtf_sw(CPURH850State *env, uint32_t a, uint32_t code)
 {
-    return float32_to_uint64(frs1, &env->fp_status);
-}
-#endif
+    int flags = fpu_begin(env);
+    FloatRoundMode rm = fpu_cvt_round_mode(env, code);
+    uint32_t r;
 
-uint64_t helper_fcvt_s_w(CPURH850State *env, target_ulong rs1)
-{
-    return int32_to_float32((int32_t)rs1, &env->fp_status);
+    if (CVT_UNSIGNED(code)) {
+        r = float32_to_uint32_scalbn(make_float32(a), rm, 0, &env->fp_status);
+    } else {
+        r = float32_to_int32_scalbn(make_float32(a), rm, 0, &env->fp_status);
+    }
+    fpu_end(env, flags, GETPC());
+    return r;
 }
 
-uint64_t helper_fcvt_s_wu(CPURH850State *env, target_ulong rs1)
+uint64_t helper_cvtf_sl(CPURH850State *env, uint32_t a, uint32_t code)
 {
-    return uint32_to_float32((uint32_t)rs1, &env->fp_status);
-}
+    int flags = fpu_begin(env);
+    FloatRoundMode rm = fpu_cvt_round_mode(env, code);
+    uint64_t r;
 
-#if defined(TARGET_RH85064)
-uint64_t helper_fcvt_s_l(CPURH850State *env, uint64_t rs1)
-{
-    return int64_to_float32(rs1, &env->fp_status);
+    if (CVT_UNSIGNED(code)) {
+        r = float32_to_uint64_scalbn(make_float32(a), rm, 0, &env->fp_status);
+    } else {
+        r = float32_to_int64_scalbn(make_float32(a), rm, 0, &env->fp_status);
+    }
+    fpu_end(env, flags, GETPC());
+    return r;
 }
 
-uint64_t helper_fcvt_s_lu(CPURH850State *env, uint64_t rs1)
+uint32_t helper_cvtf_ws(CPURH850State *env, uint32_t a, uint32_t code)
 {
-    return uint64_to_float32(rs1, &env->fp_status);
+    int flags = fpu_begin(env);
+    float32 r;
+
+    if (CVT_UNSIGNED(code)) {
+        r = uint32_to_float32(a, &env->fp_status);
+    } else {
+        r = int32_to_float32(a, &env->fp_status);
+    }
+    fpu_end(env, flags, GETPC());
+    return float32_val(r);
 }
-#endif
 
-target_ulong helper_fclass_s(uint64_t frs1)
+uint32_t helper_cvtf_ls(CPURH850State *env, uint64_t a, uint32_t code)
 {
-    float32 f = frs1;
-    bool sign = float32_is_neg(f);
+    int flags = fpu_begin(env);
+    float32 r;
 
-    if (float32_is_infinity(f)) {
-        return sign ? 1 << 0 : 1 << 7;
-    } else if (float32_is_zero(f)) {
-        return sign ? 1 << 3 : 1 << 4;
-    } else if (float32_is_zero_or_denormal(f)) {
-        return sign ? 1 << 2 : 1 << 5;
-    } else if (float32_is_any_nan(f)) {
-        float_status s = { }; /* for snan_bit_is_one */
-        return float32_is_quiet_nan(f, &s) ? 1 << 9 : 1 << 8;
+    if (CVT_UNSIGNED(code)) {
+        r = uint64_to_float32(a, &env->fp_status);
     } else {
-        return sign ? 1 << 1 : 1 << 6;
+        r = int64_to_float32(a, &env->fp_status);
     }
+    fpu_end(env, flags, GETPC());
+    return float32_val(r);
 }
 
-uint64_t helper_fadd_d(CPURH850State *env, uint64_t frs1, uint64_t frs2)
+uint32_t helper_cvtf_hs(CPURH850State *env, uint32_t a)
 {
-    return float64_add(frs1, frs2, &env->fp_status);
+    int flags = fpu_begin(env);
+    float32 r = float16_to_float32(make_float16(a), true, &env->fp_status);
+    fpu_end(env, flags, GETPC());
+    return float32_val(r);
 }
 
-uint64_t helper_fsub_d(CPURH850State *env, uint64_t frs1, uint64_t frs2)
+uint32_t helper_cvtf_sh(CPURH850State *env, uint32_t a)
 {
-    return float64_sub(frs1, frs2, &env->fp_status);
+    int flags = fpu_begin(env);
+    float16 r = float32_to_float16(make_float32(a), true, &env->fp_status);
+    fpu_end(env, flags, GETPC());
+    return float16_val(r);
 }
 
-uint64_t helper_fmul_d(CPURH850State *env, uint64_t frs1, uint64_t frs2)
-{
-    return float64_mul(frs1, frs2, &env->fp_status);
+/*
+ * fcond bits: 0 - true if unordered, 1 - true if equal, 2 - true if less,
+ * 3 - raise invalid operation also for quiet NaNs
+ */
+static bool fpu_cond_satisfied(FloatRelation rel, uint32_t fcond)
+{
+    switch (rel) {
+    case float_relation_unordered:
+        return fcond & 1;
+    case float_relation_equal:
+        return fcond & 2;
+    case float_relation_less:
+        return fcond & 4;
+    default:
+        return false;
+    }
 }
 
-uint64_t helper_fdiv_d(CPURH850State *env, uint64_t frs1, uint64_t frs2)
+static void fpu_set_cc(CPURH850State *env, uint32_t fcbit, bool val)
 {
-    return float64_div(frs1, frs2, &env->fp_status);
+    env->systemRegs[BANK_ID_BASIC_0][FPSR_IDX] =
+        deposit32(env->systemRegs[BANK_ID_BASIC_0][FPSR_IDX],
+                  FPSR_CC_SHIFT + fcbit, 1, val);
 }
 
-uint64_t helper_fmin_d(CPURH850State *env, uint64_t frs1, uint64_t frs2)
+void helper_cmpf_s(CPURH850State *env, uint32_t a, uint32_t b,
+                   uint32_t fcond, uint32_t fcbit)
 {
-    return float64_minnum(frs1, frs2, &env->fp_status);
-}
+    int flags = fpu_begin(env);
+    FloatRelation rel;
 
-uint64_t helper_fmax_d(CPURH850State *env, uint64_t frs1, uint64_t frs2)
-{
-    return float64_maxnum(frs1, frs2, &env->fp_status);
+    if (fcond & 8) {
+        rel = float32_compare(make_float32(a), make_float32(b),
+                              &env->fp_status);
+    } else {
+        rel = float32_compare_quiet(make_float32(a), make_float32(b),
+                                    &env->fp_status);
+    }
+    fpu_end(env, flags, GETPC());
+    fpu_set_cc(env, fcbit, fpu_cond_satisfied(rel, fcond));
 }
 
-uint64_t helper_fcvt_s_d(CPURH850State *env, uint64_t rs1)
-{
-    return float64_to_float32(rs1, &env->fp_status);
-}
+/* Floating Point - Double Precision */
 
-uint64_t helper_fcvt_d_s(CPURH850State *env, uint64_t rs1)
-{
-    return float32_to_float64(rs1, &env->fp_status);
+#define FPU_BINOP_D(name, op)                                               \
+uint64_t helper_##name##_d(CPURH850State *env, uint64_t a, uint64_t b)      \
+{                                                                           \
+    int flags = fpu_begin(env);                                             \
+    float64 r = op(make_float64(a), make_float64(b), &env->fp_status);      \
+    fpu_end(env, flags, GETPC());                                           \
+    return float64_val(r);                                                  \
 }
 
-uint64_t helper_fsqrt_d(CPURH850State *env, uint64_t frs1)
-{
-    return float64_sqrt(frs1, &env->fp_status);
-}
+FPU_BINOP_D(addf, float64_add)
+FPU_BINOP_D(subf, float64_sub)
+FPU_BINOP_D(mulf, float64_mul)
+FPU_BINOP_D(divf, float64_div)
+FPU_BINOP_D(maxf, float64_max)
+FPU_BINOP_D(minf, float64_min)
 
-target_ulong helper_fle_d(CPURH850State *env, uint64_t frs1, uint64_t frs2)
+uint64_t helper_sqrtf_d(CPURH850State *env, uint64_t a)
 {
-    return float64_le(frs1, frs2, &env->fp_status);
+    int flags = fpu_begin(env);
+    float64 r = float64_sqrt(make_float64(a), &env->fp_status);
+    fpu_end(env, flags, GETPC());
+    return float64_val(r);
 }
 
-target_ulong helper_flt_d(CPURH850State *env, uint64_t frs1, uint64_t frs2)
+uint64_t helper_recipf_d(CPURH850State *env, uint64_t a)
 {
-    return float64_lt(frs1, frs2, &env->fp_status);
+    int flags = fpu_begin(env);
+    float64 r = float64_div(float64_one, make_float64(a), &env->fp_status);
+    fpu_end(env, flags, GETPC());
+    return float64_val(r);
 }
 
-target_ulong helper_feq_d(CPURH850State *env, uint64_t frs1, uint64_t frs2)
+uint64_t helper_rsqrtf_d(CPURH850State *env, uint64_t a)
 {
-    return float64_eq_quiet(frs1, frs2, &env->fp_status);
+    int flags = fpu_begin(env);
+    float64 r = float64_sqrt(make_float64(a), &env->fp_status);
+    r = float64_div(float64_one, r, &env->fp_status);
+    fpu_end(env, flags, GETPC());
+    return float64_val(r);
 }
 
-target_ulong helper_fcvt_w_d(CPURH850State *env, uint64_t frs1)
+uint32_t helper_cvtf_dw(CPURH850State *env, uint64_t a, uint32_t code)
 {
-    return float64_to_int32(frs1, &env->fp_status);
-}
+    int flags = fpu_begin(env);
+    FloatRoundMode rm = fpu_cvt_round_mode(env, code);
+    uint32_t r;
 
-target_ulong helper_fcvt_wu_d(CPURH850State *env, uint64_t frs1)
-{
-    return (int32_t)float64_to_uint32(frs1, &env->fp_status);
+    if (CVT_UNSIGNED(code)) {
+        r = float64_to_uint32_scalbn(make_float64(a), rm, 0, &env->fp_status);
+    } else {
+        r = float64_to_int32_scalbn(make_float64(a), rm, 0, &env->fp_status);
+    }
+    fpu_end(env, flags, GETPC());
+    return r;
 }
 
-#if defined(TARGET_RH85064)
-uint64_t helper_fcvt_l_d(CPURH850State *env, uint64_t frs1)
+uint64_t helper_cvtf_dl(CPURH850State *env, uint64_t a, uint32_t code)
 {
-    return float64_to_int64(frs1, &env->fp_status);
-}
+    int flags = fpu_begin(env);
+    FloatRoundMode rm = fpu_cvt_round_mode(env, code);
+    uint64_t r;
 
-uint64_t helper_fcvt_lu_d(CPURH850State *env, uint64_t frs1)
-{
-    return float64_to_uint64(frs1, &env->fp_status);
+    if (CVT_UNSIGNED(code)) {
+        r = float64_to_uint64_scalbn(make_float64(a), rm, 0, &env->fp_status);
+    } else {
+        r = float64_to_int64_scalbn(make_float64(a), rm, 0, &env->fp_status);
+    }
+    fpu_end(env, flags, GETPC());
+    return r;
 }
-#endif
 
-uint64_t helper_fcvt_d_w(CPURH850State *env, target_ulong rs1)
+uint64_t helper_cvtf_wd(CPURH850State *env, uint32_t a, uint32_t code)
 {
-    return int32_to_float64((int32_t)rs1, &env->fp_status);
+    int flags = fpu_begin(env);
+    float64 r;
+
+    if (CVT_UNSIGNED(code)) {
+        r = uint32_to_float64(a, &env->fp_status);
+    } else {
+        r = int32_to_float64(a, &env->fp_status);
+    }
+    fpu_end(env, flags, GETPC());
+    return float64_val(r);
 }
 
-uint64_t helper_fcvt_d_wu(CPURH850State *env, target_ulong rs1)
+uint64_t helper_cvtf_ld(CPURH850State *env, uint64_t a, uint32_t code)
 {
-    return uint32_to_float64((uint32_t)rs1, &env->fp_status);
+    int flags = fpu_begin(env);
+    float64 r;
+
+    if (CVT_UNSIGNED(code)) {
+        r = uint64_to_float64(a, &env->fp_status);
+    } else {
+        r = int64_to_float64(a, &env->fp_status);
+    }
+    fpu_end(env, flags, GETPC());
+    return float64_val(r);
 }
 
-#if defined(TARGET_RH85064)
-uint64_t helper_fcvt_d_l(CPURH850State *env, uint64_t rs1)
+uint64_t helper_cvtf_sd(CPURH850State *env, uint32_t a)
 {
-    return int64_to_float64(rs1, &env->fp_status);
+    int flags = fpu_begin(env);
+    float64 r = float32_to_float64(make_float32(a), &env->fp_status);
+    fpu_end(env, flags, GETPC());
+    return float64_val(r);
 }
 
-uint64_t helper_fcvt_d_lu(CPURH850State *env, uint64_t rs1)
+uint32_t helper_cvtf_ds(CPURH850State *env, uint64_t a)
 {
-    return uint64_to_float64(rs1, &env->fp_status);
+    int flags = fpu_begin(env);
+    float32 r = float64_to_float32(make_float64(a), &env->fp_status);
+    fpu_end(env, flags, GETPC());
+    return float32_val(r);
 }
-#endif
 
-target_ulong helper_fclass_d(uint64_t frs1)
+void helper_cmpf_d(CPURH850State *env, uint64_t a, uint64_t b,
+                   uint32_t fcond, uint32_t fcbit)
 {
-    float64 f = frs1;
-    bool sign = float64_is_neg(f);
+    int flags = fpu_begin(env);
+    FloatRelation rel;
 
-    if (float64_is_infinity(f)) {
-        return sign ? 1 << 0 : 1 << 7;
-    } else if (float64_is_zero(f)) {
-        return sign ? 1 << 3 : 1 << 4;
-    } else if (float64_is_zero_or_denormal(f)) {
-        return sign ? 1 << 2 : 1 << 5;
-    } else if (float64_is_any_nan(f)) {
-        float_status s = { }; /* for snan_bit_is_one */
-        return float64_is_quiet_nan(f, &s) ? 1 << 9 : 1 << 8;
+    if (fcond & 8) {
+        rel = float64_compare(make_float64(a), make_float64(b),
+                              &env->fp_status);
     } else {
-        return sign ? 1 << 1 : 1 << 6;
+        rel = float64_compare_quiet(make_float64(a), make_float64(b),
+                                    &env->fp_status);
     }
+    fpu_end(env, flags, GETPC());
+    fpu_set_cc(env, fcbit, fpu_cond_satisfied(rel, fcond));
 }
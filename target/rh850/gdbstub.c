@@ -19,6 +19,7 @@
 #include "qemu/osdep.h"
 #include "qemu-common.h"
 #include "exec/gdbstub.h"
+#include "exec/helper-proto.h"
 #include "cpu.h"
 
 /* Mapping of winIDEA register index to env->sysBasicRegs() index. (see mail
@@ -57,6 +58,11 @@
        189, //      asid     29
        190  //      mei      30
 */
+/*
+ * These NUM_GDB_REGS registers are the core registers, sent in this order in
+ * 'g' packets. gdb-xml/rh850-core.xml describes them and must be kept in sync
+ * with this table, unused slots are named rsvd<n> there.
+ */
 #define BANK_MASK  0xf0000
 #define BANK_SHIFT 16
 #define SRI(selID, regID) (((selID) << BANK_SHIFT) | (regID))
@@ -84,7 +90,7 @@ SRI0(EIWR_IDX),SRI0(FEWR_IDX),-1,SRI0(BSEL_IDX),    -1,          -1,          -1
 -1,          -1,          -1,          -1,          -1,          -1,          -1,          -1,          -1,          -1,        // 10
 -1,          -1,          -1,          -1,          -1,          -1,          -1,          -1,          -1,          -1,        // 11
 
--1,          -1,          -1,          -1,          -1,          -1,          -1,          -1, SRI0(FPSR_IDX), SRI0(FEPC_IDX),        // 12
+-1,          -1,          -1,          -1,          -1,          -1,          -1,          -1, SRI0(FPSR_IDX), SRI0(FPEPC_IDX),        // 12
 SRI0(FPST_IDX),SRI0(FPCC_IDX),SRI0(FPCFG_IDX),SRI0(FPEC_IDX), -1,-1,          -1,          -1,          -1,          -1,        // 13
 -1,          -1,          -1,          -1,          -1,          -1,          -1,          -1,          -1,          -1,        // 14
 
@@ -98,6 +104,34 @@ SRI2(MEI_IDX2), -1,       -1,          -1,          -1,          -1,          -1
 
 const int NUM_GDB_REGS = sizeof(winIdeaRegIdx2qemuSysRegIdx) / sizeof(IdxType);
 
+/* Reads a system register other than PSW, as STSR does */
+static uint32_t rh850_gdb_read_sysreg(CPURH850State *env, int selID, int regID)
+{
+    if (selID == BANK_ID_BASIC_0  &&  rh850_is_fpsr_view(regID)) {
+        return helper_stsr_fpu(env, regID);
+    }
+    return env->systemRegs[selID][regID];
+}
+
+/*
+ * Writes a system register other than PSW, as LDSR does. Read-only and
+ * reserved bits keep their values, and derived state is updated.
+ */
+static void rh850_gdb_write_sysreg(CPURH850State *env, int selID, int regID,
+                                   uint32_t val)
+{
+    if (selID == BANK_ID_BASIC_0  &&  rh850_is_fpsr_view(regID)) {
+        helper_ldsr_fpu(env, regID, val);
+    } else if (rh850_mpu_sysreg(selID, regID)) {
+        helper_ldsr_mpu(env, selID, regID, val);
+    } else {
+        uint32_t mask = rh850_sys_reg_read_only_masks[selID][regID];
+
+        env->systemRegs[selID][regID] =
+            (env->systemRegs[selID][regID] & ~mask) | (val & mask);
+    }
+}
+
 int rh850_cpu_gdb_read_register(CPUState *cs, GByteArray *mem_buf, int reg)
 {
     RH850CPU *cpu = RH850_CPU(cs);
@@ -119,7 +153,9 @@ int rh850_cpu_gdb_read_register(CPUState *cs, GByteArray *mem_buf, int reg)
                 psw |= (env->CU1_flag << 17) | (env->CU2_flag << 18) | (env->UM_flag << 30);
                 return gdb_get_regl(mem_buf, psw);
             } else {
-                return gdb_get_regl(mem_buf, env->systemRegs[selID][regID]); // eipc, eipsw, fepc, fepsw, psw, ...
+                /* eipc, eipsw, fepc, fepsw, ... */
+                return gdb_get_regl(mem_buf,
+                                    rh850_gdb_read_sysreg(env, selID, regID));
             }
     	}
     }
@@ -161,7 +197,8 @@ int rh850_cpu_gdb_write_register(CPUState *cs, uint8_t *mem_buf, int n)
                 env->CU2_flag = (psw >> 18) & 1;
                 env->UM_flag = (psw >> 30) & 1;
             } else {
-                env->systemRegs[selID][regID] = ldtul_p(mem_buf); // eipc, eipsw, fepc, fepsw, psw, ...
+                /* eipc, eipsw, fepc, fepsw, ... */
+                rh850_gdb_write_sysreg(env, selID, regID, ldtul_p(mem_buf));
             }
     	}
     }
@@ -178,3 +215,78 @@ int rh850_cpu_gdb_write_register(CPUState *cs, uint8_t *mem_buf, int n)
 */
     return sizeof(target_ulong);
 }
+
+static bool rh850_gdb_core_sysreg(int selID, int regID)
+{
+    int i;
+
+    for (i = 0; i < NUM_GDB_REGS; i++) {
+        if (winIdeaRegIdx2qemuSysRegIdx[i] == SRI(selID, regID)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int rh850_gdb_get_sysreg(CPURH850State *env, GByteArray *buf, int reg)
+{
+    RH850CPU *cpu = rh850_env_get_cpu(env);
+    int key = cpu->dyn_sysreg_xml.regs[reg];
+
+    return gdb_get_regl(buf, rh850_gdb_read_sysreg(env, key >> 8, key & 0xff));
+}
+
+static int rh850_gdb_set_sysreg(CPURH850State *env, uint8_t *buf, int reg)
+{
+    RH850CPU *cpu = rh850_env_get_cpu(env);
+    int key = cpu->dyn_sysreg_xml.regs[reg];
+
+    rh850_gdb_write_sysreg(env, key >> 8, key & 0xff, ldtul_p(buf));
+    return sizeof(target_ulong);
+}
+
+/*
+ * Describes the named system registers of all banks, which are not among
+ * the core registers, as feature system-registers.xml. They are numbered
+ * from base_reg on and are also sent in 'g' packets, so that debuggers
+ * get all registers in one round trip.
+ */
+static void rh850_gen_dynamic_sysreg_xml(CPUState *cs, int base_reg)
+{
+    RH850CPU *cpu = RH850_CPU(cs);
+    GString *s = g_string_new(NULL);
+    int selID, regID;
+    int n = 0;
+
+    cpu->dyn_sysreg_xml.regs = g_new(uint16_t,
+                                     NUM_SYS_REG_BANKS * MAX_SYS_REGS_IN_BANK);
+    g_string_printf(s, "<?xml version=\"1.0\"?>");
+    g_string_append_printf(s, "<!DOCTYPE feature SYSTEM \"gdb-target.dtd\">");
+    g_string_append_printf(s, "<feature name=\"org.qemu.gdb.rh850.sys.regs\">");
+    for (selID = 0; selID < NUM_SYS_REG_BANKS; selID++) {
+        for (regID = 0; regID < MAX_SYS_REGS_IN_BANK; regID++) {
+            const char *name = rh850_sys_regnames[selID][regID];
+
+            if (!name || rh850_gdb_core_sysreg(selID, regID)) {
+                continue;
+            }
+            g_string_append_printf(s, "<reg name=\"%s\" bitsize=\"32\" "
+                                   "regnum=\"%d\" group=\"system\"/>",
+                                   name, base_reg + n);
+            cpu->dyn_sysreg_xml.regs[n++] = selID << 8 | regID;
+        }
+    }
+    g_string_append_printf(s, "</feature>");
+    cpu->dyn_sysreg_xml.num = n;
+    cpu->dyn_sysreg_xml.desc = g_string_free(s, false);
+}
+
+void rh850_cpu_register_gdb_regs(CPUState *cs)
+{
+    RH850CPU *cpu = RH850_CPU(cs);
+
+    rh850_gen_dynamic_sysreg_xml(cs, cs->gdb_num_regs);
+    gdb_register_coprocessor(cs, rh850_gdb_get_sysreg, rh850_gdb_set_sysreg,
+                             cpu->dyn_sysreg_xml.num, "system-registers.xml",
+                             cs->gdb_num_regs);
+}
@@ -23,6 +23,7 @@
 #include "cpu.h"
 #include "exec/exec-all.h"
 #include "tcg/tcg-op.h"
+#include "semihosting/common-semi.h"
 
 #define RH850_DEBUG_INTERRUPT 0
 
@@ -31,35 +32,74 @@ int rh850_cpu_mmu_index(CPURH850State *env, bool ifetch)
 #ifdef CONFIG_USER_ONLY
     return 0;
 #else
-    return env->priv;
+    return env->UM_flag ? MMU_UM_IDX : MMU_SV_IDX;
 #endif
 }
 
-#ifndef CONFIG_USER_ONLY
 /*
- * Return RH850 IRQ number if an interrupt should be taken, else -1.
- * Used in cpu-exec.c
- *
- * Adapted from Spike's processor_t::take_interrupt()
+ * Materializes Z, S, OV and CY flags from the lazily evaluated state,
+ * which is described by cc_op. See CC_OP_* in cpu.h.
  */
-static int rh850_cpu_hw_interrupts_pending(CPURH850State *env)
+void rh850_cpu_compute_flags(CPURH850State *env, uint32_t cc_op)
 {
-    target_ulong pending_interrupts = atomic_read(&env->mip) & env->mie;
+    uint32_t src1 = env->cc_src1;
+    uint32_t src2 = env->cc_src2;
+    uint32_t dst = env->cc_dst;
+
+    switch (cc_op) {
+    case CC_OP_ADD:
+        env->CY_flag = dst < src1;
+        env->OV_flag = ((dst ^ src1) & ~(src1 ^ src2)) >> 31;
+        break;
+    case CC_OP_SUB:
+        env->CY_flag = src1 < src2;
+        env->OV_flag = ((dst ^ src1) & (src1 ^ src2)) >> 31;
+        break;
+    case CC_OP_LOGIC:
+        env->OV_flag = 0;
+        break;
+    default:
+        return;  // CC_OP_FLAGS, flags are already valid
+    }
 
-    target_ulong mie = get_field(env->mstatus, MSTATUS_MIE);
-    target_ulong m_enabled = env->priv < PRV_M || (env->priv == PRV_M && mie);
-    target_ulong enabled_interrupts = pending_interrupts &
-                                      ~env->mideleg & -m_enabled;
+    env->S_flag = dst >> 31;
+    env->Z_flag = dst == 0;
+}
 
-    target_ulong sie = get_field(env->mstatus, MSTATUS_SIE);
-    target_ulong s_enabled = env->priv < PRV_S || (env->priv == PRV_S && sie);
-    enabled_interrupts |= pending_interrupts & env->mideleg &
-                          -s_enabled;
+uint32_t rh850_cpu_get_psw(CPURH850State *env)
+{
+    uint32_t psw = env->Z_flag | (env->S_flag  << 1) | (env->OV_flag << 2);
+    psw |= (env->CY_flag << 3) | (env->SAT_flag << 4) | (env->ID_flag << 5);
+    psw |= (env->EP_flag << 6) | (env->NP_flag << 7) | (env->EBV_flag << 15);
+    psw |= (env->CU0_flag << 16) | (env->CU1_flag << 17);
+    psw |= (env->CU2_flag << 18) | (env->UM_flag << 30);
+    return psw;
+}
 
-    if (enabled_interrupts) {
-        return ctz64(enabled_interrupts); /* since non-zero */
+#ifndef CONFIG_USER_ONLY
+/*
+ * Returns mask of EIINT priority levels, which may be accepted now. Bit n
+ * is set if level n is not masked by PMR and is higher (numerically lower)
+ * than all levels in service, which are recorded in ISPR.
+ */
+static uint32_t rh850_cpu_eiint_prio_mask(CPURH850State *env)
+{
+    uint32_t ispr = env->systemRegs[BANK_ID_BASIC_2][ISPR_IDX2];
+    uint32_t mask = ~env->systemRegs[BANK_ID_BASIC_2][PMR_IDX2] & 0xffff;
+
+    if (ispr) {
+        mask &= (ispr & -ispr) - 1;
+    }
+    return mask;
+}
+
+/* Base address of exception handlers, selected by PSW.EBV */
+static uint32_t rh850_cpu_exception_base(CPURH850State *env)
+{
+    if (env->EBV_flag) {
+        return env->systemRegs[BANK_ID_BASIC_1][EBASE_IDX1];
     } else {
-        return EXCP_NONE; /* indicates no pending interrupt */
+        return env->systemRegs[BANK_ID_BASIC_1][RBASE_IDX1];
     }
 }
 #endif
@@ -67,12 +107,27 @@ static int rh850_cpu_hw_interrupts_pending(CPURH850State *env)
 bool rh850_cpu_exec_interrupt(CPUState *cs, int interrupt_request)
 {
 #if !defined(CONFIG_USER_ONLY)
-    if (interrupt_request & CPU_INTERRUPT_HARD) {
-        RH850CPU *cpu = RH850_CPU(cs);
-        CPURH850State *env = &cpu->env;
-        int interruptno = rh850_cpu_hw_interrupts_pending(env);
-        if (interruptno >= 0) {
-            cs->exception_index = RH850_EXCP_INT_FLAG | interruptno;
+    RH850CPU *cpu = RH850_CPU(cs);
+    CPURH850State *env = &cpu->env;
+
+    if (interrupt_request & CPU_INTERRUPT_FENMI) {
+        cs->exception_index = RH850_EXCP_INT_FLAG | RH850_INT_FENMI;
+        rh850_cpu_do_interrupt(cs);
+        return true;
+    }
+
+    if ((interrupt_request & CPU_INTERRUPT_FEINT) && !env->NP_flag) {
+        cs->exception_index = RH850_EXCP_INT_FLAG | RH850_INT_FEINT;
+        rh850_cpu_do_interrupt(cs);
+        return true;
+    }
+
+    if ((interrupt_request & CPU_INTERRUPT_HARD) &&
+        !env->ID_flag && !env->NP_flag && env->intc) {
+        uint32_t prio_mask = rh850_cpu_eiint_prio_mask(env);
+        if (rh850_intc_get_pending_irq(env->intc, prio_mask,
+                                       NULL, NULL) >= 0) {
+            cs->exception_index = RH850_EXCP_INT_FLAG | RH850_INT_EIINT;
             rh850_cpu_do_interrupt(cs);
             return true;
         }
@@ -81,219 +136,60 @@ bool rh850_cpu_exec_interrupt(CPUState *cs, int interrupt_request)
     return false;
 }
 
-#if !defined(CONFIG_USER_ONLY)
-
-/* get_physical_address - get the physical address for this virtual address
- *
- * Do a page table walk to obtain the physical address corresponding to a
- * virtual address. Returns 0 if the translation was successful
- *
- * Adapted from Spike's mmu_t::translate and mmu_t::walk
- *
+/*
+ * Returns true if there is an interrupt request which releases the CPU
+ * from HALT. EIINT counts only if its priority would let it be accepted,
+ * but PSW.ID and PSW.NP are ignored, as on the real device.
  */
-static int get_physical_address(CPURH850State *env, hwaddr *physical,
-                                int *prot, target_ulong addr,
-                                int access_type, int mmu_idx)
+bool rh850_cpu_has_pending_interrupt(CPUState *cs)
 {
-    /* NOTE: the env->pc value visible here will not be
-     * correct, but the value visible to the exception handler
-     * (rh850_cpu_do_interrupt) is correct */
-
-    int mode = mmu_idx;
+#if !defined(CONFIG_USER_ONLY)
+    RH850CPU *cpu = RH850_CPU(cs);
+    CPURH850State *env = &cpu->env;
 
-    if (mode == PRV_M && access_type != MMU_INST_FETCH) {
-        if (get_field(env->mstatus, MSTATUS_MPRV)) {
-            mode = get_field(env->mstatus, MSTATUS_MPP);
-        }
+    if (cs->interrupt_request & (CPU_INTERRUPT_FENMI | CPU_INTERRUPT_FEINT)) {
+        return true;
     }
-
-    if (mode == PRV_M || !rh850_feature(env, RH850_FEATURE_MMU)) {
-        *physical = addr;
-        *prot = PAGE_READ | PAGE_WRITE | PAGE_EXEC;
-        return TRANSLATE_SUCCESS;
+    if ((cs->interrupt_request & CPU_INTERRUPT_HARD) && env->intc) {
+        return rh850_intc_get_pending_irq(env->intc,
+                                          rh850_cpu_eiint_prio_mask(env),
+                                          NULL, NULL) >= 0;
     }
-
-    *prot = 0;
-
-    target_ulong base;
-    int levels, ptidxbits, ptesize, vm, sum;
-    int mxr = get_field(env->mstatus, MSTATUS_MXR);
-
-    if (env->priv_ver >= PRIV_VERSION_1_10_0) {
-        base = get_field(env->satp, SATP_PPN) << PGSHIFT;
-        sum = get_field(env->mstatus, MSTATUS_SUM);
-        vm = get_field(env->satp, SATP_MODE);
-        switch (vm) {
-        case VM_1_10_SV32:
-          levels = 2; ptidxbits = 10; ptesize = 4; break;
-        case VM_1_10_SV39:
-          levels = 3; ptidxbits = 9; ptesize = 8; break;
-        case VM_1_10_SV48:
-          levels = 4; ptidxbits = 9; ptesize = 8; break;
-        case VM_1_10_SV57:
-          levels = 5; ptidxbits = 9; ptesize = 8; break;
-        case VM_1_10_MBARE:
-            *physical = addr;
-            *prot = PAGE_READ | PAGE_WRITE | PAGE_EXEC;
-            return TRANSLATE_SUCCESS;
-        default:
-          g_assert_not_reached();
-        }
-    } else {
-        base = env->sptbr << PGSHIFT;
-        sum = !get_field(env->mstatus, MSTATUS_PUM);
-        vm = get_field(env->mstatus, MSTATUS_VM);
-        switch (vm) {
-        case VM_1_09_SV32:
-          levels = 2; ptidxbits = 10; ptesize = 4; break;
-        case VM_1_09_SV39:
-          levels = 3; ptidxbits = 9; ptesize = 8; break;
-        case VM_1_09_SV48:
-          levels = 4; ptidxbits = 9; ptesize = 8; break;
-        case VM_1_09_MBARE:
-            *physical = addr;
-            *prot = PAGE_READ | PAGE_WRITE | PAGE_EXEC;
-            return TRANSLATE_SUCCESS;
-        default:
-          g_assert_not_reached();
-        }
-    }
-
-    CPUState *cs = CPU(rh850_env_get_cpu(env));
-    int va_bits = PGSHIFT + levels * ptidxbits;
-    target_ulong mask = (1L << (TARGET_LONG_BITS - (va_bits - 1))) - 1;
-    target_ulong masked_msbs = (addr >> (va_bits - 1)) & mask;
-    if (masked_msbs != 0 && masked_msbs != mask) {
-        return TRANSLATE_FAIL;
-    }
-
-    int ptshift = (levels - 1) * ptidxbits;
-    int i;
-
-#if !TCG_OVERSIZED_GUEST
-restart:
-#endif
-    for (i = 0; i < levels; i++, ptshift -= ptidxbits) {
-        target_ulong idx = (addr >> (PGSHIFT + ptshift)) &
-                           ((1 << ptidxbits) - 1);
-
-        /* check that physical address of PTE is legal */
-        target_ulong pte_addr = base + idx * ptesize;
-#if defined(TARGET_RH850)
-        target_ulong pte = ldl_phys(cs->as, pte_addr);
-#endif
-        target_ulong ppn = pte >> PTE_PPN_SHIFT;
-
-        if (PTE_TABLE(pte)) { /* next level of page table */
-            base = ppn << PGSHIFT;
-        } else if ((pte & PTE_U) ? (mode == PRV_S) && !sum : !(mode == PRV_S)) {
-            break;
-        } else if (!(pte & PTE_V) || (!(pte & PTE_R) && (pte & PTE_W))) {
-            break;
-        } else if (access_type == MMU_INST_FETCH ? !(pte & PTE_X) :
-                  access_type == MMU_DATA_LOAD ?  !(pte & PTE_R) &&
-                  !(mxr && (pte & PTE_X)) : !((pte & PTE_R) && (pte & PTE_W))) {
-            break;
-        } else {
-            /* if necessary, set accessed and dirty bits. */
-            target_ulong updated_pte = pte | PTE_A |
-                (access_type == MMU_DATA_STORE ? PTE_D : 0);
-
-            /* Page table updates need to be atomic with MTTCG enabled */
-            if (updated_pte != pte) {
-                /* if accessed or dirty bits need updating, and the PTE is
-                 * in RAM, then we do so atomically with a compare and swap.
-                 * if the PTE is in IO space, then it can't be updated.
-                 * if the PTE changed, then we must re-walk the page table
-                   as the PTE is no longer valid */
-                MemoryRegion *mr;
-                hwaddr l = sizeof(target_ulong), addr1;
-                mr = address_space_translate(cs->as, pte_addr,
-                    &addr1, &l, false, MEMTXATTRS_UNSPECIFIED);
-                if (memory_access_is_direct(mr, true)) {
-                    target_ulong *pte_pa =
-                        qemu_map_ram_ptr(mr->ram_block, addr1);
-#if TCG_OVERSIZED_GUEST
-                    /* MTTCG is not enabled on oversized TCG guests so
-                     * page table updates do not need to be atomic */
-                    *pte_pa = pte = updated_pte;
-#else
-                    target_ulong old_pte =
-                        atomic_cmpxchg(pte_pa, pte, updated_pte);
-                    if (old_pte != pte) {
-                        goto restart;
-                    } else {
-                        pte = updated_pte;
-                    }
 #endif
-                } else {
-                    /* misconfigured PTE in ROM (AD bits are not preset) or
-                     * PTE is in IO space and can't be updated atomically */
-                    return TRANSLATE_FAIL;
-                }
-            }
-
-            /* for superpage mappings, make a fake leaf PTE for the TLB's
-               benefit. */
-            target_ulong vpn = addr >> PGSHIFT;
-            *physical = (ppn | (vpn & ((1L << ptshift) - 1))) << PGSHIFT;
-
-            if ((pte & PTE_R)) {
-                *prot |= PAGE_READ;
-            }
-            if ((pte & PTE_X)) {
-                *prot |= PAGE_EXEC;
-            }
-           /* only add write permission on stores or if the page
-              is already dirty, so that we don't miss further
-              page table walks to update the dirty bit */
-            if ((pte & PTE_W) &&
-                    (access_type == MMU_DATA_STORE || (pte & PTE_D))) {
-                *prot |= PAGE_WRITE;
-            }
-            return TRANSLATE_SUCCESS;
-        }
-    }
-    return TRANSLATE_FAIL;
+    return false;
 }
 
-static void raise_mmu_exception(CPURH850State *env, target_ulong address,
-                                MMUAccessType access_type)
+#if !defined(CONFIG_USER_ONLY)
+
+/*
+ * RH850 has no MMU, virtual and physical addresses are the same. MPU
+ * violations are FE level exceptions MIP and MDP, MEA holds the address
+ * and MEI describes the access.
+ */
+static void raise_mpu_exception(CPURH850State *env, target_ulong address,
+                                int size, MMUAccessType access_type)
 {
     CPUState *cs = CPU(rh850_env_get_cpu(env));
-    int page_fault_exceptions =
-        (env->priv_ver >= PRIV_VERSION_1_10_0) &&
-        get_field(env->satp, SATP_MODE) != VM_1_10_MBARE;
-    switch (access_type) {
-    case MMU_INST_FETCH:
-        cs->exception_index = page_fault_exceptions ?
-            RH850_EXCP_INST_PAGE_FAULT : RH850_EXCP_INST_ACCESS_FAULT;
-        break;
-    case MMU_DATA_LOAD:
-        cs->exception_index = page_fault_exceptions ?
-            RH850_EXCP_LOAD_PAGE_FAULT : RH850_EXCP_LOAD_ACCESS_FAULT;
-        break;
-    case MMU_DATA_STORE:
-        cs->exception_index = page_fault_exceptions ?
-            RH850_EXCP_STORE_PAGE_FAULT : RH850_EXCP_STORE_AMO_ACCESS_FAULT;
-        break;
-    default:
-        g_assert_not_reached();
+    uint32_t mei = 0;
+
+    if (access_type == MMU_INST_FETCH) {
+        cs->exception_index = RH850_EXCP_MIP;
+    } else {
+        cs->exception_index = RH850_EXCP_MDP;
+        if (size > 0) {
+            mei = ctz32(size) << 8;             /* MEI.DS */
+        }
+        if (access_type == MMU_DATA_STORE) {
+            mei |= 1;                           /* MEI.RW */
+        }
     }
-    env->badaddr = address;
+    env->systemRegs[BANK_ID_BASIC_2][MEA_IDX2] = address;
+    env->systemRegs[BANK_ID_BASIC_2][MEI_IDX2] = mei;
 }
 
 hwaddr rh850_cpu_get_phys_page_debug(CPUState *cs, vaddr addr)
 {
-    RH850CPU *cpu = RH850_CPU(cs);
-    hwaddr phys_addr;
-    int prot;
-    int mmu_idx = cpu_mmu_index(&cpu->env, false);
-
-    if (get_physical_address(&cpu->env, &phys_addr, &prot, addr, 0, mmu_idx)) {
-        return -1;
-    }
-    return phys_addr;
+    return addr & TARGET_PAGE_MASK;
 }
 
 void rh850_cpu_do_unaligned_access(CPUState *cs, vaddr addr,
@@ -327,7 +223,6 @@ int rh850_cpu_handle_mmu_fault(CPUState *cs, vaddr address, int size,
     RH850CPU *cpu = RH850_CPU(cs);
     CPURH850State *env = &cpu->env;
 #if !defined(CONFIG_USER_ONLY)
-    hwaddr pa = 0;
     int prot;
 #endif
     int ret = TRANSLATE_FAIL;
@@ -337,19 +232,37 @@ int rh850_cpu_handle_mmu_fault(CPUState *cs, vaddr address, int size,
              %d\n", __func__, env->pc, address, rw, mmu_idx);
 
 #if !defined(CONFIG_USER_ONLY)
-    ret = get_physical_address(env, &pa, &prot, address, rw, mmu_idx);
+    target_ulong page = address & TARGET_PAGE_MASK;
+    uint32_t first, last;
+    bool whole_page;
+
+    prot = rh850_mpu_get_prot(env, address, mmu_idx, &first, &last);
     qemu_log_mask(CPU_LOG_MMU,
-            "%s address=%" VADDR_PRIx " ret %d physical " TARGET_FMT_plx
-             " prot %d\n", __func__, address, ret, pa, prot);
-    if (!pmp_hart_has_privs(env, pa, TARGET_PAGE_SIZE, 1 << rw)) {
-        ret = TRANSLATE_FAIL;
+            "%s address=%" VADDR_PRIx " segment %08x-%08x prot %d\n",
+            __func__, address, first, last, prot);
+    whole_page = first <= page && last >= page + TARGET_PAGE_SIZE - 1;
+
+    /* An access may cross into the next segment */
+    while (size > 0 && last != UINT32_MAX && last < address + size - 1) {
+        prot &= rh850_mpu_get_prot(env, last + 1, mmu_idx, &first, &last);
+    }
+
+    if (!(prot & (1 << rw))) {
+        raise_mpu_exception(env, address, size, rw);
+        return TRANSLATE_FAIL;
     }
-    if (ret == TRANSLATE_SUCCESS) {
-        tlb_set_page(cs, address & TARGET_PAGE_MASK, pa & TARGET_PAGE_MASK,
-                     prot, mmu_idx, TARGET_PAGE_SIZE);
-    } else if (ret == TRANSLATE_FAIL) {
-        raise_mmu_exception(env, address, rw);
+
+    if (whole_page) {
+        tlb_set_page(cs, page, page, prot, mmu_idx, TARGET_PAGE_SIZE);
+    } else {
+        /*
+         * The page straddles a region boundary. A size smaller than a page
+         * makes QEMU repeat the check on every access to this page, while
+         * other pages remain cached.
+         */
+        tlb_set_page(cs, page, page, prot, mmu_idx, 1);
     }
+    ret = TRANSLATE_SUCCESS;
 #else
     switch (rw) {
     case MMU_INST_FETCH:
@@ -385,7 +298,115 @@ void rh850_cpu_do_interrupt(CPUState *cs)
                 rh850_excp_names[log_cause], env->pc);
         }
     }
-// exceptions are not yet implemented on rh850
+
+    switch (cs->exception_index) {
+    case RH850_EXCP_FPE:
+        /* EI level exception, env->pc points to the FPU instruction */
+        env->systemRegs[BANK_ID_BASIC_0][FPEPC_IDX] = env->pc;
+        env->systemRegs[BANK_ID_BASIC_0][EIPC_IDX] = env->pc;
+        env->systemRegs[BANK_ID_BASIC_0][EIPSW_IDX] = rh850_cpu_get_psw(env);
+        env->systemRegs[BANK_ID_BASIC_0][EIIC_IDX] = 0x71;
+        env->UM_flag = 0;
+        env->EP_flag = 1;
+        env->ID_flag = 1;
+        env->pc = (rh850_cpu_exception_base(env) & RH850_BASE_MASK) + 0x70;
+        break;
+
+    case RH850_EXCP_MIP:
+    case RH850_EXCP_MDP:
+        /* FE level exception, env->pc points to the faulting instruction */
+        env->systemRegs[BANK_ID_BASIC_0][FEPC_IDX] = env->pc;
+        env->systemRegs[BANK_ID_BASIC_0][FEPSW_IDX] = rh850_cpu_get_psw(env);
+        env->systemRegs[BANK_ID_BASIC_0][FEIC_IDX] =
+            cs->exception_index == RH850_EXCP_MIP ? RH850_FEIC_MIP
+                                                  : RH850_FEIC_MDP;
+        env->UM_flag = 0;
+        env->EP_flag = 1;
+        env->NP_flag = 1;
+        env->ID_flag = 1;
+        env->pc = (rh850_cpu_exception_base(env) & RH850_BASE_MASK) + 0x90;
+        break;
+
+    case RH850_EXCP_SEMIHOST:
+        /* env->pc points to DBTRAP, the result is returned in r10 */
+        env->gpRegs[10] = do_common_semihosting(cs);
+        env->pc += 2;
+        break;
+
+    case RH850_EXCP_INT_FLAG | RH850_INT_EIINT: {
+        /* env->pc points to the next instruction to be executed */
+        uint32_t base = rh850_cpu_exception_base(env);
+        bool table_ref;
+        int prio;
+        int irq = rh850_intc_get_pending_irq(env->intc,
+                                             rh850_cpu_eiint_prio_mask(env),
+                                             &prio, &table_ref);
+        if (irq < 0) {
+            break;  // request was withdrawn in the meantime
+        }
+        rh850_intc_acknowledge_irq(env->intc, irq);
+
+        env->systemRegs[BANK_ID_BASIC_0][EIPC_IDX] = env->pc;
+        env->systemRegs[BANK_ID_BASIC_0][EIPSW_IDX] = rh850_cpu_get_psw(env);
+        env->systemRegs[BANK_ID_BASIC_0][EIIC_IDX] = RH850_EIIC_EIINT_BASE + irq;
+        env->UM_flag = 0;
+        env->EP_flag = 0;
+        env->ID_flag = 1;
+        if (!(env->systemRegs[BANK_ID_BASIC_2][INTCFG_IDX2] & INTCFG_ISPC)) {
+            env->systemRegs[BANK_ID_BASIC_2][ISPR_IDX2] |= 1 << prio;
+        }
+
+        if (table_ref) {
+            uint32_t intbp = env->systemRegs[BANK_ID_BASIC_1][INTBP_IDX1];
+            env->pc = cpu_ldl_data(env, intbp + irq * 4);
+        } else if (base & RH850_BASE_RINT) {
+            env->pc = (base & RH850_BASE_MASK) + 0x100;
+        } else {
+            env->pc = (base & RH850_BASE_MASK) + 0x100 + prio * 0x10;
+        }
+        break;
+    }
+
+    case RH850_EXCP_RIE:
+    case RH850_EXCP_UCPOP: {
+        /* FE level exceptions, cause code equals handler offset */
+        uint32_t offset = cs->exception_index == RH850_EXCP_RIE ? 0x60 : 0x80;
+
+        env->systemRegs[BANK_ID_BASIC_0][FEPC_IDX] = env->pc;
+        env->systemRegs[BANK_ID_BASIC_0][FEPSW_IDX] = rh850_cpu_get_psw(env);
+        env->systemRegs[BANK_ID_BASIC_0][FEIC_IDX] = offset;
+        env->UM_flag = 0;
+        env->EP_flag = 1;
+        env->NP_flag = 1;
+        env->ID_flag = 1;
+        env->pc = (rh850_cpu_exception_base(env) & RH850_BASE_MASK) + offset;
+        break;
+    }
+
+    case RH850_EXCP_INT_FLAG | RH850_INT_FENMI:
+        /* FENMI is edge triggered, consume the request */
+        cpu_reset_interrupt(cs, CPU_INTERRUPT_FENMI);
+        /* fall through */
+    case RH850_EXCP_INT_FLAG | RH850_INT_FEINT: {
+        int cause = cs->exception_index & RH850_EXCP_INT_MASK;
+        uint32_t offset = cause == RH850_INT_FENMI ? RH850_FEIC_FENMI
+                                                   : RH850_FEIC_FEINT;
+
+        env->systemRegs[BANK_ID_BASIC_0][FEPC_IDX] = env->pc;
+        env->systemRegs[BANK_ID_BASIC_0][FEPSW_IDX] = rh850_cpu_get_psw(env);
+        env->systemRegs[BANK_ID_BASIC_0][FEIC_IDX] = offset;
+        env->UM_flag = 0;
+        env->EP_flag = 0;
+        env->NP_flag = 1;
+        env->ID_flag = 1;
+        env->pc = (rh850_cpu_exception_base(env) & RH850_BASE_MASK) + offset;
+        break;
+    }
+
+    default:
+        // other exceptions are not yet implemented on rh850
+        break;
+    }
 
 //    target_ulong fixed_cause = 0;
 //    if (cs->exception_index & (RH850_EXCP_INT_FLAG)) {
@@ -1,70 +1,56 @@
 /* Exceptions */
 DEF_HELPER_2(raise_exception, noreturn, env, i32)
+DEF_HELPER_1(halt, noreturn, env)
+DEF_HELPER_1(snooze, noreturn, env)
 
-/* Floating Point - rounding mode */
-DEF_HELPER_FLAGS_2(set_rounding_mode, TCG_CALL_NO_WG, void, env, i32)
+/* Floating Point - FPSR, FPST, FPCC and FPCFG access */
+DEF_HELPER_2(stsr_fpu, i32, env, i32)
+DEF_HELPER_3(ldsr_fpu, void, env, i32, i32)
 
-/* Floating Point - fused */
-DEF_HELPER_FLAGS_4(fmadd_s, TCG_CALL_NO_RWG, i64, env, i64, i64, i64)
-DEF_HELPER_FLAGS_4(fmadd_d, TCG_CALL_NO_RWG, i64, env, i64, i64, i64)
-DEF_HELPER_FLAGS_4(fmsub_s, TCG_CALL_NO_RWG, i64, env, i64, i64, i64)
-DEF_HELPER_FLAGS_4(fmsub_d, TCG_CALL_NO_RWG, i64, env, i64, i64, i64)
-DEF_HELPER_FLAGS_4(fnmsub_s, TCG_CALL_NO_RWG, i64, env, i64, i64, i64)
-DEF_HELPER_FLAGS_4(fnmsub_d, TCG_CALL_NO_RWG, i64, env, i64, i64, i64)
-DEF_HELPER_FLAGS_4(fnmadd_s, TCG_CALL_NO_RWG, i64, env, i64, i64, i64)
-DEF_HELPER_FLAGS_4(fnmadd_d, TCG_CALL_NO_RWG, i64, env, i64, i64, i64)
+/* MPU - MPM, MPRC, MPLAn, MPUAn, MPATn and ASID access */
+DEF_HELPER_4(ldsr_mpu, void, env, i32, i32, i32)
+
+/*
+ * FPU helpers update FPSR and may raise FPU exception, so they can not be
+ * declared as TCG_CALL_NO_WG.
+ */
 
 /* Floating Point - Single Precision */
-DEF_HELPER_FLAGS_3(fadd_s, TCG_CALL_NO_RWG, i64, env, i64, i64)
-DEF_HELPER_FLAGS_3(fsub_s, TCG_CALL_NO_RWG, i64, env, i64, i64)
-DEF_HELPER_FLAGS_3(fmul_s, TCG_CALL_NO_RWG, i64, env, i64, i64)
-DEF_HELPER_FLAGS_3(fdiv_s, TCG_CALL_NO_RWG, i64, env, i64, i64)
-DEF_HELPER_FLAGS_3(fmin_s, TCG_CALL_NO_RWG, i64, env, i64, i64)
-DEF_HELPER_FLAGS_3(fmax_s, TCG_CALL_NO_RWG, i64, env, i64, i64)
-DEF_HELPER_FLAGS_2(fsqrt_s, TCG_CALL_NO_RWG, i64, env, i64)
-DEF_HELPER_FLAGS_3(fle_s, TCG_CALL_NO_RWG, tl, env, i64, i64)
-DEF_HELPER_FLAGS_3(flt_s, TCG_CALL_NO_RWG, tl, env, i64, i64)
-DEF_HELPER_FLAGS_3(feq_s, TCG_CALL_NO_RWG, tl, env, i64, i64)
-DEF_HELPER_FLAGS_2(fcvt_w_s, TCG_CALL_NO_RWG, tl, env, i64)
-DEF_HELPER_FLAGS_2(fcvt_wu_s, TCG_CALL_NO_RWG, tl, env, i64)
-#if defined(TARGET_RH85064)
-DEF_HELPER_FLAGS_2(fcvt_l_s, TCG_CALL_NO_RWG, tl, env, i64)
-DEF_HELPER_FLAGS_2(fcvt_lu_s, TCG_CALL_NO_RWG, tl, env, i64)
-#endif
-DEF_HELPER_FLAGS_2(fcvt_s_w, TCG_CALL_NO_RWG, i64, env, tl)
-DEF_HELPER_FLAGS_2(fcvt_s_wu, TCG_CALL_NO_RWG, i64, env, tl)
-#if defined(TARGET_RH85064)
-DEF_HELPER_FLAGS_2(fcvt_s_l, TCG_CALL_NO_RWG, i64, env, tl)
-DEF_HELPER_FLAGS_2(fcvt_s_lu, TCG_CALL_NO_RWG, i64, env, tl)
-#endif
-DEF_HELPER_FLAGS_1(fclass_s, TCG_CALL_NO_RWG_SE, tl, i64)
+DEF_HELPER_3(addf_s, i32, env, i32, i32)
+DEF_HELPER_3(subf_s, i32, env, i32, i32)
+DEF_HELPER_3(mulf_s, i32, env, i32, i32)
+DEF_HELPER_3(divf_s, i32, env, i32, i32)
+DEF_HELPER_3(maxf_s, i32, env, i32, i32)
+DEF_HELPER_3(minf_s, i32, env, i32, i32)
+DEF_HELPER_5(fmaf_s, i32, env, i32, i32, i32, i32)
+DEF_HELPER_2(sqrtf_s, i32, env, i32)
+DEF_HELPER_2(recipf_s, i32, env, i32)
+DEF_HELPER_2(rsqrtf_s, i32, env, i32)
+DEF_HELPER_3(cvtf_sw, i32, env, i32, i32)
+DEF_HELPER_3(cvtf_sl, i64, env, i32, i32)
+DEF_HELPER_3(cvtf_ws, i32, env, i32, i32)
+DEF_HELPER_3(cvtf_ls, i32, env, i64, i32)
+DEF_HELPER_2(cvtf_hs, i32, env, i32)
+DEF_HELPER_2(cvtf_sh, i32, env, i32)
+DEF_HELPER_5(cmpf_s, void, env, i32, i32, i32, i32)
 
 /* Floating Point - Double Precision */
-DEF_HELPER_FLAGS_3(fadd_d, TCG_CALL_NO_RWG, i64, env, i64, i64)
-DEF_HELPER_FLAGS_3(fsub_d, TCG_CALL_NO_RWG, i64, env, i64, i64)
-DEF_HELPER_FLAGS_3(fmul_d, TCG_CALL_NO_RWG, i64, env, i64, i64)
-DEF_HELPER_FLAGS_3(fdiv_d, TCG_CALL_NO_RWG, i64, env, i64, i64)
-DEF_HELPER_FLAGS_3(fmin_d, TCG_CALL_NO_RWG, i64, env, i64, i64)
-DEF_HELPER_FLAGS_3(fmax_d, TCG_CALL_NO_RWG, i64, env, i64, i64)
-DEF_HELPER_FLAGS_2(fcvt_s_d, TCG_CALL_NO_RWG, i64, env, i64)
-DEF_HELPER_FLAGS_2(fcvt_d_s, TCG_CALL_NO_RWG, i64, env, i64)
-DEF_HELPER_FLAGS_2(fsqrt_d, TCG_CALL_NO_RWG, i64, env, i64)
-DEF_HELPER_FLAGS_3(fle_d, TCG_CALL_NO_RWG, tl, env, i64, i64)
-DEF_HELPER_FLAGS_3(flt_d, TCG_CALL_NO_RWG, tl, env, i64, i64)
-DEF_HELPER_FLAGS_3(feq_d, TCG_CALL_NO_RWG, tl, env, i64, i64)
-DEF_HELPER_FLAGS_2(fcvt_w_d, TCG_CALL_NO_RWG, tl, env, i64)
-DEF_HELPER_FLAGS_2(fcvt_wu_d, TCG_CALL_NO_RWG, tl, env, i64)
-#if defined(TARGET_RH85064)
-DEF_HELPER_FLAGS_2(fcvt_l_d, TCG_CALL_NO_RWG, tl, env, i64)
-DEF_HELPER_FLAGS_2(fcvt_lu_d, TCG_CALL_NO_RWG, tl, env, i64)
-#endif
-DEF_HELPER_FLAGS_2(fcvt_d_w, TCG_CALL_NO_RWG, i64, env, tl)
-DEF_HELPER_FLAGS_2(fcvt_d_wu, TCG_CALL_NO_RWG, i64, env, tl)
-#if defined(TARGET_RH85064)
-DEF_HELPER_FLAGS_2(fcvt_d_l, TCG_CALL_NO_RWG, i64, env, tl)
-DEF_HELPER_FLAGS_2(fcvt_d_lu, TCG_CALL_NO_RWG, i64, env, tl)
-#endif
-DEF_HELPER_FLAGS_1(fclass_d, TCG_CALL_NO_RWG_SE, tl, i64)
+DEF_HELPER_3(addf_d, i64, env, i64, i64)
+DEF_HELPER_3(subf_d, i64, env, i64, i64)
+DEF_HELPER_3(mulf_d, i64, env, i64, i64)
+DEF_HELPER_3(divf_d, i64, env, i64, i64)
+DEF_HELPER_3(maxf_d, i64, env, i64, i64)
+DEF_HELPER_3(minf_d, i64, env, i64, i64)
+DEF_HELPER_2(sqrtf_d, i64, env, i64)
+DEF_HELPER_2(recipf_d, i64, env, i64)
+DEF_HELPER_2(rsqrtf_d, i64, env, i64)
+DEF_HELPER_3(cvtf_dw, i32, env, i64, i32)
+DEF_HELPER_3(cvtf_dl, i64, env, i64, i32)
+DEF_HELPER_3(cvtf_wd, i64, env, i32, i32)
+DEF_HELPER_3(cvtf_ld, i64, env, i64, i32)
+DEF_HELPER_2(cvtf_sd, i64, env, i32)
+DEF_HELPER_2(cvtf_ds, i32, env, i64)
+DEF_HELPER_5(cmpf_d, void, env, i64, i64, i32, i32)
 
 /* Special functions */
 //DEF_HELPER_3(csrrw, tl, env, tl, tl)
@@ -258,7 +258,48 @@ enum {
 	OPC_RH850_MUL_INSTS		=	(0x4 << 23),	// 0100 this is also for SASF
 	OPC_RH850_FORMAT_XI		=	(0x5 << 23),	// 0101
 	OPC_RH850_FORMAT_XII	=	(0x6 << 23),	// 0110
-	OPC_RH850_ADDIT_ARITH	=	(0x7 << 23)		// 0111
+	OPC_RH850_ADDIT_ARITH	=	(0x7 << 23),	// 0111
+	OPC_RH850_FPU_GROUP_0	=	(0x8 << 23),	// 1000
+	OPC_RH850_FPU_GROUP_1	=	(0x9 << 23)		// 1001, FMAF.S, FMSF.S, FNMAF.S, FNMSF.S
+};
+
+#define MASK_OP_FPU(op)	extract32(op, 16, 11)	// sub-opcode in bits 26-16
+#define OPC_RH850_FPU_CMP_MASK	0x7F0			// fcbit and fcond are not part of the opcode
+enum {
+	OPC_RH850_CMOVF_S		= 0x400,	// also TRFSR
+	OPC_RH850_CMOVF_D		= 0x410,
+	OPC_RH850_CMPF_S		= 0x420,
+	OPC_RH850_CMPF_D		= 0x430,
+
+	// reg1 field selects ROUNDF, TRNCF, CEILF, FLOORF, CVTF and unsigned variants
+	OPC_RH850_CVTF_S_W		= 0x440,
+	OPC_RH850_CVTF_TO_S		= 0x442,	// CVTF.WS, CVTF.LS, CVTF.HS, CVTF.SH, CVTF.UWS, CVTF.ULS
+	OPC_RH850_CVTF_S_L		= 0x444,
+	OPC_RH850_ABSF_NEGF_S	= 0x448,
+	OPC_RH850_SQRTF_S		= 0x44E,	// also RECIPF.S, RSQRTF.S
+	OPC_RH850_CVTF_D_W		= 0x450,
+	OPC_RH850_CVTF_TO_D		= 0x452,	// CVTF.WD, CVTF.LD, CVTF.SD, CVTF.DS, CVTF.UWD, CVTF.ULD
+	OPC_RH850_CVTF_D_L		= 0x454,
+	OPC_RH850_ABSF_NEGF_D	= 0x458,
+	OPC_RH850_SQRTF_D		= 0x45E,	// also RECIPF.D, RSQRTF.D
+
+	OPC_RH850_ADDF_S		= 0x460,
+	OPC_RH850_SUBF_S		= 0x462,
+	OPC_RH850_MULF_S		= 0x464,
+	OPC_RH850_MAXF_S		= 0x468,
+	OPC_RH850_MINF_S		= 0x46A,
+	OPC_RH850_DIVF_S		= 0x46E,
+	OPC_RH850_ADDF_D		= 0x470,
+	OPC_RH850_SUBF_D		= 0x472,
+	OPC_RH850_MULF_D		= 0x474,
+	OPC_RH850_MAXF_D		= 0x478,
+	OPC_RH850_MINF_D		= 0x47A,
+	OPC_RH850_DIVF_D		= 0x47E,
+
+	OPC_RH850_FMAF_S		= 0x4E0,
+	OPC_RH850_FMSF_S		= 0x4E2,
+	OPC_RH850_FNMAF_S		= 0x4E4,
+	OPC_RH850_FNMSF_S		= 0x4E6,
 };
 
 #define MASK_OP_FORMAT_IX(op) (op & (0x3 << 21))   //0001 on b26-b23
@@ -0,0 +1,76 @@
+/*
+ * RH850 CPU state for migration and snapshots
+ *
+ * Copyright (c) 2021 iSYSTEM Labs d.o.o.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2 or later, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "qemu/osdep.h"
+#include "cpu.h"
+#include "migration/cpu.h"
+
+static int rh850_cpu_pre_save(void *opaque)
+{
+    RH850CPU *cpu = opaque;
+    CPURH850State *env = &cpu->env;
+
+    /* FPSR.XP flags are kept in fp_status */
+    env->systemRegs[BANK_ID_BASIC_0][FPSR_IDX] = cpu_rh850_get_fpsr(env);
+    return 0;
+}
+
+static int rh850_cpu_post_load(void *opaque, int version_id)
+{
+    RH850CPU *cpu = opaque;
+    CPURH850State *env = &cpu->env;
+
+    cpu_rh850_set_fpsr(env, env->systemRegs[BANK_ID_BASIC_0][FPSR_IDX]);
+    rh850_mpu_update(env);
+    return 0;
+}
+
+const VMStateDescription vmstate_rh850_cpu = {
+    .name = "cpu",
+    .version_id = 1,
+    .minimum_version_id = 1,
+    .pre_save = rh850_cpu_pre_save,
+    .post_load = rh850_cpu_post_load,
+    .fields = (VMStateField[]) {
+        VMSTATE_UINTTL_ARRAY(env.gpRegs, RH850CPU, NUM_GP_REGS),
+        VMSTATE_UINTTL(env.pc, RH850CPU),
+        VMSTATE_UINTTL_ARRAY(env.sysDatabuffRegs, RH850CPU, 1),
+        VMSTATE_UINT32_2DARRAY(env.systemRegs, RH850CPU, NUM_SYS_REG_BANKS,
+                               MAX_SYS_REGS_IN_BANK),
+        VMSTATE_UINT32(env.Z_flag, RH850CPU),
+        VMSTATE_UINT32(env.S_flag, RH850CPU),
+        VMSTATE_UINT32(env.OV_flag, RH850CPU),
+        VMSTATE_UINT32(env.CY_flag, RH850CPU),
+        VMSTATE_UINT32(env.SAT_flag, RH850CPU),
+        VMSTATE_UINT32(env.ID_flag, RH850CPU),
+        VMSTATE_UINT32(env.EP_flag, RH850CPU),
+        VMSTATE_UINT32(env.NP_flag, RH850CPU),
+        VMSTATE_UINT32(env.EBV_flag, RH850CPU),
+        VMSTATE_UINT32(env.CU0_flag, RH850CPU),
+        VMSTATE_UINT32(env.CU1_flag, RH850CPU),
+        VMSTATE_UINT32(env.CU2_flag, RH850CPU),
+        VMSTATE_UINT32(env.UM_flag, RH850CPU),
+        VMSTATE_UINTTL(env.cpu_LLbit, RH850CPU),
+        VMSTATE_UINTTL(env.cpu_LLAddress, RH850CPU),
+        VMSTATE_UINTTL(env.cpu_LLValue, RH850CPU),
+        VMSTATE_UINT64(env.cycles, RH850CPU),
+        VMSTATE_INT64(env.snooze_deadline, RH850CPU),
+        VMSTATE_TIMER_PTR(env.snooze_timer, RH850CPU),
+        VMSTATE_END_OF_LIST()
+    }
+};
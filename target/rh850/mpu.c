@@ -0,0 +1,195 @@
+/*
+ * RH850 memory protection unit (MPU)
+ *
+ * Datasheet: RH850G3K User's Manual: Software
+ *            (R01US0165EJ0110), section 5 Memory Management
+ *
+ * Copyright (c) 2021 iSYSTEM Labs d.o.o.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2 or later, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "qemu/osdep.h"
+#include "cpu.h"
+#include "exec/exec-all.h"
+#include "exec/helper-proto.h"
+
+typedef struct MPURegion {
+    uint64_t first;
+    uint64_t end;               /* first address after the region */
+    uint8_t prot[2];
+} MPURegion;
+
+/*
+ * UR, UW and UX bits of MPAT are in the same order as PAGE_READ, PAGE_WRITE
+ * and PAGE_EXEC, and SR, SW and SX follow them.
+ */
+static int mpat_prot(uint32_t mpat, int mmu_idx)
+{
+    return (mmu_idx == MMU_UM_IDX ? mpat : mpat >> 3) & PAGE_BITS;
+}
+
+static target_ulong *mpu_region_regs(CPURH850State *env, int n)
+{
+    return &env->systemRegs[BANK_ID_MPU_REGIONS + n / MPU_REGIONS_PER_BANK]
+                           [(n % MPU_REGIONS_PER_BANK) * 4];
+}
+
+static int compare_bounds(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return x < y ? -1 : x > y;
+}
+
+bool rh850_mpu_sysreg(int selID, int regID)
+{
+    if (selID == BANK_ID_BASIC_2) {
+        return regID == ASID_IDX2;
+    }
+    if (selID == BANK_ID_MPU_CTRL) {
+        return regID == MPM_IDX5 || regID == MPRC_IDX5;
+    }
+    return selID >= BANK_ID_MPU_REGIONS && selID < NUM_SYS_REG_BANKS;
+}
+
+void rh850_mpu_update(CPURH850State *env)
+{
+    RH850MPUState *mpu = &env->mpu;
+    uint32_t mpm = env->systemRegs[BANK_ID_MPU_CTRL][MPM_IDX5];
+    uint32_t asid = env->systemRegs[BANK_ID_BASIC_2][ASID_IDX2] & 0x3ff;
+    MPURegion regions[RH850_MPU_NUM_REGIONS];
+    uint64_t bounds[2 * RH850_MPU_NUM_REGIONS + 1];
+    int num_regions = 0;
+    int num_bounds = 0;
+    uint32_t mprc = 0;
+    int n, i;
+
+    for (n = 0; n < RH850_MPU_NUM_REGIONS; n++) {
+        target_ulong *regs = mpu_region_regs(env, n);
+        uint32_t mpat = regs[2];
+        MPURegion *r = &regions[num_regions];
+
+        if (!(mpat & MPAT_E)) {
+            continue;
+        }
+        mprc |= 1 << n;
+        if (!(mpat & MPAT_G) &&
+            ((mpat & MPAT_ASID_MASK) >> MPAT_ASID_SHIFT) != asid) {
+            continue;
+        }
+        /* The upper limit is inclusive, both are aligned to 4 bytes */
+        r->first = regs[0] & ~3;
+        r->end = (uint64_t)(regs[1] | 3) + 1;
+        if (r->first >= r->end) {
+            continue;
+        }
+        r->prot[MMU_SV_IDX] = mpat_prot(mpat, MMU_SV_IDX);
+        r->prot[MMU_UM_IDX] = mpat_prot(mpat, MMU_UM_IDX);
+        bounds[num_bounds++] = r->first;
+        bounds[num_bounds++] = r->end;
+        num_regions++;
+    }
+    env->systemRegs[BANK_ID_MPU_CTRL][MPRC_IDX5] = mprc;
+
+    bounds[num_bounds++] = 0;
+    qsort(bounds, num_bounds, sizeof(bounds[0]), compare_bounds);
+
+    mpu->num_segments = 0;
+    for (i = 0; i < num_bounds && bounds[i] <= UINT32_MAX; i++) {
+        uint8_t prot[2] = { 0, 0 };
+        RH850MPUSegment *seg;
+
+        if (i > 0 && bounds[i] == bounds[i - 1]) {
+            continue;
+        }
+        if (!(mpm & MPM_MPE)) {
+            prot[MMU_SV_IDX] = prot[MMU_UM_IDX] = PAGE_BITS;
+        } else {
+            /* Overlapping regions add their permissions */
+            for (n = 0; n < num_regions; n++) {
+                if (regions[n].first <= bounds[i] &&
+                    bounds[i] < regions[n].end) {
+                    prot[MMU_SV_IDX] |= regions[n].prot[MMU_SV_IDX];
+                    prot[MMU_UM_IDX] |= regions[n].prot[MMU_UM_IDX];
+                }
+            }
+            if (!(mpm & MPM_SVP)) {
+                prot[MMU_SV_IDX] = PAGE_BITS;
+            }
+        }
+
+        if (mpu->num_segments > 0) {
+            seg = &mpu->seg[mpu->num_segments - 1];
+            if (seg->prot[MMU_SV_IDX] == prot[MMU_SV_IDX] &&
+                seg->prot[MMU_UM_IDX] == prot[MMU_UM_IDX]) {
+                continue;
+            }
+        }
+        seg = &mpu->seg[mpu->num_segments++];
+        seg->start = bounds[i];
+        seg->prot[MMU_SV_IDX] = prot[MMU_SV_IDX];
+        seg->prot[MMU_UM_IDX] = prot[MMU_UM_IDX];
+    }
+
+    tlb_flush(CPU(rh850_env_get_cpu(env)));
+}
+
+int rh850_mpu_get_prot(CPURH850State *env, uint32_t addr, int mmu_idx,
+                       uint32_t *first, uint32_t *last)
+{
+    RH850MPUState *mpu = &env->mpu;
+    int lo = 0;
+    int hi = mpu->num_segments - 1;
+
+    /* Find the last segment which starts at or below addr */
+    while (lo < hi) {
+        int mid = (lo + hi + 1) / 2;
+
+        if (mpu->seg[mid].start <= addr) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    *first = mpu->seg[lo].start;
+    *last = lo + 1 < mpu->num_segments ? mpu->seg[lo + 1].start - 1
+                                       : UINT32_MAX;
+    return mpu->seg[lo].prot[mmu_idx];
+}
+
+void helper_ldsr_mpu(CPURH850State *env, uint32_t selID, uint32_t regID,
+                     uint32_t val)
+{
+    uint32_t mask = rh850_sys_reg_read_only_masks[selID][regID];
+    target_ulong *reg = &env->systemRegs[selID][regID];
+    int n;
+
+    *reg = (*reg & ~mask) | (val & mask);
+
+    if (selID == BANK_ID_MPU_CTRL && regID == MPRC_IDX5) {
+        /* MPRC.En is another view of MPATn.E */
+        for (n = 0; n < RH850_MPU_NUM_REGIONS; n++) {
+            target_ulong *mpat = &mpu_region_regs(env, n)[2];
+
+            if (val & (1 << n)) {
+                *mpat |= MPAT_E;
+            } else {
+                *mpat &= ~MPAT_E;
+            }
+        }
+    }
+    rh850_mpu_update(env);
+}
@@ -0,0 +1,75 @@
+/*
+ * RH850 memory protection unit (MPU)
+ *
+ * Copyright (c) 2021 iSYSTEM Labs d.o.o.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2 or later, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RH850_MPU_H
+#define RH850_MPU_H
+
+#define RH850_MPU_NUM_REGIONS   16
+
+/* MPU regions are described by sel ID 6 (0-7) and 7 (8-15) */
+#define BANK_ID_MPU_CTRL        5
+#define BANK_ID_MPU_REGIONS     6
+#define MPU_REGIONS_PER_BANK    8
+
+/* MPM */
+#define MPM_MPE                 0x00000001  /* MPU enabled */
+#define MPM_SVP                 0x00000002  /* regions also apply to SV mode */
+
+/* MPATn */
+#define MPAT_UR                 0x00000001
+#define MPAT_UW                 0x00000002
+#define MPAT_UX                 0x00000004
+#define MPAT_SR                 0x00000008
+#define MPAT_SW                 0x00000010
+#define MPAT_SX                 0x00000020
+#define MPAT_G                  0x00000040  /* global, ASID is ignored */
+#define MPAT_E                  0x00000080  /* region enabled */
+#define MPAT_ASID_SHIFT         16
+#define MPAT_ASID_MASK          0x03ff0000
+
+/*
+ * The enabled regions are flattened into segments, which cover the whole
+ * address space without gaps and have uniform permissions. Segment i covers
+ * addresses from seg[i].start up to seg[i + 1].start - 1, the last one up to
+ * 0xffffffff. Adjacent segments always differ in permissions, so there is a
+ * single segment with all permissions when the MPU is disabled.
+ */
+typedef struct RH850MPUSegment {
+    uint32_t start;
+    uint8_t prot[2];            /* PAGE_* bits, indexed by MMU index */
+} RH850MPUSegment;
+
+typedef struct RH850MPUState {
+    int num_segments;
+    RH850MPUSegment seg[2 * RH850_MPU_NUM_REGIONS + 1];
+} RH850MPUState;
+
+/* Returns true if writing system register selID, regID reconfigures MPU */
+bool rh850_mpu_sysreg(int selID, int regID);
+
+/* Rebuilds segments from MPU system registers and flushes TLB */
+void rh850_mpu_update(CPURH850State *env);
+
+/*
+ * Returns PAGE_* access rights for addr in the given MMU index, and bounds
+ * of the segment containing addr in *first and *last.
+ */
+int rh850_mpu_get_prot(CPURH850State *env, uint32_t addr, int mmu_idx,
+                       uint32_t *first, uint32_t *last);
+
+#endif /* RH850_MPU_H */
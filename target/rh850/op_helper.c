@@ -60,6 +60,39 @@ void helper_raise_exception(CPURH850State *env, uint32_t exception)
     do_raise_exception_err(env, exception, 0);
 }
 
+/*
+ * HALT stops the vCPU until an interrupt request arrives, see
+ * rh850_cpu_has_pending_interrupt(). PC already points to the next
+ * instruction, where execution continues after the release.
+ */
+void helper_halt(CPURH850State *env)
+{
+    CPUState *cs = CPU(rh850_env_get_cpu(env));
+
+    env->snooze_deadline = 0;
+    timer_del(env->snooze_timer);
+    cs->halted = 1;
+    cs->exception_index = EXCP_HLT;
+    cpu_loop_exit(cs);
+}
+
+/*
+ * SNOOZE pauses the CPU for RH850_SNOOZE_PERIOD_NS of virtual time, which
+ * is used in spin loops. Like HALT, an interrupt request releases it
+ * earlier, otherwise snooze_timer does when the period is over.
+ */
+void helper_snooze(CPURH850State *env)
+{
+    CPUState *cs = CPU(rh850_env_get_cpu(env));
+
+    env->snooze_deadline = qemu_clock_get_ns(QEMU_CLOCK_VIRTUAL) +
+                           RH850_SNOOZE_PERIOD_NS;
+    timer_mod(env->snooze_timer, env->snooze_deadline);
+    cs->halted = 1;
+    cs->exception_index = EXCP_HLT;
+    cpu_loop_exit(cs);
+}
+
 static void validate_mstatus_fs(CPURH850State *env, uintptr_t ra)
 {
 #ifndef CONFIG_USER_ONLY
@@ -497,28 +530,6 @@ target_ulong csr_read_helper(CPURH850State *env, target_ulong csrno)
         return env->medeleg;
     case CSR_MIDELEG:
         return env->mideleg;
-    case CSR_PMPCFG0:
-    case CSR_PMPCFG1:
-    case CSR_PMPCFG2:
-    case CSR_PMPCFG3:
-       return pmpcfg_csr_read(env, csrno - CSR_PMPCFG0);
-    case CSR_PMPADDR0:
-    case CSR_PMPADDR1:
-    case CSR_PMPADDR2:
-    case CSR_PMPADDR3:
-    case CSR_PMPADDR4:
-    case CSR_PMPADDR5:
-    case CSR_PMPADDR6:
-    case CSR_PMPADDR7:
-    case CSR_PMPADDR8:
-    case CSR_PMPADDR9:
-    case CSR_PMPADDR10:
-    case CSR_PMPADDR11:
-    case CSR_PMPADDR12:
-    case CSR_PMPADDR13:
-    case CSR_PMPADDR14:
-    case CSR_PMPADDR15:
-       return pmpaddr_csr_read(env, csrno - CSR_PMPADDR0);
 #endif
     }
     /* used by e.g. MTIME read */
@@ -575,19 +586,6 @@ target_ulong csr_read_helper(CPURH850State *env, target_ulong csrno)
 
 #ifndef CONFIG_USER_ONLY
 
-/* iothread_mutex must be held */
-void rh850_set_local_interrupt(RH850CPU *cpu, target_ulong mask, int value)
-{
-    target_ulong old_mip = cpu->env.mip;
-    cpu->env.mip = (old_mip & ~mask) | (value ? mask : 0);
-
-    if (cpu->env.mip && !old_mip) {
-        cpu_interrupt(CPU(cpu), CPU_INTERRUPT_HARD);
-    } else if (!cpu->env.mip && old_mip) {
-        cpu_reset_interrupt(CPU(cpu), CPU_INTERRUPT_HARD);
-    }
-}
-
 void rh850_set_mode(CPURH850State *env, target_ulong newpriv)
 {
     if (newpriv > PRV_M) {
@@ -651,15 +649,6 @@ void rh850_set_mode(CPURH850State *env, target_ulong newpriv)
 //}
 
 
-//void helper_wfi(CPURH850State *env)
-//{
-//    CPUState *cs = CPU(rh850_env_get_cpu(env));
-//
-//    cs->halted = 1;
-//    cs->exception_index = EXCP_HLT;
-//    cpu_loop_exit(cs);
-//}
-
 void helper_tlb_flush(CPURH850State *env)
 {
     RH850CPU *cpu = rh850_env_get_cpu(env);
@@ -58,6 +58,7 @@
 
 // BANK ID 5, 6, 7 system MPU regs indices
 #define MPM_IDX5	0	//memory protection operation mode
+#define MPRC_IDX5	1	//MPU region control, view of MPATn.E
 
 
 #endif /* TARGET_RH850_REGISTER_INDICES_H_ */
@@ -28,15 +28,22 @@
 #include "exec/translator.h"
 
 #include "exec/log.h"
+#include "semihosting/semihost.h"
 
 #include "instmap.h"
 
 /* global register indices */
 static TCGv cpu_gpr[NUM_GP_REGS];
 static TCGv cpu_pc;
-static TCGv cpu_sysRegs[NUM_SYS_REG_BANKS][MAX_SYS_REGS_IN_BANK];
+/*
+ * Only system registers used by exception entry and return and by
+ * CALLT/CTRET are TCG globals. The others are accessed by LDSR, STSR and
+ * a few rarely executed instructions, so they are loaded from and stored
+ * to env directly, see gen_get_sysreg() and gen_set_sysreg().
+ */
+static TCGv cpu_eipc, cpu_eipsw, cpu_fepc, cpu_fepsw, cpu_ctpc, cpu_ctpsw;
 // static TCGv_i64 cpu_fpr[32]; /* assume F and D extensions */
-static TCGv cpu_sysDatabuffRegs[1], cpu_LLbit, cpu_LLAddress;
+static TCGv cpu_sysDatabuffRegs[1], cpu_LLbit, cpu_LLAddress, cpu_LLValue;
 static TCGv load_res;
 static TCGv load_val;
 
@@ -49,6 +56,81 @@ static TCGv load_val;
 TCGv_i32 cpu_ZF, cpu_SF, cpu_OVF, cpu_CYF, cpu_SATF, cpu_ID, cpu_EP, cpu_NP,
 		cpu_EBV, cpu_CU0, cpu_CU1, cpu_CU2, cpu_UM;
 
+// CPU clocks, see set_insn_cycles()
+static TCGv_i64 cpu_cycles;
+
+// Operands of the last flag setting instruction, see CC_OP_* in cpu.h.
+static TCGv_i32 cpu_cc_src1, cpu_cc_src2, cpu_cc_dst;
+
+static bool sysreg_exists(int selID, int regID)
+{
+    return selID < NUM_SYS_REG_BANKS &&
+           rh850_sys_regnames[selID][regID] != NULL;
+}
+
+/* Returns the TCG global of a system register, or NULL if it has none */
+static TCGv sysreg_global(int selID, int regID)
+{
+    if (selID != BANK_ID_BASIC_0) {
+        return NULL;
+    }
+    switch (regID) {
+    case EIPC_IDX:
+        return cpu_eipc;
+    case EIPSW_IDX:
+        return cpu_eipsw;
+    case FEPC_IDX:
+        return cpu_fepc;
+    case FEPSW_IDX:
+        return cpu_fepsw;
+    case CTPC_IDX:
+        return cpu_ctpc;
+    case CTPSW_IDX:
+        return cpu_ctpsw;
+    default:
+        return NULL;
+    }
+}
+
+static void gen_get_sysreg(TCGv t, int selID, int regID)
+{
+    TCGv reg = sysreg_global(selID, regID);
+
+    if (reg) {
+        tcg_gen_mov_tl(t, reg);
+    } else {
+        tcg_gen_ld_tl(t, cpu_env,
+                      offsetof(CPURH850State, systemRegs[selID][regID]));
+    }
+}
+
+static void gen_set_sysreg(int selID, int regID, TCGv t)
+{
+    TCGv reg = sysreg_global(selID, regID);
+
+    if (reg) {
+        tcg_gen_mov_tl(reg, t);
+    } else {
+        tcg_gen_st_tl(t, cpu_env,
+                      offsetof(CPURH850State, systemRegs[selID][regID]));
+    }
+}
+
+static void gen_set_sysregi(int selID, int regID, target_ulong val)
+{
+    TCGv t = tcg_const_tl(val);
+
+    gen_set_sysreg(selID, regID, t);
+    tcg_temp_free(t);
+}
+
+/* pc = reg + offset, where reg is a system register without a global */
+static void gen_jmp_sysreg(int selID, int regID, target_ulong offset)
+{
+    gen_get_sysreg(cpu_pc, selID, regID);
+    tcg_gen_addi_tl(cpu_pc, cpu_pc, offset);
+}
+
 
 //// system registers indices
 //enum{
@@ -87,9 +169,6 @@ TCGv_i32 cpu_ZF, cpu_SF, cpu_OVF, cpu_CYF, cpu_SATF, cpu_ID, cpu_EP, cpu_NP,
 
 #include "exec/gen-icount.h"
 
-/** Const, RH850 does not have MMU. */
-const int MEM_IDX = 0;
-
 /**
  * This structure contains data, which is needed to translate a
  * sequence of instructions, usually  inside one translation
@@ -107,8 +186,70 @@ typedef struct DisasContext {
     target_ulong pc;  // pointer to instruction being translated
     uint32_t opcode;
     uint32_t opcode1;  // used for 48 bit instructions
+    int cc_op;         // pending lazy flags operation, CC_OP_FLAGS at TB start
+    bool cu0;          // PSW.CU0 at TB start, FPU instructions are usable
+    int mem_idx;       // MMU_SV_IDX or MMU_UM_IDX, selects MPU permissions
+    bool cycle_timing; // RH850CPU.cycle_timing
+    int insn_cycles;   // clocks charged for the current instruction
+    int tb_cycles;     // clocks of instructions translated so far in TB
+    TCGOp *cycles_op;  // add to cpu_cycles at TB start, patched at TB end
 } DisasContext;
 
+/*
+ * Timing model: classes of instructions and their approximate execution
+ * clocks on G3K core, assuming no pipeline stalls, cache hits and average
+ * of taken and not taken branches. DIVQ is charged the worst case of DIV.
+ */
+enum {
+    CYC_ALU,
+    CYC_LOAD,
+    CYC_STORE,
+    CYC_BIT,            /* SET1, NOT1, CLR1 and TST1 read-modify-write */
+    CYC_ATOMIC,         /* LDL.W, STC.W and CAXI */
+    CYC_MUL,
+    CYC_MAC,
+    CYC_DIV,
+    CYC_BRANCH,
+    CYC_JUMP,
+    CYC_CALLT,
+    CYC_SWITCH,
+    CYC_RET,            /* CTRET, EIRET and FERET */
+    CYC_TRAP,           /* TRAP, FETRAP and SYSCALL */
+    CYC_STACK,          /* PREPARE, DISPOSE, PUSHSP and POPSP, plus 1/reg */
+    CYC_SYNC,
+    CYC_FPU,
+    CYC_FPU_DIV_S,      /* DIVF.S, SQRTF.S, RECIPF.S and RSQRTF.S */
+    CYC_FPU_DIV_D,
+    CYC_NUM
+};
+
+static const uint8_t rh850_insn_cycles[CYC_NUM] = {
+    [CYC_ALU]       = 1,
+    [CYC_LOAD]      = 2,
+    [CYC_STORE]     = 1,
+    [CYC_BIT]       = 3,
+    [CYC_ATOMIC]    = 4,
+    [CYC_MUL]       = 2,
+    [CYC_MAC]       = 3,
+    [CYC_DIV]       = 19,
+    [CYC_BRANCH]    = 2,
+    [CYC_JUMP]      = 3,
+    [CYC_CALLT]     = 5,
+    [CYC_SWITCH]    = 5,
+    [CYC_RET]       = 3,
+    [CYC_TRAP]      = 5,
+    [CYC_STACK]     = 2,
+    [CYC_SYNC]      = 2,
+    [CYC_FPU]       = 2,
+    [CYC_FPU_DIV_S] = 14,
+    [CYC_FPU_DIV_D] = 28,
+};
+
+static void set_insn_cycles(DisasContext *ctx, int cls)
+{
+    ctx->insn_cycles = rh850_insn_cycles[cls];
+}
+
 /* is_jmp field values */
 #define DISAS_INDIRECT_JUMP              DISAS_TARGET_0 /* only pc was modified dynamically */
 #define DISAS_EXIT_TB                    DISAS_TARGET_1 /* cpu state was modified dynamically */
@@ -176,8 +317,20 @@ static void generate_exception(DisasContext *ctx, int excp)
 */
 
 
+static void gen_flush_flags(DisasContext *ctx);
+
+/* Raises exception for the instruction being translated, env->pc points to it */
+static void gen_exception_insn(DisasContext *ctx, int excp)
+{
+    gen_flush_flags(ctx);
+    tcg_gen_movi_tl(cpu_pc, ctx->pc);
+    gen_helper_raise_exception(cpu_env, tcg_constant_i32(excp));
+    ctx->base.is_jmp = DISAS_NORETURN;
+}
+
 static void gen_exception_debug(DisasContext *dc)
 {
+    gen_flush_flags(dc);
     TCGv_i32 helper_tmp = tcg_const_i32(EXCP_DEBUG);
     gen_helper_raise_exception(cpu_env, helper_tmp);
     tcg_temp_free_i32(helper_tmp);
@@ -192,26 +345,22 @@ static void gen_exception_illegal(DisasContext *ctx)
 */
 
 
+/*
+ * Direct jumps are chained only within the same page, so that the jump
+ * target is looked up again and MPU execute permission rechecked after
+ * the TLB is flushed.
+ */
 static void gen_goto_tb_imm(DisasContext *ctx, int n, target_ulong dest)
 {
     if (unlikely(ctx->base.singlestep_enabled)) {
         tcg_gen_movi_tl(cpu_pc, dest);
         gen_exception_debug(ctx);
-    } else {
-        tcg_gen_goto_tb(n);
+    } else if (!translator_use_goto_tb(&ctx->base, dest)) {
         tcg_gen_movi_tl(cpu_pc, dest);
-        tcg_gen_exit_tb(ctx->base.tb, n);
-    }
-}
-
-static void gen_goto_tb(DisasContext *ctx, int n, TCGv dest)
-{
-    if (unlikely(ctx->base.singlestep_enabled)) {
-        tcg_gen_mov_tl(cpu_pc, dest);
-        gen_exception_debug(ctx);
+        tcg_gen_lookup_and_goto_ptr();
     } else {
         tcg_gen_goto_tb(n);
-        tcg_gen_mov_tl(cpu_pc, dest);
+        tcg_gen_movi_tl(cpu_pc, dest);
         tcg_gen_exit_tb(ctx->base.tb, n);
     }
 }
@@ -414,11 +563,157 @@ static void flags_to_tcgv(TCGv reg)
 }
 
 
-static TCGv condition_satisfied(int cond)
+/*
+ * Computes Z, S, OV and CY flags from lazy state. Must be called before
+ * flags are read directly and at every TB exit, since the next TB
+ * expects valid flags. Generated code must not be conditional, because
+ * ctx->cc_op is tracked at translation time.
+ */
+static void gen_flush_flags(DisasContext *ctx)
+{
+    TCGv_i32 tmp;
+
+    switch (ctx->cc_op) {
+    case CC_OP_ADD:
+        tmp = tcg_temp_new_i32();
+        tcg_gen_setcond_i32(TCG_COND_LTU, cpu_CYF, cpu_cc_dst, cpu_cc_src1);
+        tcg_gen_xor_i32(cpu_OVF, cpu_cc_dst, cpu_cc_src1);
+        tcg_gen_xor_i32(tmp, cpu_cc_src1, cpu_cc_src2);
+        tcg_gen_andc_i32(cpu_OVF, cpu_OVF, tmp);
+        tcg_gen_shri_i32(cpu_OVF, cpu_OVF, 0x1f);
+        tcg_temp_free_i32(tmp);
+        break;
+    case CC_OP_SUB:
+        tmp = tcg_temp_new_i32();
+        tcg_gen_setcond_i32(TCG_COND_LTU, cpu_CYF, cpu_cc_src1, cpu_cc_src2);
+        tcg_gen_xor_i32(cpu_OVF, cpu_cc_dst, cpu_cc_src1);
+        tcg_gen_xor_i32(tmp, cpu_cc_src1, cpu_cc_src2);
+        tcg_gen_and_i32(cpu_OVF, cpu_OVF, tmp);
+        tcg_gen_shri_i32(cpu_OVF, cpu_OVF, 0x1f);
+        tcg_temp_free_i32(tmp);
+        break;
+    case CC_OP_LOGIC:
+        tcg_gen_movi_i32(cpu_OVF, 0x0);
+        break;
+    default:
+        return;
+    }
+
+    tcg_gen_shri_i32(cpu_SF, cpu_cc_dst, 0x1f);
+    tcg_gen_setcondi_i32(TCG_COND_EQ, cpu_ZF, cpu_cc_dst, 0x0);
+    ctx->cc_op = CC_OP_FLAGS;
+}
+
+/*
+ * Flag setters for the most frequent instructions (ADD, SUB, CMP, logical
+ * ops). They only record operands, flags are computed by gen_flush_flags()
+ * or directly from operands in condition_satisfied().
+ */
+static void gen_lazy_flags_on_add(DisasContext *ctx, TCGv_i32 t0, TCGv_i32 t1)
+{
+    tcg_gen_mov_i32(cpu_cc_src1, t0);
+    tcg_gen_mov_i32(cpu_cc_src2, t1);
+    tcg_gen_add_i32(cpu_cc_dst, t0, t1);
+    ctx->cc_op = CC_OP_ADD;
+}
+
+static void gen_lazy_flags_on_sub(DisasContext *ctx, TCGv_i32 t0, TCGv_i32 t1)
+{
+    tcg_gen_mov_i32(cpu_cc_src1, t0);
+    tcg_gen_mov_i32(cpu_cc_src2, t1);
+    tcg_gen_sub_i32(cpu_cc_dst, t0, t1);
+    ctx->cc_op = CC_OP_SUB;
+}
+
+static void gen_lazy_logic_CC(DisasContext *ctx, TCGv_i32 result)
+{
+    // logical ops do not modify CY, so keep CY of the pending add/sub
+    if (ctx->cc_op == CC_OP_ADD) {
+        tcg_gen_setcond_i32(TCG_COND_LTU, cpu_CYF, cpu_cc_dst, cpu_cc_src1);
+    } else if (ctx->cc_op == CC_OP_SUB) {
+        tcg_gen_setcond_i32(TCG_COND_LTU, cpu_CYF, cpu_cc_src1, cpu_cc_src2);
+    }
+    tcg_gen_mov_i32(cpu_cc_dst, result);
+    ctx->cc_op = CC_OP_LOGIC;
+}
+
+/*
+ * Evaluates condition directly from operands of the pending lazy
+ * operation, if possible. Returns TCG_COND_NEVER otherwise.
+ */
+static TCGCond lazy_condition(DisasContext *ctx, int cond,
+                              TCGv_i32 *arg1, TCGv_i32 *arg2)
+{
+    switch (ctx->cc_op) {
+    case CC_OP_SUB:
+        *arg1 = cpu_cc_src1;
+        *arg2 = cpu_cc_src2;
+        switch (cond) {
+        case Z_COND:  return TCG_COND_EQ;
+        case NZ_COND: return TCG_COND_NE;
+        case C_COND:  return TCG_COND_LTU;
+        case NC_COND: return TCG_COND_GEU;
+        case NH_COND: return TCG_COND_LEU;
+        case H_COND:  return TCG_COND_GTU;
+        case LT_COND: return TCG_COND_LT;
+        case GE_COND: return TCG_COND_GE;
+        case LE_COND: return TCG_COND_LE;
+        case GT_COND: return TCG_COND_GT;
+        }
+        break;
+    case CC_OP_ADD:
+        *arg1 = cpu_cc_dst;
+        *arg2 = cpu_cc_src1;
+        switch (cond) {
+        case C_COND:  return TCG_COND_LTU;
+        case NC_COND: return TCG_COND_GEU;
+        }
+        break;
+    case CC_OP_LOGIC:
+        *arg1 = cpu_cc_dst;
+        *arg2 = NULL;  // compare with zero, OV is 0
+        switch (cond) {
+        case LT_COND: return TCG_COND_LT;
+        case GE_COND: return TCG_COND_GE;
+        case LE_COND: return TCG_COND_LE;
+        case GT_COND: return TCG_COND_GT;
+        }
+        break;
+    default:
+        return TCG_COND_NEVER;
+    }
+
+    // Z and S are computed from result of all lazy operations
+    *arg1 = cpu_cc_dst;
+    *arg2 = NULL;
+    switch (cond) {
+    case Z_COND:  return TCG_COND_EQ;
+    case NZ_COND: return TCG_COND_NE;
+    case S_COND:  return TCG_COND_LT;
+    case NS_COND: return TCG_COND_GE;
+    }
+    return TCG_COND_NEVER;
+}
+
+static TCGv condition_satisfied(DisasContext *ctx, int cond)
 {
 	TCGv condResult = tcg_temp_new_i32();
+	TCGv_i32 arg1, arg2;
+	TCGCond tcg_cond = lazy_condition(ctx, cond, &arg1, &arg2);
+
+	if (tcg_cond != TCG_COND_NEVER) {
+	    if (arg2 == NULL) {
+	        tcg_gen_setcondi_i32(tcg_cond, condResult, arg1, 0);
+	    } else {
+	        tcg_gen_setcond_i32(tcg_cond, condResult, arg1, arg2);
+	    }
+	    return condResult;
+	}
+
+	if (cond != T_COND && cond != SA_COND) {
+	    gen_flush_flags(ctx);
+	}
 	tcg_gen_movi_i32(condResult, 0x0);
-	// psw_to_flags_z_cy_ov_s_sat();
 
 	switch(cond) {
 		case GE_COND:
@@ -651,27 +946,6 @@ static void gen_satsub_CC(TCGv_i32 t0, TCGv_i32 t1, TCGv_i32 result)
 	gen_set_label(end);
 }
 
-static void gen_logic_CC(TCGv_i32 result){
-
-	TCGLabel *cont;
-	TCGLabel *end;
-
-	tcg_gen_movi_i32(cpu_OVF, 0x0);
-	tcg_gen_shri_i32(cpu_SF, result, 0x1f);
-
-	cont = gen_new_label();
-	end = gen_new_label();
-
-	tcg_gen_brcondi_i32(TCG_COND_NE, result, 0x0, cont);
-	tcg_gen_movi_i32(cpu_ZF, 0x1);
-	tcg_gen_br(end);
-
-	gen_set_label(cont);
-	tcg_gen_movi_i32(cpu_ZF, 0x0);
-
-	gen_set_label(end);
-}
-
 /*
 	MO_UB  => 8 unsigned
 	MO_SB  => 8 signed
@@ -685,6 +959,7 @@ static void gen_logic_CC(TCGv_i32 result){
 static void gen_load(DisasContext *ctx, int memop, int rd, int rs1,
 		target_long imm, unsigned is_disp23)
 {
+    set_insn_cycles(ctx, CYC_LOAD);
     TCGv t0 = tcg_temp_new();
     TCGv t1 = tcg_temp_new();
     TCGv tcg_imm = tcg_temp_new();
@@ -704,14 +979,14 @@ static void gen_load(DisasContext *ctx, int memop, int rd, int rs1,
 	tcg_gen_add_tl(t0, t0, tcg_imm);
 
     if (memop == MO_TEQ) {
-        tcg_gen_qemu_ld_i64(t1_64, t0, MEM_IDX, memop);
+        tcg_gen_qemu_ld_i64(t1_64, t0, ctx->mem_idx, memop);
         tcg_gen_extrl_i64_i32(t1, t1_64);
         tcg_gen_extrh_i64_i32(t1_high, t1_64);
         gen_set_gpr(rd, t1);
         gen_set_gpr(rd+1, t1_high);
     }
     else {
-    	tcg_gen_qemu_ld_tl(t1, t0, MEM_IDX, memop);
+    	tcg_gen_qemu_ld_tl(t1, t0, ctx->mem_idx, memop);
         gen_set_gpr(rd, t1);
     }
 
@@ -725,6 +1000,7 @@ static void gen_load(DisasContext *ctx, int memop, int rd, int rs1,
 static void gen_store(DisasContext *ctx, int memop, int rs1, int rs2,
         target_long imm, unsigned is_disp23)
 {
+    set_insn_cycles(ctx, CYC_STORE);
     TCGv t0 = tcg_temp_new();
     TCGv dat = tcg_temp_new();
     TCGv tcg_imm = tcg_temp_new();
@@ -748,10 +1024,10 @@ static void gen_store(DisasContext *ctx, int memop, int rs1, int rs2,
     if (memop == MO_TEQ) {
         gen_get_gpr(dat_high, rs2+1);
         tcg_gen_concat_i32_i64(dat64, dat, dat_high);
-    	tcg_gen_qemu_st_i64(dat64, t0, MEM_IDX, memop);
+    	tcg_gen_qemu_st_i64(dat64, t0, ctx->mem_idx, memop);
     }
     else {
-    	tcg_gen_qemu_st_tl(dat, t0, MEM_IDX, memop);
+    	tcg_gen_qemu_st_tl(dat, t0, ctx->mem_idx, memop);
     }
 
     // clear possible mutex
@@ -770,12 +1046,13 @@ static void gen_store(DisasContext *ctx, int memop, int rs1, int rs2,
 
 static void gen_mutual_exclusion(DisasContext *ctx, int rs3, int rs1, int operation)
 {
-	/* LDL.W, STC.W, CLL: Implement as described.
-	Add two additional global CPU registers called LLBit and LLAddress.
-	Set them with LDL.W, and reset them with STC.W.
-	If LLBit is not set or LLAddress does not match STC.W address, make STC.W fail.
-	CLL clears LLBit.
-	Since we do not implement multicore CPU emulation, this implementation should be OK. */
+	set_insn_cycles(ctx, CYC_ATOMIC);
+	/* LDL.W, STC.W, CLL: LDL.W sets LLbit and remembers the address and
+	the loaded value. STC.W fails if LLbit is not set or the address does
+	not match, otherwise it stores with an atomic compare-and-swap against
+	the value loaded by LDL.W, so that it also fails when another PE has
+	written the word in between. Stores of this PE to the address clear
+	LLbit, see gen_store(). CLL clears LLbit. */
 
     if (operation == operation_LDL_W)
     {
@@ -783,42 +1060,42 @@ static void gen_mutual_exclusion(DisasContext *ctx, int rs3, int rs1, int operat
         TCGv dat = tcg_temp_new();
 
         gen_get_gpr(adr, rs1);
-		tcg_gen_qemu_ld_tl(dat, adr, MEM_IDX, MO_TESL);
+		tcg_gen_qemu_ld_tl(dat, adr, ctx->mem_idx, MO_TESL);
 		gen_set_gpr(rs3, dat);
 
-		tcg_temp_free(adr);
-		tcg_temp_free(dat);
-
 		tcg_gen_movi_i32(cpu_LLbit, 1);
 		tcg_gen_mov_i32(cpu_LLAddress, adr);
+		tcg_gen_mov_i32(cpu_LLValue, dat);
+
+		tcg_temp_free(adr);
+		tcg_temp_free(dat);
     }
     else if (operation == operation_STC_W)
     {
         TCGv adr = tcg_temp_local_new();
         TCGv dat = tcg_temp_local_new();
-        TCGv token = tcg_temp_local_new();
 		TCGLabel *l_fail = gen_new_label();
-		TCGLabel *l_ok = gen_new_label();
+		TCGLabel *l_done = gen_new_label();
 
-	    tcg_gen_mov_i32(token, cpu_LLbit);
-	    tcg_gen_brcondi_i32(TCG_COND_NE, token, 0x1, l_fail);
         gen_get_gpr(adr, rs1);
         gen_get_gpr(dat, rs3);
+	    tcg_gen_brcondi_i32(TCG_COND_NE, cpu_LLbit, 0x1, l_fail);
 	    tcg_gen_brcond_i32(TCG_COND_NE, adr, cpu_LLAddress, l_fail);
-        tcg_gen_qemu_st_tl(dat, adr, MEM_IDX, MO_TESL);
-	    tcg_gen_movi_i32(dat, 1);
-        tcg_gen_br(l_ok);
+
+        tcg_gen_atomic_cmpxchg_tl(dat, adr, cpu_LLValue, dat,
+                                  ctx->mem_idx, MO_TESL);
+        tcg_gen_setcond_tl(TCG_COND_EQ, dat, dat, cpu_LLValue);
+        tcg_gen_br(l_done);
 
 	    gen_set_label(l_fail);
         tcg_gen_movi_i32(dat, 0);
-	    gen_set_label(l_ok);
+	    gen_set_label(l_done);
 		gen_set_gpr(rs3, dat);
 
         tcg_gen_movi_tl(cpu_LLbit, 0);
 
         tcg_temp_free(adr);
         tcg_temp_free(dat);
-        tcg_temp_free(token);
     }
     else if (operation == operation_CLL)
     {
@@ -831,6 +1108,7 @@ static void gen_mutual_exclusion(DisasContext *ctx, int rs3, int rs1, int operat
 
 static void gen_multiply(DisasContext *ctx, int rs1, int rs2, int operation)
 {
+	set_insn_cycles(ctx, CYC_MUL);
 	TCGv r1 = tcg_temp_new();		//temp
 	TCGv r2 = tcg_temp_new();		//temp
 
@@ -961,6 +1239,7 @@ static void gen_multiply(DisasContext *ctx, int rs1, int rs2, int operation)
 
 static void gen_mul_accumulate(DisasContext *ctx, int rs1, int rs2, int operation)
 {
+	set_insn_cycles(ctx, CYC_MAC);
 	TCGv r1 = tcg_temp_new();
 	TCGv r2 = tcg_temp_new();
 	TCGv addLo = tcg_temp_new();
@@ -1012,6 +1291,347 @@ static void gen_mul_accumulate(DisasContext *ctx, int rs1, int rs2, int operatio
 
 }
 
+/*
+ * FPU instructions operate on general purpose registers. Double precision
+ * operands are kept in register pairs, low word in the even register.
+ */
+static void gen_get_gpr_pair(TCGv_i64 t, int reg_num)
+{
+	TCGv lo = tcg_temp_new();
+	TCGv hi = tcg_temp_new();
+
+	gen_get_gpr(lo, reg_num & ~1);
+	gen_get_gpr(hi, (reg_num & ~1) + 1);
+	tcg_gen_concat_i32_i64(t, lo, hi);
+
+	tcg_temp_free(lo);
+	tcg_temp_free(hi);
+}
+
+static void gen_set_gpr_pair(int reg_num_dst, TCGv_i64 t)
+{
+	TCGv lo = tcg_temp_new();
+	TCGv hi = tcg_temp_new();
+
+	tcg_gen_extr_i64_i32(lo, hi, t);
+	gen_set_gpr(reg_num_dst & ~1, lo);
+	gen_set_gpr((reg_num_dst & ~1) + 1, hi);
+
+	tcg_temp_free(lo);
+	tcg_temp_free(hi);
+}
+
+/* Returns false for reserved FPU sub-opcodes and reg1 selectors */
+static bool fpu_op_valid(int rs1, int operation)
+{
+	switch (operation & OPC_RH850_FPU_CMP_MASK) {
+	case OPC_RH850_CMOVF_S:
+	case OPC_RH850_CMOVF_D:
+	case OPC_RH850_CMPF_S:
+	case OPC_RH850_CMPF_D:
+		return true;
+	}
+
+	switch (operation) {
+	case OPC_RH850_CVTF_TO_S:
+	case OPC_RH850_CVTF_TO_D:
+		return (rs1 & 0xf) <= 3;
+	case OPC_RH850_ABSF_NEGF_S:
+	case OPC_RH850_ABSF_NEGF_D:
+		return rs1 <= 1;
+	case OPC_RH850_SQRTF_S:
+	case OPC_RH850_SQRTF_D:
+		return rs1 <= 2;
+	case OPC_RH850_CVTF_S_W:
+	case OPC_RH850_CVTF_S_L:
+	case OPC_RH850_CVTF_D_W:
+	case OPC_RH850_CVTF_D_L:
+	case OPC_RH850_ADDF_S:
+	case OPC_RH850_SUBF_S:
+	case OPC_RH850_MULF_S:
+	case OPC_RH850_MAXF_S:
+	case OPC_RH850_MINF_S:
+	case OPC_RH850_DIVF_S:
+	case OPC_RH850_ADDF_D:
+	case OPC_RH850_SUBF_D:
+	case OPC_RH850_MULF_D:
+	case OPC_RH850_MAXF_D:
+	case OPC_RH850_MINF_D:
+	case OPC_RH850_DIVF_D:
+	case OPC_RH850_FMAF_S:
+	case OPC_RH850_FMSF_S:
+	case OPC_RH850_FNMAF_S:
+	case OPC_RH850_FNMSF_S:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+ * 'operation' is the sub-opcode in bits 26-16. For conversions and unary
+ * operations reg1 field selects the instruction, the operand is in reg2.
+ *
+ * The operation must have been checked with fpu_op_valid().
+ */
+static void gen_fpu(DisasContext *ctx, int rs1, int rs2, int operation)
+{
+	int rs3 = extract32(ctx->opcode, 27, 5);
+	int fcbit = extract32(ctx->opcode, 17, 3);
+
+	TCGv r1 = tcg_temp_new();
+	TCGv r2 = tcg_temp_new();
+	TCGv r3 = tcg_temp_new();
+	TCGv_i64 d1 = tcg_temp_new_i64();
+	TCGv_i64 d2 = tcg_temp_new_i64();
+	TCGv_i64 d3 = tcg_temp_new_i64();
+	TCGv tcg_code = tcg_constant_i32(rs1);
+
+	switch (operation & OPC_RH850_FPU_CMP_MASK) {
+	case OPC_RH850_CMOVF_S:
+		if (rs1 == 0 && rs2 == 0 && rs3 == 0) {
+			// TRFSR, CMOVF.S with r0 as destination is a no-op anyway
+			gen_flush_flags(ctx);
+			gen_get_sysreg(cpu_ZF, BANK_ID_BASIC_0, FPSR_IDX);
+			tcg_gen_extract_i32(cpu_ZF, cpu_ZF,
+			                    FPSR_CC_SHIFT + fcbit, 1);
+			break;
+		}
+		gen_get_gpr(r1, rs1);
+		gen_get_gpr(r2, rs2);
+		gen_get_sysreg(r3, BANK_ID_BASIC_0, FPSR_IDX);
+		tcg_gen_extract_i32(r3, r3,
+		                    FPSR_CC_SHIFT + fcbit, 1);
+		tcg_gen_movcond_i32(TCG_COND_NE, r3, r3, tcg_constant_i32(0), r1, r2);
+		gen_set_gpr(rs3, r3);
+		break;
+
+	case OPC_RH850_CMOVF_D:
+		gen_get_gpr_pair(d1, rs1);
+		gen_get_gpr_pair(d2, rs2);
+		gen_get_sysreg(r3, BANK_ID_BASIC_0, FPSR_IDX);
+		tcg_gen_extract_i32(r3, r3,
+		                    FPSR_CC_SHIFT + fcbit, 1);
+		tcg_gen_extu_i32_i64(d3, r3);
+		tcg_gen_movcond_i64(TCG_COND_NE, d3, d3, tcg_constant_i64(0), d1, d2);
+		gen_set_gpr_pair(rs3, d3);
+		break;
+
+	case OPC_RH850_CMPF_S:
+		gen_get_gpr(r1, rs1);
+		gen_get_gpr(r2, rs2);
+		gen_helper_cmpf_s(cpu_env, r2, r1,
+		                  tcg_constant_i32(extract32(ctx->opcode, 27, 4)),
+		                  tcg_constant_i32(fcbit));
+		break;
+
+	case OPC_RH850_CMPF_D:
+		gen_get_gpr_pair(d1, rs1);
+		gen_get_gpr_pair(d2, rs2);
+		gen_helper_cmpf_d(cpu_env, d2, d1,
+		                  tcg_constant_i32(extract32(ctx->opcode, 27, 4)),
+		                  tcg_constant_i32(fcbit));
+		break;
+
+	default:
+		gen_get_gpr(r1, rs1);
+		gen_get_gpr(r2, rs2);
+
+		switch (operation) {
+		case OPC_RH850_CVTF_S_W:
+			gen_helper_cvtf_sw(r3, cpu_env, r2, tcg_code);
+			gen_set_gpr(rs3, r3);
+			break;
+		case OPC_RH850_CVTF_S_L:
+			gen_helper_cvtf_sl(d3, cpu_env, r2, tcg_code);
+			gen_set_gpr_pair(rs3, d3);
+			break;
+		case OPC_RH850_CVTF_TO_S:
+			switch (rs1 & 0xf) {
+			case 0:		// CVTF.WS, CVTF.UWS
+				gen_helper_cvtf_ws(r3, cpu_env, r2, tcg_code);
+				break;
+			case 1:		// CVTF.LS, CVTF.ULS
+				gen_get_gpr_pair(d2, rs2);
+				gen_helper_cvtf_ls(r3, cpu_env, d2, tcg_code);
+				break;
+			case 2:		// CVTF.HS
+				gen_helper_cvtf_hs(r3, cpu_env, r2);
+				break;
+			case 3:		// CVTF.SH
+				gen_helper_cvtf_sh(r3, cpu_env, r2);
+				break;
+			}
+			gen_set_gpr(rs3, r3);
+			break;
+		case OPC_RH850_ABSF_NEGF_S:
+			if (rs1 == 0) {
+				tcg_gen_andi_i32(r3, r2, 0x7fffffff);
+			} else {
+				tcg_gen_xori_i32(r3, r2, 0x80000000);
+			}
+			gen_set_gpr(rs3, r3);
+			break;
+		case OPC_RH850_SQRTF_S:
+			switch (rs1) {
+			case 0:
+				gen_helper_sqrtf_s(r3, cpu_env, r2);
+				break;
+			case 1:
+				gen_helper_recipf_s(r3, cpu_env, r2);
+				break;
+			case 2:
+				gen_helper_rsqrtf_s(r3, cpu_env, r2);
+				break;
+			}
+			gen_set_gpr(rs3, r3);
+			break;
+
+		case OPC_RH850_CVTF_D_W:
+			gen_get_gpr_pair(d2, rs2);
+			gen_helper_cvtf_dw(r3, cpu_env, d2, tcg_code);
+			gen_set_gpr(rs3, r3);
+			break;
+		case OPC_RH850_CVTF_D_L:
+			gen_get_gpr_pair(d2, rs2);
+			gen_helper_cvtf_dl(d3, cpu_env, d2, tcg_code);
+			gen_set_gpr_pair(rs3, d3);
+			break;
+		case OPC_RH850_CVTF_TO_D:
+			switch (rs1 & 0xf) {
+			case 0:		// CVTF.WD, CVTF.UWD
+				gen_helper_cvtf_wd(d3, cpu_env, r2, tcg_code);
+				gen_set_gpr_pair(rs3, d3);
+				break;
+			case 1:		// CVTF.LD, CVTF.ULD
+				gen_get_gpr_pair(d2, rs2);
+				gen_helper_cvtf_ld(d3, cpu_env, d2, tcg_code);
+				gen_set_gpr_pair(rs3, d3);
+				break;
+			case 2:		// CVTF.SD
+				gen_helper_cvtf_sd(d3, cpu_env, r2);
+				gen_set_gpr_pair(rs3, d3);
+				break;
+			case 3:		// CVTF.DS
+				gen_get_gpr_pair(d2, rs2);
+				gen_helper_cvtf_ds(r3, cpu_env, d2);
+				gen_set_gpr(rs3, r3);
+				break;
+			}
+			break;
+		case OPC_RH850_ABSF_NEGF_D:
+			gen_get_gpr_pair(d2, rs2);
+			if (rs1 == 0) {
+				tcg_gen_andi_i64(d3, d2, INT64_MAX);
+			} else {
+				tcg_gen_xori_i64(d3, d2, INT64_MIN);
+			}
+			gen_set_gpr_pair(rs3, d3);
+			break;
+		case OPC_RH850_SQRTF_D:
+			gen_get_gpr_pair(d2, rs2);
+			switch (rs1) {
+			case 0:
+				gen_helper_sqrtf_d(d3, cpu_env, d2);
+				break;
+			case 1:
+				gen_helper_recipf_d(d3, cpu_env, d2);
+				break;
+			case 2:
+				gen_helper_rsqrtf_d(d3, cpu_env, d2);
+				break;
+			}
+			gen_set_gpr_pair(rs3, d3);
+			break;
+
+		// reg3 = reg2 op reg1
+		case OPC_RH850_ADDF_S:
+			gen_helper_addf_s(r3, cpu_env, r2, r1);
+			gen_set_gpr(rs3, r3);
+			break;
+		case OPC_RH850_SUBF_S:
+			gen_helper_subf_s(r3, cpu_env, r2, r1);
+			gen_set_gpr(rs3, r3);
+			break;
+		case OPC_RH850_MULF_S:
+			gen_helper_mulf_s(r3, cpu_env, r2, r1);
+			gen_set_gpr(rs3, r3);
+			break;
+		case OPC_RH850_MAXF_S:
+			gen_helper_maxf_s(r3, cpu_env, r2, r1);
+			gen_set_gpr(rs3, r3);
+			break;
+		case OPC_RH850_MINF_S:
+			gen_helper_minf_s(r3, cpu_env, r2, r1);
+			gen_set_gpr(rs3, r3);
+			break;
+		case OPC_RH850_DIVF_S:
+			gen_helper_divf_s(r3, cpu_env, r2, r1);
+			gen_set_gpr(rs3, r3);
+			break;
+
+		case OPC_RH850_ADDF_D:
+		case OPC_RH850_SUBF_D:
+		case OPC_RH850_MULF_D:
+		case OPC_RH850_MAXF_D:
+		case OPC_RH850_MINF_D:
+		case OPC_RH850_DIVF_D:
+			gen_get_gpr_pair(d1, rs1);
+			gen_get_gpr_pair(d2, rs2);
+			switch (operation) {
+			case OPC_RH850_ADDF_D:
+				gen_helper_addf_d(d3, cpu_env, d2, d1);
+				break;
+			case OPC_RH850_SUBF_D:
+				gen_helper_subf_d(d3, cpu_env, d2, d1);
+				break;
+			case OPC_RH850_MULF_D:
+				gen_helper_mulf_d(d3, cpu_env, d2, d1);
+				break;
+			case OPC_RH850_MAXF_D:
+				gen_helper_maxf_d(d3, cpu_env, d2, d1);
+				break;
+			case OPC_RH850_MINF_D:
+				gen_helper_minf_d(d3, cpu_env, d2, d1);
+				break;
+			default:
+				gen_helper_divf_d(d3, cpu_env, d2, d1);
+				break;
+			}
+			gen_set_gpr_pair(rs3, d3);
+			break;
+
+		// reg3 = +-(reg2 * reg1 +- reg3)
+		case OPC_RH850_FMAF_S:
+		case OPC_RH850_FMSF_S:
+		case OPC_RH850_FNMAF_S:
+		case OPC_RH850_FNMSF_S: {
+			int negate = 0;
+
+			if (operation == OPC_RH850_FMSF_S || operation == OPC_RH850_FNMSF_S) {
+				negate |= float_muladd_negate_c;
+			}
+			if (operation == OPC_RH850_FNMAF_S || operation == OPC_RH850_FNMSF_S) {
+				negate |= float_muladd_negate_result;
+			}
+			gen_get_gpr(r3, rs3);
+			gen_helper_fmaf_s(r3, cpu_env, r2, r1, r3, tcg_constant_i32(negate));
+			gen_set_gpr(rs3, r3);
+		}	break;
+		default:
+			g_assert_not_reached();
+		}
+		break;
+	}
+
+	tcg_temp_free(r1);
+	tcg_temp_free(r2);
+	tcg_temp_free(r3);
+	tcg_temp_free_i64(d1);
+	tcg_temp_free_i64(d2);
+	tcg_temp_free_i64(d3);
+}
+
 static void gen_arithmetic(DisasContext *ctx, int rs1, int rs2, int operation)
 {
 	TCGv r1 = tcg_temp_new();
@@ -1034,7 +1654,7 @@ static void gen_arithmetic(DisasContext *ctx, int rs1, int rs2, int operation)
 			tcg_gen_add_tl(tcg_result, r2, r1);
 			gen_set_gpr(rs2, tcg_result);
 
-			gen_flags_on_add(r1, r2);
+			gen_lazy_flags_on_add(ctx, r1, r2);
 
 		}	break;
 
@@ -1047,7 +1667,7 @@ static void gen_arithmetic(DisasContext *ctx, int rs1, int rs2, int operation)
 			tcg_gen_add_tl(tcg_result, r2, tcg_imm);
 			gen_set_gpr(rs2, tcg_result);
 
-			gen_flags_on_add(r2, tcg_imm);
+			gen_lazy_flags_on_add(ctx, r2, tcg_imm);
 
 			break;
 
@@ -1058,12 +1678,12 @@ static void gen_arithmetic(DisasContext *ctx, int rs1, int rs2, int operation)
 			tcg_gen_add_tl(r2,r1, tcg_imm);
 			gen_set_gpr(rs2, r2);
 
-			gen_flags_on_add(r1, tcg_imm);
+			gen_lazy_flags_on_add(ctx, r1, tcg_imm);
 
 			break;
 
 		case OPC_RH850_CMP_reg1_reg2:	{
-			gen_flags_on_sub(r2, r1);
+			gen_lazy_flags_on_sub(ctx, r2, r1);
 		}	break;
 
 		case OPC_RH850_CMP_imm5_reg2:	{
@@ -1074,7 +1694,7 @@ static void gen_arithmetic(DisasContext *ctx, int rs1, int rs2, int operation)
 			tcg_gen_movi_tl(tcg_imm, imm);
 			tcg_gen_ext8s_i32(tcg_imm, tcg_imm);
 
-			gen_flags_on_sub(r2, tcg_imm);
+			gen_lazy_flags_on_sub(ctx, r2, tcg_imm);
 
 		}	break;
 
@@ -1123,13 +1743,13 @@ static void gen_arithmetic(DisasContext *ctx, int rs1, int rs2, int operation)
 
 			tcg_gen_sub_tl(tcg_result, r2, r1);
 			gen_set_gpr(rs2, tcg_result);
-			gen_flags_on_sub(r2, r1);
+			gen_lazy_flags_on_sub(ctx, r2, r1);
 			break;
 
 		case OPC_RH850_SUBR_reg1_reg2:
 			tcg_gen_sub_tl(tcg_result, r1, r2);
 			gen_set_gpr(rs2, tcg_result);
-			gen_flags_on_sub(r1, r2);
+			gen_lazy_flags_on_sub(ctx, r1, r2);
 			break;
 	}
 
@@ -1140,6 +1760,10 @@ static void gen_arithmetic(DisasContext *ctx, int rs1, int rs2, int operation)
 	tcg_temp_free(tcg_result);
 }
 
+/*
+ * The condition is evaluated from the lazy flags, then ADF and SBF set
+ * all four flags directly.
+ */
 static void gen_cond_arith(DisasContext *ctx, int rs1, int rs2, int operation)
 {
 	TCGv r1 = tcg_temp_local_new();
@@ -1179,7 +1803,7 @@ static void gen_cond_arith(DisasContext *ctx, int rs1, int rs2, int operation)
 			gen_get_gpr(r3_local,int_rs3);
 			tcg_gen_movi_i32(addIfCond, 0x1);
 
-			TCGv condResult = condition_satisfied(int_cond);
+			TCGv condResult = condition_satisfied(ctx, int_cond);
 			cont = gen_new_label();
 
 			tcg_gen_brcondi_i32(TCG_COND_NE, condResult, 0x1, cont);
@@ -1197,6 +1821,7 @@ static void gen_cond_arith(DisasContext *ctx, int rs1, int rs2, int operation)
 			gen_flags_on_add(r1_local, r2_local);
 			tcg_gen_or_tl(cpu_CYF, cpu_CYF, carry);
             tcg_gen_or_tl(cpu_OVF, cpu_OVF, overflow);
+            ctx->cc_op = CC_OP_FLAGS;
 
 		    tcg_temp_free(condResult);
 			tcg_temp_free_i32(r1_local);
@@ -1234,11 +1859,12 @@ static void gen_cond_arith(DisasContext *ctx, int rs1, int rs2, int operation)
 			//tcg_gen_mov_i32(r2_local, r2);
 			tcg_gen_mov_i32(r3_local, r2);
 
-            TCGv condResult = condition_satisfied(int_cond);
+            TCGv condResult = condition_satisfied(ctx, int_cond);
             // store to local temp, because condResult is valid only until branch in gen_flags_on_sub
             tcg_gen_mov_tl(tmpReg, condResult);
 
             gen_flags_on_sub(r3_local, r1);
+            ctx->cc_op = CC_OP_FLAGS;
             tcg_gen_mov_tl(carry, cpu_CYF);
             tcg_gen_mov_tl(overflow, cpu_OVF);
             tcg_gen_sub_tl(r3_local, r3_local, r1);
@@ -1272,6 +1898,7 @@ static void gen_cond_arith(DisasContext *ctx, int rs1, int rs2, int operation)
 
 static void gen_sat_op(DisasContext *ctx, int rs1, int rs2, int operation)
 {
+	gen_flush_flags(ctx);
 	TCGv r1 = tcg_temp_new();
 	TCGv r2 = tcg_temp_new();
 	gen_get_gpr(r1, rs1);
@@ -1744,7 +2371,7 @@ static void gen_logical(DisasContext *ctx, int rs1, int rs2, int operation)
 		case OPC_RH850_AND_reg1_reg2:
 			tcg_gen_and_tl(r2, r2, r1);
 			gen_set_gpr(rs2, r2);
-			gen_logic_CC(r2);
+			gen_lazy_logic_CC(ctx, r2);
 			break;
 
 		case OPC_RH850_ANDI_imm16_reg1_reg2:
@@ -1753,19 +2380,19 @@ static void gen_logical(DisasContext *ctx, int rs1, int rs2, int operation)
 			tcg_gen_ext16u_i32(tcg_imm, tcg_imm);
 			tcg_gen_and_i32(r2, r1, tcg_imm);
 			gen_set_gpr(rs2, r2);
-			gen_logic_CC(r2);
+			gen_lazy_logic_CC(ctx, r2);
 			break;
 
 		case OPC_RH850_NOT_reg1_reg2:
 			tcg_gen_not_i32(r2, r1);
 			gen_set_gpr(rs2, r2);
-			gen_logic_CC(r2);
+			gen_lazy_logic_CC(ctx, r2);
 			break;
 
 		case OPC_RH850_OR_reg1_reg2:
 			tcg_gen_or_tl(r2, r2, r1);
 			gen_set_gpr(rs2, r2);
-			gen_logic_CC(r2);
+			gen_lazy_logic_CC(ctx, r2);
 			break;
 
 		case OPC_RH850_ORI_imm16_reg1_reg2:
@@ -1775,18 +2402,18 @@ static void gen_logical(DisasContext *ctx, int rs1, int rs2, int operation)
 
 			tcg_gen_or_i32(r2, r1, tcg_imm);
 			gen_set_gpr(rs2, r2);
-			gen_logic_CC(r2);
+			gen_lazy_logic_CC(ctx, r2);
 			break;
 
 		case OPC_RH850_TST_reg1_reg2:
 			tcg_gen_and_i32(result, r1, r2);
-			gen_logic_CC(result);
+			gen_lazy_logic_CC(ctx, result);
 			break;
 
 		case OPC_RH850_XOR_reg1_reg2:
 			tcg_gen_xor_i32(result, r2, r1);
 			gen_set_gpr(rs2, result);
-			gen_logic_CC(result);
+			gen_lazy_logic_CC(ctx, result);
 			break;
 
 		case OPC_RH850_XORI_imm16_reg1_reg2:
@@ -1796,7 +2423,7 @@ static void gen_logical(DisasContext *ctx, int rs1, int rs2, int operation)
 
 			tcg_gen_xor_i32(result, r1, tcg_imm);
 			gen_set_gpr(rs2, result);
-			gen_logic_CC(result);
+			gen_lazy_logic_CC(ctx, result);
 			break;
 	}
 
@@ -1808,6 +2435,23 @@ static void gen_logical(DisasContext *ctx, int rs1, int rs2, int operation)
 
 static void gen_data_manipulation(DisasContext *ctx, int rs1, int rs2, int operation)
 {
+	switch (operation) {
+	case OPC_RH850_CMOV_cccc_reg1_reg2_reg3:
+	case OPC_RH850_CMOV_cccc_imm5_reg2_reg3:
+	case OPC_RH850_SASF_cccc_reg2:
+	case OPC_RH850_SETF_cccc_reg2:
+		// condition_satisfied() evaluates the lazy flags itself
+	case OPC_RH850_SXB_reg1:
+	case OPC_RH850_SXH_reg1:
+	case OPC_RH850_ZXH_reg1:
+	case OPC_RH850_ZXB_reg1:
+		break;
+	default:
+		// some of these write only part of the flags (BINS keeps CY)
+		gen_flush_flags(ctx);
+		break;
+	}
+
 	TCGv tcg_r1 = tcg_temp_new();
 	TCGv tcg_r2 = tcg_temp_new();
 	TCGv tcg_r3 = tcg_temp_new();
@@ -2011,7 +2655,7 @@ static void gen_data_manipulation(DisasContext *ctx, int rs1, int rs2, int opera
 			tcg_gen_mov_i32(r2_local, tcg_r2);
 
 			int_cond = extract32(ctx->opcode, 17, 4);
-			TCGv condResult = condition_satisfied(int_cond);
+			TCGv condResult = condition_satisfied(ctx, int_cond);
 			cont = gen_new_label();
 
 			tcg_gen_mov_tl(r3_local, r2_local);
@@ -2037,7 +2681,7 @@ static void gen_data_manipulation(DisasContext *ctx, int rs1, int rs2, int opera
 			}
 
 			int_cond = extract32(ctx->opcode, 17, 4);
-			TCGv condResult = condition_satisfied(int_cond);
+			TCGv condResult = condition_satisfied(ctx, int_cond);
 			cont = gen_new_label();
 
 			tcg_gen_mov_tl(r3_local, tcg_r2);
@@ -2293,7 +2937,7 @@ static void gen_data_manipulation(DisasContext *ctx, int rs1, int rs2, int opera
 			TCGv operand_local = tcg_temp_local_new_i32();
 
 			int_cond = extract32(ctx->opcode,0,4);
-			TCGv condResult = condition_satisfied(int_cond);
+			TCGv condResult = condition_satisfied(ctx, int_cond);
 			cont = gen_new_label();
 
 			tcg_gen_shli_tl(r2_local, tcg_r2, 0x1);
@@ -2317,7 +2961,7 @@ static void gen_data_manipulation(DisasContext *ctx, int rs1, int rs2, int opera
 
 			TCGv operand_local = tcg_temp_local_new_i32();
 			int_cond = extract32(ctx->opcode,0,4);
-			TCGv condResult = condition_satisfied(int_cond);
+			TCGv condResult = condition_satisfied(ctx, int_cond);
 			cont = gen_new_label();
 
 			tcg_gen_movi_i32(operand_local, 0x00000000);
@@ -2609,6 +3253,7 @@ static void gen_data_manipulation(DisasContext *ctx, int rs1, int rs2, int opera
 
 static void gen_bit_search(DisasContext *ctx, int rs2, int operation)
 {
+	gen_flush_flags(ctx);
 
 	TCGv tcg_r2 = tcg_temp_new();
 	TCGv tcg_r3 = tcg_temp_new();
@@ -2843,6 +3488,8 @@ static void gen_bit_search(DisasContext *ctx, int rs2, int operation)
 
 static void gen_divide(DisasContext *ctx, int rs1, int rs2, int operation)
 {
+	set_insn_cycles(ctx, CYC_DIV);
+	gen_flush_flags(ctx);
 
 	TCGv tcg_r1 = tcg_temp_new();
 	TCGv tcg_r2 = tcg_temp_new();
@@ -3164,10 +3811,12 @@ static void gen_divide(DisasContext *ctx, int rs1, int rs2, int operation)
 static void gen_branch(CPURH850State *env, DisasContext *ctx, uint32_t cond,
                        int rs1, int rs2, target_long bimm)
 {
+    set_insn_cycles(ctx, CYC_BRANCH);
     TCGLabel *l = gen_new_label();
     TCGv condOK = tcg_temp_new();
-    TCGv condResult = condition_satisfied(cond);
+    TCGv condResult = condition_satisfied(ctx, cond);
     tcg_gen_movi_i32(condOK, 0x1);
+    gen_flush_flags(ctx);  // both exits need valid flags
 
     tcg_gen_brcond_tl(TCG_COND_EQ, condResult, condOK, l);
 
@@ -3180,8 +3829,17 @@ static void gen_branch(CPURH850State *env, DisasContext *ctx, uint32_t cond,
    	ctx->base.is_jmp = DISAS_TB_EXIT_ALREADY_GENERATED;
 }
 
+/*
+ * PC relative JR and JARL have static destination and are chained
+ * directly with goto_tb. Register indirect JMP and JARL (including
+ * function returns with JMP [lp]) exit through lookup_and_goto_ptr, so
+ * that execution continues in the destination TB without returning to
+ * the main loop, if the destination is in the per-vCPU jump cache.
+ */
 static void gen_jmp(DisasContext *ctx, int rs1, uint32_t disp32, int operation)
 {
+	set_insn_cycles(ctx, CYC_JUMP);
+	gen_flush_flags(ctx);
 	// disp32 is already generated when entering calling this function
 	int rs2, rs3;
 	TCGv link_addr = tcg_temp_new();
@@ -3190,45 +3848,50 @@ static void gen_jmp(DisasContext *ctx, int rs1, uint32_t disp32, int operation)
 	switch(operation){
 	case OPC_RH850_JR_imm22:
 	case OPC_RH850_JR_imm32:
-		tcg_gen_mov_i32(dest_addr, cpu_pc);
 		break;
 	case OPC_RH850_JARL_disp22_reg2:
-		tcg_gen_mov_i32(dest_addr, cpu_pc);
 		rs2 = extract32(ctx->opcode, 11, 5);
-		tcg_gen_addi_i32(link_addr, cpu_pc, 0x4);
+		tcg_gen_movi_i32(link_addr, ctx->pc + 0x4);
 		gen_set_gpr(rs2, link_addr);
 		break;
 	case OPC_RH850_JARL_disp32_reg1:
-		tcg_gen_mov_i32(dest_addr, cpu_pc);
-		tcg_gen_addi_i32(link_addr, cpu_pc, 0x6);
+		tcg_gen_movi_i32(link_addr, ctx->pc + 0x6);
 		gen_set_gpr(rs1, link_addr);
 		break;
 	case OPC_RH850_JARL_reg1_reg3:
 	    gen_get_gpr(dest_addr, rs1);
 		rs3 = extract32(ctx->opcode, 27, 5);
-		tcg_gen_addi_i32(link_addr, cpu_pc, 0x4);
+		tcg_gen_movi_i32(link_addr, ctx->pc + 0x4);
 		gen_set_gpr(rs3, link_addr);
 		break;
 	default:  // JMP instruction
         gen_get_gpr(dest_addr, rs1);
 	}
 
-	if (disp32) {
-		tcg_gen_addi_tl(dest_addr, dest_addr, disp32);
+	switch(operation){
+	case OPC_RH850_JR_imm22:
+	case OPC_RH850_JR_imm32:
+	case OPC_RH850_JARL_disp22_reg2:
+	case OPC_RH850_JARL_disp32_reg1:
+	    gen_goto_tb_imm(ctx, 0, (ctx->pc + disp32) & 0xfffffffe);
+	    ctx->base.is_jmp = DISAS_TB_EXIT_ALREADY_GENERATED;
+	    break;
+	default:
+	    if (disp32) {
+	        tcg_gen_addi_tl(dest_addr, dest_addr, disp32);
+	    }
+	    tcg_gen_andi_i32(cpu_pc, dest_addr, 0xfffffffe);
+	    ctx->base.is_jmp = DISAS_INDIRECT_JUMP;
 	}
 
-	tcg_gen_andi_i32(dest_addr, dest_addr, 0xfffffffe);
-
-    tcg_gen_mov_i32(cpu_pc, dest_addr);
     tcg_temp_free(link_addr);
     tcg_temp_free(dest_addr);
-
-    gen_goto_tb(ctx, 0, cpu_pc);
-    ctx->base.is_jmp = DISAS_TB_EXIT_ALREADY_GENERATED;
 }
 
 static void gen_loop(DisasContext *ctx, int rs1, int32_t disp16)
 {
+    set_insn_cycles(ctx, CYC_BRANCH);
+    gen_flush_flags(ctx);
     TCGLabel *l = gen_new_label();
     TCGv zero_local = tcg_temp_local_new();
     TCGv r1_local = tcg_temp_local_new();
@@ -3255,200 +3918,113 @@ static void gen_loop(DisasContext *ctx, int rs1, int32_t disp16)
 }
 
 static void gen_bit_manipulation(DisasContext *ctx, int rs1, int rs2, int operation){
+	set_insn_cycles(ctx, CYC_BIT);
+	gen_flush_flags(ctx);
 
-	TCGv r1 = tcg_temp_new_i32();
-	TCGv r2 = tcg_temp_new_i32();
-	TCGv tcg_disp = tcg_temp_new_i32();
-	TCGv one = tcg_temp_new_i32();
-
-	TCGv temp = tcg_temp_new_i32();
-	TCGv test = tcg_temp_new_i32();
 	TCGv adr = tcg_temp_new_i32();
-	uint32_t disp16 = extract32(ctx->opcode, 16, 16);
-
-	int bit;
+	TCGv mask = tcg_temp_new_i32();
+	TCGv temp = tcg_temp_new_i32();
 
 	switch(operation){
 		case OPC_RH850_SET1_reg2_reg1:
-
+		case OPC_RH850_NOT1_reg2_reg1:
+		case OPC_RH850_CLR1_reg2_reg1:
+		case OPC_RH850_TST1_reg2_reg1:
+			// address in reg1, bit number in bits 2-0 of reg2
 			gen_get_gpr(adr, rs1);
-			gen_get_gpr(r2, rs2);
-			tcg_gen_movi_i32(one, 0x1);
-
-			tcg_gen_qemu_ld_i32(temp, adr, MEM_IDX, MO_UB);
-
-			tcg_gen_shl_i32(r2, one, r2);
-
-			tcg_gen_and_i32(test, temp, r2);
-			tcg_gen_setcond_i32(TCG_COND_NE, cpu_ZF, test, r2);
-
-			tcg_gen_or_i32(temp, temp, r2);
-
-			tcg_gen_qemu_st_i32(temp, adr, MEM_IDX, MO_UB);
-
-			break;
-		case OPC_RH850_SET1_bit3_disp16_reg1:
-
-			gen_get_gpr(r1, rs1);
-			tcg_gen_movi_i32(tcg_disp, disp16);
-			tcg_gen_ext16s_i32(tcg_disp, tcg_disp);
-			tcg_gen_add_i32(adr, r1, tcg_disp);
-
-			bit = extract32(ctx->opcode, 11, 3);
-
-			tcg_gen_qemu_ld_i32(temp, adr, MEM_IDX, MO_UB);
-
-			tcg_gen_andi_i32(test, temp, (0x1 << bit));
-			tcg_gen_setcondi_i32(TCG_COND_NE, cpu_ZF, test, (0x1 << bit));
-
-			tcg_gen_ori_i32(temp, temp, (0x1 << bit));
-
-			tcg_gen_qemu_st_i32(temp, adr, MEM_IDX, MO_UB);
+			gen_get_gpr(mask, rs2);
+			tcg_gen_andi_i32(mask, mask, 0x7);
+			tcg_gen_shl_i32(mask, tcg_constant_i32(1), mask);
 			break;
-
-		case OPC_RH850_NOT1_reg2_reg1:
-
+		default:
+			// address is reg1 + disp16, bit number in bits 13-11
 			gen_get_gpr(adr, rs1);
-			gen_get_gpr(r2, rs2);
-			tcg_gen_movi_i32(one, 0x1);
-
-			tcg_gen_qemu_ld_i32(temp, adr, MEM_IDX, MO_UB);
-
-			tcg_gen_shl_i32(r2, one, r2); // r2 = mask
-
-			tcg_gen_and_i32(test, temp, r2);
-			tcg_gen_setcond_i32(TCG_COND_NE, cpu_ZF, test, r2);
-
-			//test = temp & mask
-			tcg_gen_and_i32(test, temp, r2);
-			//test = not (test) & mask
-			tcg_gen_not_i32(test, test);
-			tcg_gen_and_i32(test, test, r2);
-			//temp = temp & not(mask)
-			tcg_gen_not_i32(r2, r2);
-			tcg_gen_and_i32(temp, temp, r2);
-			//temp = temp or test
-			tcg_gen_or_i32(temp, temp, test);
-
-			tcg_gen_qemu_st_i32(temp, adr, MEM_IDX, MO_UB);
+			tcg_gen_addi_i32(adr, adr, sextract32(ctx->opcode, 16, 16));
+			tcg_gen_movi_i32(mask, 1 << extract32(ctx->opcode, 11, 3));
 			break;
+	}
 
+	// SET1, NOT1 and CLR1 are atomic, other PEs must not modify the
+	// byte between read and write.
+	switch(operation){
+		case OPC_RH850_SET1_reg2_reg1:
+		case OPC_RH850_SET1_bit3_disp16_reg1:
+			tcg_gen_atomic_fetch_or_i32(temp, adr, mask, ctx->mem_idx, MO_UB);
+			break;
+		case OPC_RH850_NOT1_reg2_reg1:
 		case OPC_RH850_NOT1_bit3_disp16_reg1:
-
-			gen_get_gpr(r1, rs1);
-			tcg_gen_movi_i32(tcg_disp, disp16);
-			tcg_gen_ext16s_i32(tcg_disp, tcg_disp);
-			tcg_gen_add_i32(adr, r1, tcg_disp);
-
-			bit = extract32(ctx->opcode, 11, 3);
-
-			tcg_gen_qemu_ld_i32(temp, adr, MEM_IDX, MO_UB);
-
-			tcg_gen_andi_i32(test, temp, (0x1 << bit));
-			tcg_gen_setcondi_i32(TCG_COND_NE, cpu_ZF, test, (0x1 << bit));
-
-			tcg_gen_movi_i32(r2, (0x1 << bit)); // r2 = mask
-
-			//test = temp & mask
-			tcg_gen_and_i32(test, temp, r2);
-			//test = not (test) & mask
-			tcg_gen_not_i32(test, test);
-			tcg_gen_and_i32(test, test, r2);
-			//temp = temp & not(mask)
-			tcg_gen_not_i32(r2, r2);
-			tcg_gen_and_i32(temp, temp, r2);
-			//temp = temp or test
-			tcg_gen_or_i32(temp, temp, test);
-
-			tcg_gen_qemu_st_i32(temp, adr, MEM_IDX, MO_UB);
+			tcg_gen_atomic_fetch_xor_i32(temp, adr, mask, ctx->mem_idx, MO_UB);
 			break;
-
 		case OPC_RH850_CLR1_reg2_reg1:
-
-			gen_get_gpr(adr, rs1);
-			gen_get_gpr(r2, rs2);
-			tcg_gen_movi_i32(one, 0x1);
-
-			tcg_gen_qemu_ld_i32(temp, adr, MEM_IDX, MO_UB);
-			tcg_gen_andi_i32(r2, r2, 0x7);
-			tcg_gen_shl_i32(r2, one, r2);
-
-			tcg_gen_and_i32(test, temp, r2);
-			tcg_gen_setcond_i32(TCG_COND_NE, cpu_ZF, test, r2);
-
-			tcg_gen_not_i32(r2, r2);
-			tcg_gen_and_i32(temp, temp, r2);
-
-			tcg_gen_qemu_st_i32(temp, adr, MEM_IDX, MO_UB);
-			break;
-
 		case OPC_RH850_CLR1_bit3_disp16_reg1:
-
-			gen_get_gpr(r1, rs1);
-			tcg_gen_movi_i32(tcg_disp, disp16);
-			tcg_gen_ext16s_i32(tcg_disp, tcg_disp);
-			tcg_gen_add_i32(adr, r1, tcg_disp);
-
-			bit = extract32(ctx->opcode, 11, 3);
-
-			tcg_gen_qemu_ld_i32(temp, adr, MEM_IDX, MO_UB);
-
-			tcg_gen_movi_i32(test, (0x1 << bit));
-			tcg_gen_andi_i32(test, temp, (0x1 << bit));
-			tcg_gen_setcondi_i32(TCG_COND_NE, cpu_ZF, test, (0x1 << bit));
-
-			tcg_gen_movi_i32(test, (0x1 << bit));
-			tcg_gen_not_i32(test, test);
-			tcg_gen_and_i32(temp, temp, test);
-
-			tcg_gen_qemu_st_i32(temp, adr, MEM_IDX, MO_UB);
+			tcg_gen_not_i32(temp, mask);
+			tcg_gen_atomic_fetch_and_i32(temp, adr, temp, ctx->mem_idx, MO_UB);
 			break;
-
-		case OPC_RH850_TST1_reg2_reg1:
-
-			gen_get_gpr(adr, rs1);
-			gen_get_gpr(r2, rs2);
-			tcg_gen_movi_i32(one, 0x1);
-
-			tcg_gen_qemu_ld_i32(temp, adr, MEM_IDX, MO_UB);
-
-			tcg_gen_shl_i32(r2, one, r2);
-
-			tcg_gen_and_i32(test, temp, r2);
-			tcg_gen_setcond_i32(TCG_COND_NE, cpu_ZF, test, r2);
-			break;
-
-		case OPC_RH850_TST1_bit3_disp16_reg1:
-
-			gen_get_gpr(r1, rs1);
-			tcg_gen_movi_i32(tcg_disp, disp16);
-			tcg_gen_ext16s_i32(tcg_disp, tcg_disp);
-			tcg_gen_add_i32(adr, r1, tcg_disp);
-
-			bit = extract32(ctx->opcode, 11, 3);
-
-			tcg_gen_qemu_ld_i32(temp, adr, MEM_IDX, MO_UB);
-
-			tcg_gen_movi_i32(test, (0x1 << bit));
-			tcg_gen_andi_i32(test, temp, (0x1 << bit));
-			tcg_gen_setcondi_i32(TCG_COND_NE, cpu_ZF, test, (0x1 << bit));
+		default:
+			tcg_gen_qemu_ld_i32(temp, adr, ctx->mem_idx, MO_UB);
 			break;
 	}
 
-	tcg_temp_free_i32(r1);
-	tcg_temp_free_i32(r2);
-	tcg_temp_free_i32(tcg_disp);
-	tcg_temp_free_i32(one);
-	tcg_temp_free_i32(temp);
-	tcg_temp_free_i32(test);
-	tcg_temp_free_i32(adr);
+	// Z is set if the bit was 0 before the operation
+	tcg_gen_and_i32(temp, temp, mask);
+	tcg_gen_setcondi_i32(TCG_COND_EQ, cpu_ZF, temp, 0);
 
+	tcg_temp_free_i32(adr);
+	tcg_temp_free_i32(mask);
+	tcg_temp_free_i32(temp);
 }
 
 
+static void set_special_insn_cycles(DisasContext *ctx, int rs1, int operation)
+{
+    switch (operation) {
+    case OPC_RH850_CALLT_imm6:
+        set_insn_cycles(ctx, CYC_CALLT);
+        break;
+    case OPC_RH850_SWITCH_reg1:
+        set_insn_cycles(ctx, CYC_SWITCH);
+        break;
+    case OPC_RH850_CAXI_reg1_reg2_reg3:
+        set_insn_cycles(ctx, CYC_ATOMIC);
+        break;
+    case OPC_RH850_CTRET:
+    case OPC_RH850_EIRET:
+    case OPC_RH850_FERET:
+        set_insn_cycles(ctx, CYC_RET);
+        break;
+    case OPC_RH850_TRAP:
+    case OPC_RH850_FETRAP_vector4:
+    case OPC_RH850_SYSCALL:
+        set_insn_cycles(ctx, CYC_TRAP);
+        break;
+    case OPC_RH850_SYNCE:
+    case OPC_RH850_SYNCM:
+    case OPC_RH850_SYNCP:
+        set_insn_cycles(ctx, CYC_SYNC);
+        break;
+    case OPC_RH850_PREPARE_list12_imm5:
+    case OPC_RH850_PREPARE_list12_imm5_sp:
+    case OPC_RH850_DISPOSE_imm5_list12:
+    case OPC_RH850_DISPOSE_imm5_list12_reg1:
+        set_insn_cycles(ctx, CYC_STACK);
+        ctx->insn_cycles += ctpop32(extract32(ctx->opcode, 0, 1)) +
+                            ctpop32(extract32(ctx->opcode, 21, 11));
+        break;
+    case OPC_RH850_PUSHSP_rh_rt:
+    case OPC_RH850_POPSP_rh_rt:
+        set_insn_cycles(ctx, CYC_STACK);
+        ctx->insn_cycles += MAX((int)extract32(ctx->opcode, 27, 5) - rs1 + 1, 0);
+        break;
+    default:
+        set_insn_cycles(ctx, CYC_ALU);
+        break;
+    }
+}
+
 static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2, int operation){
+	gen_flush_flags(ctx);
+	set_special_insn_cycles(ctx, rs1, operation);
 
-	TCGLabel *storeReg3;
 	TCGLabel *cont;
 	TCGLabel *excFromEbase;
 	TCGLabel * add_scbp;
@@ -3460,25 +4036,28 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 	case OPC_RH850_CALLT_imm6: {
         TCGv temp = tcg_temp_new_i32();
         TCGv adr = tcg_temp_new_i32();
+        TCGv ctbp = tcg_temp_new_i32();
 
 		//setting CTPC to PC+2
-		tcg_gen_addi_i32(cpu_sysRegs[BANK_ID_BASIC_0][CTPC_IDX], cpu_pc, 0x2);
+		tcg_gen_movi_i32(cpu_ctpc, ctx->pc + 0x2);
 		//setting CPTSW bits 0:4
-		flags_to_tcgv_z_cy_ov_s_sat(cpu_sysRegs[BANK_ID_BASIC_0][CTPSW_IDX]);
+		flags_to_tcgv_z_cy_ov_s_sat(cpu_ctpsw);
 
 		imm = extract32(ctx->opcode, 0, 6);
 		tcg_gen_movi_i32(adr, imm);
 		tcg_gen_shli_i32(adr, adr, 0x1);
 		tcg_gen_ext8s_i32(adr, adr);
-		tcg_gen_add_i32(adr, cpu_sysRegs[BANK_ID_BASIC_0][CTBP_IDX], adr);
+		gen_get_sysreg(ctbp, BANK_ID_BASIC_0, CTBP_IDX);
+		tcg_gen_add_i32(adr, ctbp, adr);
 
-		tcg_gen_qemu_ld16u(temp, adr, 0);
+		tcg_gen_qemu_ld16u(temp, adr, ctx->mem_idx);
 
-		tcg_gen_add_i32(cpu_pc, temp, cpu_sysRegs[BANK_ID_BASIC_0][CTBP_IDX]);
-	    ctx->base.is_jmp = DISAS_EXIT_TB;
+		tcg_gen_add_i32(cpu_pc, temp, ctbp);
+	    ctx->base.is_jmp = DISAS_INDIRECT_JUMP;
 
 	    tcg_temp_free(temp);
 	    tcg_temp_free(adr);
+	    tcg_temp_free(ctbp);
 	} break;
 
 	case OPC_RH850_CAXI_reg1_reg2_reg3: {
@@ -3486,37 +4065,17 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 	    TCGv adr = tcg_temp_new_i32();
 	    TCGv r2 = tcg_temp_new();
 	    TCGv r3 = tcg_temp_new();
+		int rs3 = extract32(ctx->opcode, 27, 5);
 
-		storeReg3 = gen_new_label();
 		gen_get_gpr(adr, rs1);
 		gen_get_gpr(r2, rs2);
-		int rs3 = extract32(ctx->opcode, 27, 5);
 		gen_get_gpr(r3, rs3);
-		tcg_gen_qemu_ld32u(temp, adr, 0);
-		storeReg3 = gen_new_label();
-		cont = gen_new_label();
-
-		TCGv local_adr = tcg_temp_local_new_i32();
-		TCGv local_r2 = tcg_temp_local_new_i32();
-		TCGv local_r3 = tcg_temp_local_new_i32();
-		TCGv local_temp = tcg_temp_local_new_i32();
 
-		tcg_gen_mov_i32(local_adr, adr);
-		tcg_gen_mov_i32(local_r2, r2);
-		tcg_gen_mov_i32(local_r3, r3);
-		tcg_gen_mov_i32(local_temp, temp);
-
-		gen_flags_on_sub(local_r2, local_temp);
-
-		tcg_gen_brcondi_i32(TCG_COND_EQ, cpu_ZF, 0x1, storeReg3);
-		tcg_gen_qemu_st_tl(local_temp, local_adr, MEM_IDX, MO_TESL);
-		tcg_gen_br(cont);
-
-		gen_set_label(storeReg3);
-		tcg_gen_qemu_st_tl(local_r3, local_adr, MEM_IDX, MO_TESL);
-
-		gen_set_label(cont);
-		gen_set_gpr(rs3, local_temp);
+		// Writing back the loaded value when the comparison fails does
+		// not change memory, so CAXI is a plain compare-and-swap.
+		tcg_gen_atomic_cmpxchg_tl(temp, adr, r2, r3, ctx->mem_idx, MO_TESL);
+		gen_flags_on_sub(r2, temp);
+		gen_set_gpr(rs3, temp);
 
         tcg_temp_free(temp);
         tcg_temp_free(adr);
@@ -3528,10 +4087,10 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 	case OPC_RH850_CTRET: {
 	    TCGv temp = tcg_temp_new_i32();
 
-		tcg_gen_mov_i32(cpu_pc, cpu_sysRegs[BANK_ID_BASIC_0][CTPC_IDX]);
-		tcgv_to_flags_z_cy_ov_s_sat(cpu_sysRegs[BANK_ID_BASIC_0][CTPSW_IDX]);
+		tcg_gen_mov_i32(cpu_pc, cpu_ctpc);
+		tcgv_to_flags_z_cy_ov_s_sat(cpu_ctpsw);
 
-	    ctx->base.is_jmp = DISAS_EXIT_TB;
+	    ctx->base.is_jmp = DISAS_INDIRECT_JUMP;
 
 	    tcg_temp_free(temp);
 	} break;
@@ -3573,7 +4132,7 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 			tcg_gen_andi_i32(adr, temp, 0xfffffffc); //masking the lower two bits
 
 			if( !((dispList & test)==0x0) ){
-				tcg_gen_qemu_ld_i32(regToLoad, adr, MEM_IDX, MO_TESL);
+				tcg_gen_qemu_ld_i32(regToLoad, adr, ctx->mem_idx, MO_TESL);
 
 				gen_set_gpr(list[i], regToLoad);
 				tcg_gen_addi_i32(temp, temp, 0x4);
@@ -3622,7 +4181,7 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 			tcg_gen_andi_i32(adr, temp, 0xfffffffc); //masking the lower two bits
 
 			if( !((dispList & test)==0x0) ){
-				tcg_gen_qemu_ld_i32(regToLoad, adr, MEM_IDX, MO_TESL);
+				tcg_gen_qemu_ld_i32(regToLoad, adr, ctx->mem_idx, MO_TESL);
 
 				gen_set_gpr(list[i], regToLoad);
 				tcg_gen_addi_i32(temp, temp, 0x4);
@@ -3634,7 +4193,7 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 		tcg_gen_mov_i32(cpu_pc, jmpAddr);
 
 		gen_set_gpr(3, temp);
-	    ctx->base.is_jmp = DISAS_EXIT_TB;
+	    ctx->base.is_jmp = DISAS_INDIRECT_JUMP;
 
 	    tcg_temp_free(temp);
         tcg_temp_free(adr);
@@ -3643,15 +4202,40 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 
 	case OPC_RH850_EI:
 		tcg_gen_movi_i32(cpu_ID, 0x0);
-		break;
-	case OPC_RH850_EIRET:
-		tcg_gen_mov_i32(cpu_pc, cpu_sysRegs[BANK_ID_BASIC_0][EIPC_IDX]);
-        tcgv_to_flags(cpu_sysRegs[BANK_ID_BASIC_0][EIPSW_IDX]);
+		// pending interrupts are checked only between TBs
+		tcg_gen_movi_i32(cpu_pc, ctx->base.pc_next);
 	    ctx->base.is_jmp = DISAS_EXIT_TB;
 		break;
+	case OPC_RH850_EIRET: {
+	    TCGv ispr = tcg_temp_new_i32();
+	    TCGv cleared = tcg_temp_new_i32();
+	    TCGv keep = tcg_temp_new_i32();
+	    TCGv zero = tcg_const_i32(0);
+
+	    // Return from EIINT clears the highest priority in-service bit,
+	    // unless PSW.EP is set (return from exception) or ISPR is
+	    // managed by software (INTCFG.ISPC).
+	    gen_get_sysreg(ispr, BANK_ID_BASIC_2, ISPR_IDX2);
+	    tcg_gen_subi_i32(cleared, ispr, 1);
+	    tcg_gen_and_i32(cleared, cleared, ispr);
+	    gen_get_sysreg(keep, BANK_ID_BASIC_2, INTCFG_IDX2);
+	    tcg_gen_andi_i32(keep, keep, INTCFG_ISPC);
+	    tcg_gen_or_i32(keep, keep, cpu_EP);
+	    tcg_gen_movcond_i32(TCG_COND_EQ, ispr, keep, zero, cleared, ispr);
+	    gen_set_sysreg(BANK_ID_BASIC_2, ISPR_IDX2, ispr);
+
+		tcg_gen_mov_i32(cpu_pc, cpu_eipc);
+        tcgv_to_flags(cpu_eipsw);
+	    ctx->base.is_jmp = DISAS_EXIT_TB;
+
+	    tcg_temp_free(ispr);
+	    tcg_temp_free(cleared);
+	    tcg_temp_free(keep);
+	    tcg_temp_free(zero);
+	}	break;
 	case OPC_RH850_FERET:
-		tcg_gen_mov_i32(cpu_pc, cpu_sysRegs[BANK_ID_BASIC_0][FEPC_IDX]);
-        tcgv_to_flags(cpu_sysRegs[BANK_ID_BASIC_0][FEPSW_IDX]);
+		tcg_gen_mov_i32(cpu_pc, cpu_fepc);
+        tcgv_to_flags(cpu_fepsw);
 	    ctx->base.is_jmp = DISAS_EXIT_TB;
 		break;
 
@@ -3660,12 +4244,12 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 		cont = gen_new_label();
 		excFromEbase = gen_new_label();
 		int vector = extract32(ctx->opcode, 11, 4);
-		tcg_gen_addi_i32(cpu_sysRegs[BANK_ID_BASIC_0][FEPC_IDX], cpu_pc, 0x2);
-		flags_to_tcgv(cpu_sysRegs[BANK_ID_BASIC_0][FEPSW_IDX]);
+		tcg_gen_movi_i32(cpu_fepc, ctx->pc + 0x2);
+		flags_to_tcgv(cpu_fepsw);
 
 		//writing the exception cause code
 		vector += 0x30;
-		tcg_gen_movi_i32(cpu_sysRegs[BANK_ID_BASIC_0][FEIC_IDX], vector);
+		gen_set_sysregi(BANK_ID_BASIC_0, FEIC_IDX, vector);
 		tcg_gen_movi_i32(cpu_UM, 0x0);
 		tcg_gen_movi_i32(cpu_NP, 0x1);
 		tcg_gen_movi_i32(cpu_EP, 0x1);
@@ -3673,11 +4257,11 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 
 		//writing the except. handler address based on PSW.EBV
 		tcg_gen_brcondi_i32(TCG_COND_EQ, cpu_EBV, 0x1, excFromEbase);
-		tcg_gen_addi_i32(cpu_pc, cpu_sysRegs[BANK_ID_BASIC_1][RBASE_IDX1], 0x30);	//RBASE + 0x30
+		gen_jmp_sysreg(BANK_ID_BASIC_1, RBASE_IDX1, 0x30);	//RBASE + 0x30
 		tcg_gen_br(cont);
 
 		gen_set_label(excFromEbase);
-		tcg_gen_addi_i32(cpu_pc, cpu_sysRegs[BANK_ID_BASIC_1][EBASE_IDX1], 0x30); //EBASE + 0x30
+		gen_jmp_sysreg(BANK_ID_BASIC_1, EBASE_IDX1, 0x30); //EBASE + 0x30
 
 		gen_set_label(cont);
 		//branch to exception handler
@@ -3685,8 +4269,9 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 	}	break;
 
 	case OPC_RH850_HALT:
-	    // nop, interupts are not implemented, so HALT would never continue
-	    // tcg_abort();
+		tcg_gen_movi_i32(cpu_pc, ctx->base.pc_next);
+		gen_helper_halt(cpu_env);
+		ctx->base.is_jmp = DISAS_NORETURN;
 		break;
 
     case OPC_RH850_LDSR_reg2_regID_selID:
@@ -3696,21 +4281,49 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
         // Modify only sytem regs, which exist. Real device executes instruction, but
         // value is not stored for system regs, which do not exist. No exception is
         // thrown.
-        if(cpu_sysRegs[selID][regID] != NULL  ||  (selID == BANK_ID_BASIC_0  &&  regID == PSW_IDX)) {
+        if(sysreg_exists(selID, regID)  ||  (selID == BANK_ID_BASIC_0  &&  regID == PSW_IDX)) {
 
             TCGv tmp = tcg_temp_new();
             gen_get_gpr(tmp, rs1);
 
             if(selID == BANK_ID_BASIC_0  &&  regID == PSW_IDX){
                 tcgv_to_flags(tmp);
+                // PSW.CU0 is part of TB flags, continue in a new TB
+                tcg_gen_movi_tl(cpu_pc, ctx->base.pc_next);
+                ctx->base.is_jmp = DISAS_EXIT_TB;
+            } else if (selID == BANK_ID_BASIC_0  &&  rh850_is_fpsr_view(regID)) {
+                TCGv tcg_regID = tcg_const_i32(regID);
+                gen_helper_ldsr_fpu(cpu_env, tcg_regID, tmp);
+                tcg_temp_free(tcg_regID);
+            } else if (rh850_mpu_sysreg(selID, regID)) {
+                gen_helper_ldsr_mpu(cpu_env, tcg_constant_i32(selID),
+                                    tcg_constant_i32(regID), tmp);
             } else {
                 // clear read-only bits in value, all other bits in sys reg. This way
                 // read-only bits preserve their value given at reset
-                tcg_gen_andi_i32(tmp, tmp, rh850_sys_reg_read_only_masks[selID][regID]);
-                tcg_gen_andi_i32(cpu_sysRegs[selID][regID], cpu_sysRegs[selID][regID], ~rh850_sys_reg_read_only_masks[selID][regID]);
-                tcg_gen_or_i32(cpu_sysRegs[selID][regID], cpu_sysRegs[selID][regID], tmp);
+                uint32_t mask = rh850_sys_reg_read_only_masks[selID][regID];
+
+                if (mask != 0xffffffff) {
+                    TCGv old = tcg_temp_new();
+                    gen_get_sysreg(old, selID, regID);
+                    tcg_gen_andi_i32(old, old, ~mask);
+                    tcg_gen_andi_i32(tmp, tmp, mask);
+                    tcg_gen_or_i32(tmp, tmp, old);
+                    tcg_temp_free(old);
+                }
+                gen_set_sysreg(selID, regID, tmp);
             }
             tcg_temp_free(tmp);
+
+            // PMR and INTCFG control acceptance of interrupts, which are
+            // checked only between TBs. MPU registers change permissions
+            // of already translated code. LDSR to PSW has already ended
+            // the TB.
+            if ((selID == BANK_ID_BASIC_2  &&  (regID == PMR_IDX2  ||  regID == INTCFG_IDX2))  ||
+                rh850_mpu_sysreg(selID, regID)) {
+                tcg_gen_movi_i32(cpu_pc, ctx->base.pc_next);
+                ctx->base.is_jmp = DISAS_EXIT_TB;
+            }
         }
 		break;
 
@@ -3737,7 +4350,7 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 
 				tcg_gen_andi_i32(adr, temp, 0xfffffffc); // masking the lower two bits
 
-				tcg_gen_qemu_ld_i32(regToLoad, adr, MEM_IDX, MO_TESL);
+				tcg_gen_qemu_ld_i32(regToLoad, adr, ctx->mem_idx, MO_TESL);
 
 				gen_set_gpr(rs3-i, regToLoad);
 				tcg_gen_addi_i32(temp, temp, 0x4);
@@ -3782,7 +4395,7 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 				tcg_gen_subi_i32(temp, temp, 0x4);
 				tcg_gen_andi_i32(adr, temp, 0xfffffffc); //masking the lower two bits
 				gen_get_gpr(regToStore, list[i]);
-				tcg_gen_qemu_st_i32(regToStore, adr, MEM_IDX, MO_TESL);
+				tcg_gen_qemu_st_i32(regToStore, adr, ctx->mem_idx, MO_TESL);
 				gen_set_gpr(list[i], regToStore);
 			}
 			test = test << 1;
@@ -3827,7 +4440,7 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 				tcg_gen_subi_i32(temp, temp, 0x4);
 				tcg_gen_andi_i32(adr, temp, 0xfffffffc); //masking the lower two bits
 				gen_get_gpr(regToStore, list[i]);
-				tcg_gen_qemu_st32(regToStore, adr, MEM_IDX);
+				tcg_gen_qemu_st32(regToStore, adr, ctx->mem_idx);
 				gen_set_gpr(list[i], regToStore);
 			}
 			test = test << 1;
@@ -3892,7 +4505,7 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 
 				gen_get_gpr(regToStore, rs1+i);
 
-				tcg_gen_qemu_st_i32(regToStore, adr, MEM_IDX, MO_TESL);
+				tcg_gen_qemu_st_i32(regToStore, adr, ctx->mem_idx, MO_TESL);
 				}
 			gen_set_gpr(3, temp);
 		}
@@ -3906,21 +4519,21 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 		cont = gen_new_label();
 		excFromEbase = gen_new_label();
 
-		tcg_gen_mov_i32(cpu_sysRegs[BANK_ID_BASIC_0][FEPC_IDX], cpu_pc);
-		flags_to_tcgv(cpu_sysRegs[BANK_ID_BASIC_0][FEPSW_IDX]);
+		tcg_gen_movi_i32(cpu_fepc, ctx->pc);
+		flags_to_tcgv(cpu_fepsw);
 		//writing exception cause code
-		tcg_gen_movi_i32(cpu_sysRegs[BANK_ID_BASIC_0][FEIC_IDX], 0x60);
+		gen_set_sysregi(BANK_ID_BASIC_0, FEIC_IDX, 0x60);
 		tcg_gen_movi_i32(cpu_UM, 0x0);
 		tcg_gen_movi_i32(cpu_NP, 0x1);
 		tcg_gen_movi_i32(cpu_EP, 0x1);
 		tcg_gen_movi_i32(cpu_ID, 0x1);
 
 		tcg_gen_brcondi_i32(TCG_COND_EQ, cpu_EBV, 0x1, excFromEbase);
-		tcg_gen_addi_i32(cpu_pc, cpu_sysRegs[BANK_ID_BASIC_1][RBASE_IDX1], 0x60);	//RBASE + 0x60
+		gen_jmp_sysreg(BANK_ID_BASIC_1, RBASE_IDX1, 0x60);	//RBASE + 0x60
 		tcg_gen_br(cont);
 
 		gen_set_label(excFromEbase);
-		tcg_gen_addi_i32(cpu_pc, cpu_sysRegs[BANK_ID_BASIC_1][EBASE_IDX1], 0x60);	//EBASE + 0x60
+		gen_jmp_sysreg(BANK_ID_BASIC_1, EBASE_IDX1, 0x60);	//EBASE + 0x60
 
 		gen_set_label(cont);
 		//branch to exception handler
@@ -3929,6 +4542,9 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 	}	break;
 
 	case OPC_RH850_SNOOZE:
+		tcg_gen_movi_i32(cpu_pc, ctx->base.pc_next);
+		gen_helper_snooze(cpu_env);
+		ctx->base.is_jmp = DISAS_NORETURN;
 		break;
 
 	//case OPC_RH850_STCW:
@@ -3943,9 +4559,19 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
             flags_to_tcgv(tmp);
             gen_set_gpr(rs2, tmp);
             tcg_temp_free(tmp);
+        } else if (selID == BANK_ID_BASIC_0  &&  rh850_is_fpsr_view(regID)) {
+            TCGv tmp = tcg_temp_new_i32();
+            TCGv tcg_regID = tcg_const_i32(regID);
+            gen_helper_stsr_fpu(tmp, cpu_env, tcg_regID);
+            gen_set_gpr(rs2, tmp);
+            tcg_temp_free(tcg_regID);
+            tcg_temp_free(tmp);
         } else {
-            if (cpu_sysRegs[selID][regID] != NULL) {
-                gen_set_gpr(rs2, cpu_sysRegs[selID][regID]);
+            if (sysreg_exists(selID, regID)) {
+                TCGv tmp = tcg_temp_new_i32();
+                gen_get_sysreg(tmp, selID, regID);
+                gen_set_gpr(rs2, tmp);
+                tcg_temp_free(tmp);
             } else {
                 TCGv dat = tcg_temp_local_new();
                 tcg_gen_movi_i32(dat, 0);
@@ -3961,22 +4587,24 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 
 		gen_get_gpr(adr, rs1);
 		tcg_gen_shli_i32(adr, adr, 0x1);
-		tcg_gen_add_i32(adr, adr, cpu_pc);
-		tcg_gen_addi_i32(adr, adr, 0x2);
+		tcg_gen_addi_i32(adr, adr, ctx->pc + 0x2);
 
-		tcg_gen_addi_i32(cpu_pc, cpu_pc, 0x2);
-		tcg_gen_qemu_ld16s(temp, adr, MEM_IDX);
+		tcg_gen_qemu_ld16s(temp, adr, ctx->mem_idx);
 		tcg_gen_ext16s_i32(temp, temp);
 		tcg_gen_shli_i32(temp, temp, 0x1);
-		tcg_gen_add_i32(cpu_pc, cpu_pc, temp);
-	    ctx->base.is_jmp = DISAS_EXIT_TB;
+		tcg_gen_addi_i32(cpu_pc, temp, ctx->pc + 0x2);
+	    ctx->base.is_jmp = DISAS_INDIRECT_JUMP;
 	} break;
 
-	// SYNC instructions will not be implemented
-	case OPC_RH850_SYNCE:
+	// SYNCI only has to discard prefetched instructions, which is
+	// done by invalidation of TBs on code modification.
 	case OPC_RH850_SYNCI:
+		break;
+	// Accesses of other PEs are only ordered by barriers
+	case OPC_RH850_SYNCE:
 	case OPC_RH850_SYNCM:
 	case OPC_RH850_SYNCP:
+		tcg_gen_mb(TCG_MO_ALL | TCG_BAR_SC);
 		break;
 
 	case OPC_RH850_TRAP: {
@@ -3986,9 +4614,9 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 
 		uint32_t offset;
 		int vector5 = rs1;
-		tcg_gen_addi_i32(cpu_sysRegs[BANK_ID_BASIC_0][EIPC_IDX], cpu_pc, 0x4);
-		flags_to_tcgv(cpu_sysRegs[BANK_ID_BASIC_0][EIPSW_IDX]);
-		tcg_gen_movi_i32(cpu_sysRegs[BANK_ID_BASIC_0][EIIC_IDX], (0x40 + vector5));
+		tcg_gen_movi_i32(cpu_eipc, ctx->pc + 0x4);
+		flags_to_tcgv(cpu_eipsw);
+		gen_set_sysregi(BANK_ID_BASIC_0, EIIC_IDX, (0x40 + vector5));
 		tcg_gen_movi_i32(cpu_UM, 0x0);
 		tcg_gen_movi_i32(cpu_EP, 0x1);
 		tcg_gen_movi_i32(cpu_ID, 0x1);  // This bit is under control of winIDEA in single-stepping.
@@ -4002,11 +4630,11 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 		}
 
 		tcg_gen_brcondi_i32(TCG_COND_EQ, cpu_EBV, 0x1, excFromEbase);
-		tcg_gen_addi_i32(cpu_pc, cpu_sysRegs[BANK_ID_BASIC_1][RBASE_IDX1], offset);	//RBASE + offset
+		gen_jmp_sysreg(BANK_ID_BASIC_1, RBASE_IDX1, offset);	//RBASE + offset
 		tcg_gen_br(cont);
 
 		gen_set_label(excFromEbase);
-		tcg_gen_addi_i32(cpu_pc, cpu_sysRegs[BANK_ID_BASIC_1][EBASE_IDX1], offset);	//EBASE + offset
+		gen_jmp_sysreg(BANK_ID_BASIC_1, EBASE_IDX1, offset);	//EBASE + offset
 
 		gen_set_label(cont);
 	    ctx->base.is_jmp = DISAS_EXIT_TB;
@@ -4022,11 +4650,11 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 
 			int vector = extract32(ctx->opcode, 0, 5) | ( (extract32(ctx->opcode,27, 3)) << 5);
 
-			tcg_gen_addi_i32(cpu_sysRegs[BANK_ID_BASIC_0][EIPC_IDX], cpu_pc, 0x4);
-			flags_to_tcgv(cpu_sysRegs[BANK_ID_BASIC_0][EIPSW_IDX]);
+			tcg_gen_movi_i32(cpu_eipc, ctx->pc + 0x4);
+			flags_to_tcgv(cpu_eipsw);
 			int exception_code = vector + 0x8000;
 
-			tcg_gen_movi_i32(cpu_sysRegs[BANK_ID_BASIC_0][EIIC_IDX], exception_code);
+			gen_set_sysregi(BANK_ID_BASIC_0, EIIC_IDX, exception_code);
 			tcg_gen_movi_i32(cpu_UM, 0x0);
 			tcg_gen_movi_i32(cpu_EP, 0x1);
 			tcg_gen_movi_i32(cpu_ID, 0x1);
@@ -4035,25 +4663,27 @@ static void gen_special(DisasContext *ctx, CPURH850State *env, int rs1, int rs2,
 			tcg_gen_movi_i32(local_vector, vector);
 
 			TCGv local_SCCFG_SIZE = tcg_temp_local_new_i32();
-			tcg_gen_mov_i32(local_SCCFG_SIZE, cpu_sysRegs[BANK_ID_BASIC_1][SCCFG_IDX1]);
+			gen_get_sysreg(local_SCCFG_SIZE, BANK_ID_BASIC_1, SCCFG_IDX1);
 
 			// if vector <= SCCFG
 			// gen_set_gpr(17, local_vector);  // debug!
  			// gen_set_gpr(18, local_SCCFG_SIZE); // debug!
 			tcg_gen_brcond_i32(TCG_COND_LEU, local_vector, local_SCCFG_SIZE, add_scbp);
 			// {
-			tcg_gen_mov_i32(t0, cpu_sysRegs[BANK_ID_BASIC_1][SCBP_IDX1]);
+			gen_get_sysreg(t0, BANK_ID_BASIC_1, SCBP_IDX1);
 			tcg_gen_br(cont);
             // } else {
 			gen_set_label(add_scbp);
 			tcg_gen_shli_tl(local_vector, local_vector, 0x2);
-			tcg_gen_add_i32(t0, local_vector, cpu_sysRegs[BANK_ID_BASIC_1][SCBP_IDX1]); // t0 = adr
+			gen_get_sysreg(t0, BANK_ID_BASIC_1, SCBP_IDX1);
+			tcg_gen_add_i32(t0, local_vector, t0); // t0 = adr
             // }
 			gen_set_label(cont);
 
 			//currently loading unsigned word
-			tcg_gen_qemu_ld_tl(t1, t0, MEM_IDX, MO_TEUL);
-			tcg_gen_add_i32(t1,t1,cpu_sysRegs[BANK_ID_BASIC_1][SCBP_IDX1]);
+			tcg_gen_qemu_ld_tl(t1, t0, ctx->mem_idx, MO_TEUL);
+			gen_get_sysreg(t0, BANK_ID_BASIC_1, SCBP_IDX1);
+			tcg_gen_add_i32(t1, t1, t0);
 
 			tcg_gen_mov_i32(cpu_pc, t1);
 
@@ -4094,786 +4724,454 @@ static void gen_cache(DisasContext *ctx, int rs1, int rs2, int operation){
 	}
 }
 
-static void decode_RH850_48(CPURH850State *env, DisasContext *ctx)
+/*
+ * Instruction decoding is generated by decodetree from insn16.decode,
+ * insn32.decode and insn48.decode. Most trans_* functions only select
+ * the gen_* function and operation, which take further operands from
+ * ctx->opcode.
+ */
+static int ex_shift_1(DisasContext *ctx, int imm)
 {
-	int rs1, rs3;
-	uint64_t opcode48;
+    return imm << 1;
+}
 
-	rs1 = GET_RS1(ctx->opcode);
-	rs3 = extract32(ctx->opcode, 27, 5);
+static int ex_shift_2(DisasContext *ctx, int imm)
+{
+    return imm << 2;
+}
 
-	opcode48 = (ctx->opcode1);
-	opcode48 = (ctx->opcode) | (opcode48  << 0x20);
-	uint32_t opcode20 = extract32(opcode48,0,20) & 0xfffe0;
+#define TRANS(NAME, GEN, OP)                                    \
+static bool trans_##NAME(DisasContext *ctx, arg_##NAME *a)      \
+{                                                               \
+    GEN(ctx, a->r1, a->r2, OP);                                 \
+    return true;                                                \
+}
 
-	uint32_t disp23 = (ctx->opcode1 << 7) | (extract32(ctx->opcode, 21, 6) << 1);
-	uint32_t disp32 = (opcode48 >> 16);
+#define TRANS_SPECIAL(NAME, OP)                                 \
+static bool trans_##NAME(DisasContext *ctx, arg_##NAME *a)      \
+{                                                               \
+    gen_special(ctx, ctx->env, a->r1, a->r2, OP);               \
+    return true;                                                \
+}
 
-	switch(opcode20) {
+#define TRANS_SPECIAL0(NAME, OP)                                \
+static bool trans_##NAME(DisasContext *ctx, arg_##NAME *a)      \
+{                                                               \
+    gen_special(ctx, ctx->env, 0, 0, OP);                       \
+    return true;                                                \
+}
 
+#define TRANS_LOAD(NAME, MEMOP)                                 \
+static bool trans_##NAME(DisasContext *ctx, arg_##NAME *a)      \
+{                                                               \
+    gen_load(ctx, MEMOP, a->r2, a->r1, a->disp, 0);             \
+    return true;                                                \
+}
 
-		case OPC_RH850_LDB2:
-	        gen_load(ctx, MO_SB, rs3, rs1, disp23, 1);
-			break;
-		case OPC_RH850_LDH2:
-	        gen_load(ctx, MO_TESW, rs3, rs1, disp23, 1);
-			break;
-		case OPC_RH850_LDW2:
-	        gen_load(ctx, MO_TESL, rs3, rs1, disp23, 1);
-			break;
-		case OPC_RH850_LDDW:
-	        gen_load(ctx, MO_TEQ, rs3, rs1, disp23, 1);
-			break;
-		case OPC_RH850_LDBU2:
-	        gen_load(ctx, MO_UB, rs3, rs1, disp23, 1);
-			break;
-		case OPC_RH850_LDHU2:
-	        gen_load(ctx, MO_TEUW, rs3, rs1, disp23, 1);
-			break;
+#define TRANS_STORE(NAME, MEMOP)                                \
+static bool trans_##NAME(DisasContext *ctx, arg_##NAME *a)      \
+{                                                               \
+    gen_store(ctx, MEMOP, a->r1, a->r2, a->disp, 0);            \
+    return true;                                                \
+}
 
-		case OPC_RH850_STB2:
-	        gen_store(ctx, MO_SB, rs1, rs3, disp23, 1);
-			break;
-		case OPC_RH850_STH2:
-	        gen_store(ctx, MO_TESW, rs1, rs3, disp23, 1);
-			break;
-		case OPC_RH850_STW2:
-	        gen_store(ctx, MO_TESL, rs1, rs3, disp23, 1);
-			break;
-		case OPC_RH850_STDW:
-	    	gen_store(ctx, MO_TEQ, rs1, rs3, disp23, 1);
-			break;
-	}
+/* Short loads and stores, relative to EP (r30) */
+#define TRANS_SLD(NAME, MEMOP)                                  \
+static bool trans_##NAME(DisasContext *ctx, arg_##NAME *a)      \
+{                                                               \
+    gen_load(ctx, MEMOP, a->r2, 30, a->disp, 0);                \
+    return true;                                                \
+}
+
+#define TRANS_SST(NAME, MEMOP)                                  \
+static bool trans_##NAME(DisasContext *ctx, arg_##NAME *a)      \
+{                                                               \
+    gen_store(ctx, MEMOP, 30, a->r2, a->disp, 0);               \
+    return true;                                                \
+}
 
-	if (extract32(ctx->opcode, 5, 11) == 0x31) {
-		gen_arithmetic(ctx, 0, rs1, OPC_RH850_MOV_imm32_reg1);
-	} else if (extract32(ctx->opcode, 5, 12) == 0x37) {
-		gen_jmp(ctx, rs1, disp32, OPC_RH850_JMP_disp32_reg1);
-	} else if (extract32(ctx->opcode, 5, 11) == 0x17) {
-		if (rs1 == 0x0){
-			gen_jmp(ctx, 0, disp32, OPC_RH850_JR_imm32);
+/* Format XIV, the upper 16 bits of disp23 are in the third halfword */
+#define TRANS_LOAD23(NAME, MEMOP)                               \
+static bool trans_##NAME(DisasContext *ctx, arg_##NAME *a)      \
+{                                                               \
+    gen_load(ctx, MEMOP, a->r3, a->r1,                          \
+             (ctx->opcode1 << 7) | a->disp, 1);                 \
+    return true;                                                \
+}
 
-		} else {
-			gen_jmp(ctx, rs1, disp32, OPC_RH850_JARL_disp32_reg1);
-		}
-	}
+#define TRANS_STORE23(NAME, MEMOP)                              \
+static bool trans_##NAME(DisasContext *ctx, arg_##NAME *a)      \
+{                                                               \
+    gen_store(ctx, MEMOP, a->r1, a->r3,                         \
+              (ctx->opcode1 << 7) | a->disp, 1);                \
+    return true;                                                \
 }
 
-static void decode_RH850_32(CPURH850State *env, DisasContext *ctx)
+/* disp32 and imm32 of 48-bit instructions */
+static uint32_t insn48_imm32(DisasContext *ctx)
 {
-	int rs1;
-	int rs2;
-	int cond;
-	uint32_t op;
-	uint32_t formXop;
-	uint32_t checkXII;
-	uint32_t check32bitZERO;
-	target_long imm_32;
-	target_long ld_imm;
-
-	op = MASK_OP_MAJOR(ctx->opcode);
-	rs1 = GET_RS1(ctx->opcode);			// rs1 is at b0-b4;
-	rs2 = GET_RS2(ctx->opcode);			// rs2 is at b11-b15;
-	TCGv r1 = tcg_temp_local_new();
-	TCGv r2 = tcg_temp_local_new();
-	imm_32 = GET_IMM_32(ctx->opcode);
-	ld_imm = extract32(ctx->opcode, 16, 16);
+    return (ctx->opcode1 << 16) | extract32(ctx->opcode, 16, 16);
+}
 
-	gen_get_gpr(r1, rs1);
-	gen_get_gpr(r2, rs2);
+#include "decode-insn32.c.inc"
+#include "decode-insn16.c.inc"
+#include "decode-insn48.c.inc"
 
-	switch(op){
-
-		case OPC_RH850_LDB:
-	        gen_load(ctx, MO_SB, rs2, rs1, ld_imm, 0);
-	    	break;
-
-	    case OPC_RH850_LDH_LDW:
-	    	if ( extract32(ctx->opcode, 16, 1) == 0 ){
-	    		gen_load(ctx, MO_TESW, rs2, rs1, ld_imm, 0);	// LD.H
-	    	}
-	    	else{
-	    		gen_load(ctx, MO_TESL, rs2, rs1, ld_imm & 0xfffe, 0);	// LD.W
-	    	}
-	    	break;
-
-	    case OPC_RH850_STB:
-	    	gen_store(ctx, MO_SB, rs1, rs2, (extract32(ctx->opcode, 16, 16)), 0);
-	    	break;
-
-	    case OPC_RH850_STH_STW:
-	    	if ( extract32(ctx->opcode, 16, 1)==1 ) {
-	    		gen_store(ctx, MO_TESL, rs1, rs2, ((extract32(ctx->opcode, 17, 15))) << 1, 0);
-	    		//this is STORE WORD
-	    		break;
-	    	}
-	    	gen_store(ctx, MO_TESW, rs1, rs2, ((extract32(ctx->opcode, 17, 15))) << 1, 0);
-	    	//this is STORE HALFWORD
-	    	break;
-
-	    case OPC_RH850_ADDI_imm16_reg1_reg2:
-	    	gen_arithmetic(ctx, rs1,rs2, OPC_RH850_ADDI_imm16_reg1_reg2);
-	    	break;
-
-	    case OPC_RH850_ANDI_imm16_reg1_reg2:
-	    	gen_logical(ctx, rs1, rs2, OPC_RH850_ANDI_imm16_reg1_reg2);
-	    	break;
-
-	    case OPC_RH850_MOVEA:
-	    	if ( extract32(ctx->opcode, 11, 5) == 0 ){
-	    		// This is 48bit MOV
-	    		// This instruction should be reached first in decode_RH850_48
-	    	} else {
-	    		gen_arithmetic(ctx, rs1, rs2, OPC_RH850_MOVEA_imm16_reg1_reg2);
-	    	}
-	    	break;
-
-	    case OPC_RH850_MOVHI_imm16_reg1_reg2:
-	    	if(extract32(ctx->opcode, 11, 5)!=0x0){
-	    		gen_arithmetic(ctx, rs1, rs2, OPC_RH850_MOVHI_imm16_reg1_reg2);
-	    	} else {
-	    		if(extract32(ctx->opcode, 16, 5)==0x0){
-	    			gen_special(ctx, env, rs1, rs2, OPC_RH850_DISPOSE_imm5_list12);
-	    		} else {
-	    			gen_special(ctx, env, rs1, rs2, OPC_RH850_DISPOSE_imm5_list12_reg1);
-	    		}
-	    	}
-	    	break;
-
-	    case OPC_RH850_ORI_imm16_reg1_reg2:
-	    	gen_logical(ctx, rs1, rs2, OPC_RH850_ORI_imm16_reg1_reg2);
-	    	break;
-
-	    case OPC_RH850_SATSUBI_imm16_reg1_reg2:
-	    	if(extract32(ctx->opcode, 11, 5)!=0x0){
-	    		gen_sat_op(ctx, rs1, rs2, OPC_RH850_SATSUBI_imm16_reg1_reg2);
-			} else {
-				if(extract32(ctx->opcode, 16, 5)==0x0){
-					gen_special(ctx, env, rs1, rs2, OPC_RH850_DISPOSE_imm5_list12);
-				} else {
-					gen_special(ctx, env, rs1, rs2, OPC_RH850_DISPOSE_imm5_list12_reg1);
-				}
-			}
+/* Format I */
 
-	    	break;
-	    case OPC_RH850_XORI_imm16_reg1_reg2:
-	    	gen_logical(ctx, rs1, rs2, OPC_RH850_XORI_imm16_reg1_reg2);
-	    	break;
-
-	    case OPC_RH850_LOOP:
-	    	if (extract32(ctx->opcode, 11, 5) == 0x0)
-	    		gen_loop(ctx, rs1, ld_imm & 0xfffe);	// LOOP
-	    	else
-	    		gen_multiply(ctx, rs1, rs2, OPC_RH850_MULHI_imm16_reg1_reg2);
-	    	break;
-	    case OPC_RH850_BIT_MANIPULATION_2:
-
-	    	switch(extract32(ctx->opcode, 14, 2)){
-				case 0:
-					gen_bit_manipulation(ctx, rs1, rs2, OPC_RH850_SET1_bit3_disp16_reg1);
-					break;
-				case 1:
-					gen_bit_manipulation(ctx, rs1, rs2, OPC_RH850_NOT1_bit3_disp16_reg1);
-					break;
-				case 2:
-					gen_bit_manipulation(ctx, rs1, rs2, OPC_RH850_CLR1_bit3_disp16_reg1);
-					break;
-				case 3:
-					gen_bit_manipulation(ctx, rs1, rs2, OPC_RH850_TST1_bit3_disp16_reg1);
-					break;
-				}
-	    	break;
-		case OPC_RH850_32bit_1:		/* case for opcode = 111111 ; formats IX, X, XI, XII */
-			if (extract32(ctx->opcode, 16, 1) == 0x1 ) {
-				if (rs2 == 0x0) {
-					//this is BCOND2
-					cond = extract32(ctx->opcode, 0, 4);
-					imm_32 = (extract32(ctx->opcode, 4, 1) ||
-							(extract32(ctx->opcode, 17, 15) << 1)) << 1;
-					if((imm_32 & 0x10000) == 0x10000){	// checking 17th bit if signed
-						imm_32 |= (0x7fff << 17);
-					}
-					gen_branch(env, ctx, cond, rs1, rs2, imm_32);
-
-					break;
-				} else {
-					//this is LD.HU
-					gen_load(ctx, MO_TEUW, rs2, rs1, ld_imm & 0xfffe, 0);
-					break;
-				}
-			}
-			formXop = MASK_OP_32BIT_SUB(ctx->opcode);		//sub groups based on bits b23-b26
-			switch(formXop){
-				case OPC_RH850_LDSR_RIE_SETF_STSR:
-					check32bitZERO = extract32(ctx->opcode, 21, 2);
-					switch(check32bitZERO){
-					case 0:
-						if(extract32(ctx->opcode, 4, 1)==1){
-							gen_special(ctx, env, rs1, rs2, OPC_RH850_RIE);
-						} else {
-							gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_SETF_cccc_reg2);
-						}
-						break;
-					case OPC_RH850_LDSR_reg2_regID_selID:
-					    gen_special(ctx, env, rs1, rs2, OPC_RH850_LDSR_reg2_regID_selID);
-						break;
-					case OPC_RH850_STSR_regID_reg2_selID:
-						gen_special(ctx, env, rs1, rs2, OPC_RH850_STSR_regID_reg2_selID);
-						break;
-					}
-					break;
-				case OPC_RH850_FORMAT_IX:		//format IX instructions
-					formXop = MASK_OP_FORMAT_IX(ctx->opcode);	//mask on bits 21, 22
-					switch(formXop){
-					case OPC_RH850_BINS_0:
-						if (extract32(ctx->opcode, 20, 1) == 1){
-							//BINS0
-							gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_BINS);
-						}
-						else{
-							if (extract32(ctx->opcode, 17, 1) == 0){
-								gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_SHR_reg1_reg2);
-							}else{
-								gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_SHR_reg1_reg2_reg3);
-							}
-						}
-						break;
-					case OPC_RH850_BINS_1:
-						if (extract32(ctx->opcode, 20, 1) == 1){
-							//BINS1
-							gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_BINS);
-						}
-						else{
-							if (extract32(ctx->opcode, 17, 1) == 0){
-								gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_SAR_reg1_reg2);
-							}else{
-								gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_SAR_reg1_reg2_reg3);
-							}
-						}
-					break;
-					case OPC_RH850_BINS_2:
-						if (extract32(ctx->opcode, 20, 1) == 1){
-							//BINS2
-							gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_BINS);
-						}
-						else{
-							if (extract32(ctx->opcode, 17, 1) == 0){
-								if (extract32(ctx->opcode, 18, 1) == 1){
-									gen_data_manipulation(ctx, rs1, rs2,
-											OPC_RH850_ROTL_imm5_reg2_reg3);
-								}
-								else{
-									gen_data_manipulation(ctx, rs1, rs2,
-											OPC_RH850_SHL_reg1_reg2);
-								}
-							}else{
-								if (extract32(ctx->opcode, 18, 1) == 1){
-									gen_data_manipulation(ctx, rs1, rs2,
-											OPC_RH850_ROTL_reg1_reg2_reg3);
-								}
-								else{
-									gen_data_manipulation(ctx, rs1, rs2,
-											OPC_RH850_SHL_reg1_reg2_reg3);
-								}
-							}
-						}
-						break;
-					case OPC_RH850_BIT_MANIPULATION: // in format IX
-						check32bitZERO = extract32(ctx->opcode, 16, 3);
-						switch(check32bitZERO){
-						case OPC_RH850_SET1_reg2_reg1:
-							gen_bit_manipulation(ctx, rs1, rs2, OPC_RH850_SET1_reg2_reg1);
-							break;
-						case OPC_RH850_NOT1_reg2_reg1:
-							gen_bit_manipulation(ctx, rs1, rs2, OPC_RH850_NOT1_reg2_reg1);
-							break;
-						case OPC_RH850_CLR1_reg2_reg1:
-							gen_bit_manipulation(ctx, rs1, rs2, OPC_RH850_CLR1_reg2_reg1);
-							break;
-						case OPC_RH850_TST1_reg2_reg1:
-							if (extract32(ctx->opcode, 19, 1) == 0){
-								gen_bit_manipulation(ctx, rs1, rs2, OPC_RH850_TST1_reg2_reg1);
-							} else {
-								gen_special(ctx, env, rs1, rs2, OPC_RH850_CAXI_reg1_reg2_reg3);
-							}
-						}
-						break;
-					}
-					break;
-
-
-				case OPC_RH850_FORMAT_X:		//format X instructions
-												//(+JARL3 - added due to MASK_OP_FORMAT_X matching)
-					formXop = MASK_OP_FORMAT_X(ctx->opcode);
-
-					switch(formXop){
-
-						case OPC_RH850_CTRET:
-							gen_special(ctx, env, rs1, rs2, OPC_RH850_CTRET);
-							break;
-						case OPC_RH850_DI:
-							gen_special(ctx, env, rs1, rs2, OPC_RH850_DI);
-							break;
-						case OPC_RH850_EI:
-							gen_special(ctx, env, rs1, rs2, OPC_RH850_EI);
-							break;
-						case OPC_RH850_EIRET:
-							gen_special(ctx, env, rs1, rs2, OPC_RH850_EIRET);
-							break;
-						case OPC_RH850_FERET:
-							gen_special(ctx, env, rs1, rs2, OPC_RH850_FERET);
-							break;
-						case OPC_RH850_HALT:
-							gen_special(ctx, env, rs1, rs2, OPC_RH850_HALT);
-							break;
-						case OPC_RH850_JARL3:
-							gen_jmp(ctx, rs1, 0, OPC_RH850_JARL_reg1_reg3);
-
-							break;
-						case OPC_RH850_SNOOZE:
-							gen_special(ctx, env, rs1, rs2, OPC_RH850_SNOOZE);
-							break;
-						case OPC_RH850_SYSCALL:
-							gen_special(ctx, env, rs1, rs2, OPC_RH850_SYSCALL);
-							break;
-						case OPC_RH850_TRAP:
-							gen_special(ctx, env, rs1, rs2, OPC_RH850_TRAP);
-							break;
-						case OPC_RH850_PREF:
-							//printf("PREF \n");
-							break;
-						case OPC_RH850_POPSP_rh_rt:
-							gen_special(ctx, env, rs1, rs2, OPC_RH850_POPSP_rh_rt);
-							break;
-						case OPC_RH850_PUSHSP_rh_rt:
-							gen_special(ctx, env, rs1, rs2, OPC_RH850_PUSHSP_rh_rt);
-							break;
-						default:
-							if ((extract32(ctx->opcode, 13, 12) == 0xB07))
-							{
-								if ((extract32(ctx->opcode, 27, 5) == 0x1E) &&
-									(extract32(ctx->opcode, 0, 5) == 0x1F))
-								{
-									if ((extract32(ctx->opcode, 23, 4) == 0x2)) // CLL
-										gen_mutual_exclusion(ctx, extract32(ctx->opcode, 27, 5), rs1, operation_CLL);
-								} else {
-									//CACHE; if cacheop bits are 1111110, opcode matches CLL ins,
-									//then they are THE SAME instruction, so this should be correct
-									gen_cache(ctx,rs1,rs2, 1);
-								}
-							} else
-								printf("ERROR! \n");
-						break;
-					}
-					break;
-				case OPC_RH850_MUL_INSTS:
-					if (extract32(ctx->opcode, 22, 1) == 0){
-						if (extract32(ctx->opcode, 21, 1) == 0){
-							gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_SASF_cccc_reg2);
-						} else {
-							if (extract32(ctx->opcode, 17, 1) == 1){
-								gen_multiply(ctx, rs1, rs2, OPC_RH850_MULU_reg1_reg2_reg3);
-							} else {
-								gen_multiply(ctx, rs1, rs2, OPC_RH850_MUL_reg1_reg2_reg3);
-							}
-						}
-						break;
-					} else if (extract32(ctx->opcode, 22, 1) == 1){
-						if (extract32(ctx->opcode, 17, 1) == 1){
-							gen_multiply(ctx, rs1, rs2, OPC_RH850_MULU_imm9_reg2_reg3);
-						} else {
-							gen_multiply(ctx, rs1, rs2, OPC_RH850_MUL_imm9_reg2_reg3);
-						}
-						break;
-					}
-					break;
-
-				case OPC_RH850_FORMAT_XI:			// DIV instructions in format XI
-					formXop = extract32(ctx->opcode, 16, 7);
-					switch(formXop){
-
-						case OPC_RH850_DIV_reg1_reg2_reg3:
-							gen_divide(ctx, rs1, rs2, OPC_RH850_DIV_reg1_reg2_reg3);
-							//DIV
-							break;
-						case OPC_RH850_DIVH_reg1_reg2_reg3:
-							gen_divide(ctx, rs1, rs2, OPC_RH850_DIVH_reg1_reg2_reg3);
-							//DIVH 2
-							break;
-						case OPC_RH850_DIVHU_reg1_reg2_reg3:
-							gen_divide(ctx, rs1, rs2, OPC_RH850_DIVHU_reg1_reg2_reg3);
-							//DIVHU
-							break;
-
-						case OPC_RH850_DIVQ:
-							gen_divide(ctx, rs1, rs2, OPC_RH850_DIV_reg1_reg2_reg3);
-							//DIVQ => using DIV implementation, will be changed if needed
-							break;
-						case OPC_RH850_DIVQU:
-							gen_divide(ctx, rs1, rs2, OPC_RH850_DIVU_reg1_reg2_reg3);
-							//DIVQU => using DIVU implementation, will be changed if needed
-							break;
-						case OPC_RH850_DIVU_reg1_reg2_reg3:
-							gen_divide(ctx, rs1, rs2, OPC_RH850_DIVU_reg1_reg2_reg3);
-							//DIVU
-							break;
-					}
-					break;
-
-				case OPC_RH850_FORMAT_XII:	// for opcode = 0110 ; format XII instructions
-											//excluding MUL and including CMOV
-											// also LDL.W and STC.W	(Format VII)
-					checkXII = extract32(ctx->opcode, 21, 2);
-
-					switch(checkXII){
-					case 0:
-						gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_CMOV_cccc_imm5_reg2_reg3);
-						break;
-					case 1:
-						gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_CMOV_cccc_reg1_reg2_reg3);
-						break;
-					case 2:
-						formXop = extract32(ctx->opcode, 17, 2);
-
-						switch(formXop){
-						case OPC_RH850_BSW_reg2_reg3:
-							gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_BSW_reg2_reg3);
-							break;
-						case OPC_RH850_BSH_reg2_reg3:
-							gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_BSH_reg2_reg3);
-							break;
-						case OPC_RH850_HSW_reg2_reg3:
-							//HSW
-							gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_HSW_reg2_reg3);
-							break;
-						case OPC_RH850_HSH_reg2_reg3:
-							//HSH
-							gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_HSH_reg2_reg3);
-							break;
-						}
-						break;
-					case 3:	//these are SCHOL, SCHOR, SCH1L, SCH1R. 	Also LDL.W
-						formXop = extract32(ctx->opcode, 17, 2);
-						switch(formXop){
-						case OPC_RH850_SCH0R_reg2_reg3:
-							if (extract32(ctx->opcode, 5, 11) == 0x3F &&
-									extract32(ctx->opcode, 16, 5) == 0x18)
-								gen_mutual_exclusion(ctx, extract32(ctx->opcode, 27, 5),
-										rs1, operation_LDL_W);
-							else
-								gen_bit_search(ctx, rs2, OPC_RH850_SCH0R_reg2_reg3);
-							break;
-						case OPC_RH850_SCH1R_reg2_reg3:
-							if (extract32(ctx->opcode, 19, 2) == 0x0){
-								gen_bit_search(ctx, rs2, OPC_RH850_SCH1R_reg2_reg3);
-							} else if (extract32(ctx->opcode, 5, 11) == 0x3F &&
-									extract32(ctx->opcode, 16, 5) == 0x1a)
-								gen_mutual_exclusion(ctx, extract32(ctx->opcode, 27, 5),
-										rs1, operation_STC_W);
-							break;
-						case OPC_RH850_SCH0L_reg2_reg3:
-							gen_bit_search(ctx, rs2, OPC_RH850_SCH0L_reg2_reg3);
-							break;
-						case OPC_RH850_SCH1L_reg2_reg3:
-							gen_bit_search(ctx, rs2, OPC_RH850_SCH1L_reg2_reg3);
-							break;
-						}
-
-					}
-					break;
-
-				case OPC_RH850_ADDIT_ARITH:
-					formXop = extract32(ctx->opcode, 21, 2);
-					switch(formXop){
-
-						case OPC_RH850_ADF_SATADD3:
-							if (extract32(ctx->opcode, 16, 5) == 0x1A){
-								gen_sat_op(ctx, rs1, rs2, OPC_RH850_SATADD_reg1_reg2_reg3);
-							} else {
-								gen_cond_arith(ctx, rs1, rs2, OPC_RH850_ADF_cccc_reg1_reg2_reg3);
-							}
-							break;
-						case OPC_RH850_SBF_SATSUB:
-							if (extract32(ctx->opcode, 16, 5) == 0x1A){
-								gen_sat_op(ctx, rs1, rs2, OPC_RH850_SATSUB_reg1_reg2_reg3);
-							} else {
-								gen_cond_arith(ctx, rs1, rs2, OPC_RH850_SBF_cccc_reg1_reg2_reg3);
-							}
-							break;
-							break;
-						case OPC_RH850_MAC_reg1_reg2_reg3_reg4:
-							gen_mul_accumulate(ctx, rs1, rs2, OPC_RH850_MAC_reg1_reg2_reg3_reg4);
-							break;
-						case OPC_RH850_MACU_reg1_reg2_reg3_reg4:
-							gen_mul_accumulate(ctx, rs1, rs2, OPC_RH850_MACU_reg1_reg2_reg3_reg4);
-							break;
-					}
-			}
-	}
+static bool trans_NOP(DisasContext *ctx, arg_NOP *a)
+{
+    return true;
+}
 
-	if (MASK_OP_FORMAT_V_FORMAT_XIII(ctx->opcode) == OPC_RH850_FORMAT_V_XIII){
-		if(extract32(ctx->opcode, 16, 1) == 0){
-		    uint32_t disp22 = extract32(ctx->opcode, 16, 16) |
-		    		(extract32(ctx->opcode, 0, 6) << 16 );
-		    if( (disp22 & 0x200000) == 0x200000){
-		    	disp22 = disp22 | (0x3ff << 22);
-		    }
+TRANS(MOV_rr, gen_arithmetic, OPC_RH850_MOV_reg1_reg2)
+TRANS(NOT_rr, gen_logical, OPC_RH850_NOT_reg1_reg2)
+TRANS_SPECIAL(SWITCH, OPC_RH850_SWITCH_reg1)
 
-			if (extract32(ctx->opcode, 11, 5) == 0){
-				gen_jmp(ctx, 0, disp22, OPC_RH850_JR_imm22);	//JR disp22
-			} else {
-				gen_jmp(ctx, 0, disp22, OPC_RH850_JARL_disp22_reg2);
+/*
+ * With semihosting enabled, DBTRAP in supervisor mode calls the host with
+ * the ARM semihosting ABI: operation in r6, parameter block in r7 and the
+ * result in r10. Otherwise it decodes as FETRAP 15, as before.
+ */
+static bool trans_DBTRAP(DisasContext *ctx, arg_DBTRAP *a)
+{
+#ifndef CONFIG_USER_ONLY
+    if (semihosting_enabled() && ctx->mem_idx == MMU_SV_IDX) {
+        set_insn_cycles(ctx, CYC_TRAP);
+        gen_exception_insn(ctx, RH850_EXCP_SEMIHOST);
+        return true;
+    }
+#endif
+    return false;
+}
 
+TRANS_SPECIAL(FETRAP, OPC_RH850_FETRAP_vector4)
+TRANS(DIVH_rr, gen_divide, OPC_RH850_DIVH_reg1_reg2)
+TRANS(ZXB, gen_data_manipulation, OPC_RH850_ZXB_reg1)
+TRANS(SXB, gen_data_manipulation, OPC_RH850_SXB_reg1)
+TRANS(ZXH, gen_data_manipulation, OPC_RH850_ZXH_reg1)
+TRANS(SXH, gen_data_manipulation, OPC_RH850_SXH_reg1)
+TRANS(SATSUBR, gen_sat_op, OPC_RH850_SATSUBR_reg1_reg2)
+TRANS(SATSUB_rr, gen_sat_op, OPC_RH850_SATSUB_reg1_reg2)
+TRANS(SATADD_rr, gen_sat_op, OPC_RH850_SATADD_reg1_reg2)
+TRANS(MULH_rr, gen_multiply, OPC_RH850_MULH_reg1_reg2)
+TRANS(OR_rr, gen_logical, OPC_RH850_OR_reg1_reg2)
+TRANS(XOR_rr, gen_logical, OPC_RH850_XOR_reg1_reg2)
+TRANS(AND_rr, gen_logical, OPC_RH850_AND_reg1_reg2)
+TRANS(TST_rr, gen_logical, OPC_RH850_TST_reg1_reg2)
+TRANS(SUBR_rr, gen_arithmetic, OPC_RH850_SUBR_reg1_reg2)
+TRANS(SUB_rr, gen_arithmetic, OPC_RH850_SUB_reg1_reg2)
+TRANS(ADD_rr, gen_arithmetic, OPC_RH850_ADD_reg1_reg2)
+TRANS(CMP_rr, gen_arithmetic, OPC_RH850_CMP_reg1_reg2)
+
+TRANS_SPECIAL0(RIE_16, OPC_RH850_RIE)
+TRANS_SPECIAL0(SYNCI, OPC_RH850_SYNCI)
+TRANS_SPECIAL0(SYNCE, OPC_RH850_SYNCE)
+TRANS_SPECIAL0(SYNCM, OPC_RH850_SYNCM)
+TRANS_SPECIAL0(SYNCP, OPC_RH850_SYNCP)
+
+static bool trans_JMP_r(DisasContext *ctx, arg_JMP_r *a)
+{
+    gen_jmp(ctx, a->r1, 0, OPC_RH850_JMP_reg1);
+    return true;
+}
 
-			}
-		}else{
-			if (extract32(ctx->opcode, 11, 5) != 0){
-				//LD.BU
-				gen_load(ctx, MO_UB, rs2, rs1, (ld_imm & 0xfffe) | extract32(ctx->opcode, 5, 1), 0);
-
-			}else{
-				if (extract32(ctx->opcode, 16, 3) == 0x3){
-					gen_special(ctx, env, rs1, rs2, OPC_RH850_PREPARE_list12_imm5_sp);
-					//PREPARE2
-				}
-				 else if (extract32(ctx->opcode, 16, 3) == 0x1){
-					 gen_special(ctx, env, rs1, rs2, OPC_RH850_PREPARE_list12_imm5);
-					 //PREPARE1
-				 }
-			}
-		}
-	}
+/* Format II */
 
-	tcg_temp_free(r1);
-    tcg_temp_free(r2);
+TRANS_SPECIAL0(CALLT, OPC_RH850_CALLT_imm6)
+
+TRANS(MOV_i5, gen_arithmetic, OPC_RH850_MOV_imm5_reg2)
+TRANS(SATADD_i5, gen_sat_op, OPC_RH850_SATADD_imm5_reg2)
+TRANS(ADD_i5, gen_arithmetic, OPC_RH850_ADD_imm5_reg2)
+TRANS(CMP_i5, gen_arithmetic, OPC_RH850_CMP_imm5_reg2)
+TRANS(SHR_i5, gen_data_manipulation, OPC_RH850_SHR_imm5_reg2)
+TRANS(SAR_i5, gen_data_manipulation, OPC_RH850_SAR_imm5_reg2)
+TRANS(SHL_i5, gen_data_manipulation, OPC_RH850_SHL_imm5_reg2)
+TRANS(MULH_i5, gen_multiply, OPC_RH850_MULH_imm5_reg2)
+
+/* Format III and VII: Bcond */
+
+static bool trans_BCOND_9(DisasContext *ctx, arg_BCOND_9 *a)
+{
+    gen_branch(ctx->env, ctx, a->cond, 0, 0, a->disp);
+    return true;
 }
 
-static void decode_RH850_16(CPURH850State *env, DisasContext *ctx)
+static bool trans_BCOND_17(DisasContext *ctx, arg_BCOND_17 *a)
 {
-	int rs1;
-	int rs2;
-	int cond;
-	uint32_t op;
-	uint32_t subOpCheck;
-	uint32_t imm;
-	uint32_t disp32 = 0;
-
-	op = MASK_OP_MAJOR(ctx->opcode);
-	rs1 = GET_RS1(ctx->opcode);			// rs1 at bits b0-b4;
-	rs2 = GET_RS2(ctx->opcode);			// rs2 at bits b11-b15;
-	imm = rs1;
-
-	if((op & 0xf << 7) == OPC_RH850_BCOND ){ // checking for 4 bit opcode for BCOND
-		cond = extract32(ctx->opcode, 0, 4);
-		imm = ( extract32(ctx->opcode, 4, 3) | (extract32(ctx->opcode, 11, 5) << 3)) << 1 ;
-
-		if ( (imm & 0x100) == 0x100){
-			imm |=  (0x7fffff << 9);
-		}
-		gen_branch(env, ctx, cond, rs1, rs2, imm);
+    gen_branch(ctx->env, ctx, a->cond, 0, 0, a->disp);
+    return true;
+}
 
-		return;
-	}
+/* Format IV, VII and XIV: loads and stores */
+
+TRANS_SLD(SLD_B, MO_SB)
+TRANS_SLD(SLD_BU, MO_UB)
+TRANS_SLD(SLD_H, MO_TESW)
+TRANS_SLD(SLD_HU, MO_TEUW)
+TRANS_SLD(SLD_W, MO_TESL)
+TRANS_SST(SST_B, MO_UB)
+TRANS_SST(SST_H, MO_TEUW)
+TRANS_SST(SST_W, MO_TEUL)
+
+TRANS_LOAD(LD_B, MO_SB)
+TRANS_LOAD(LD_H, MO_TESW)
+TRANS_LOAD(LD_W, MO_TESL)
+TRANS_LOAD(LD_HU, MO_TEUW)
+TRANS_STORE(ST_B, MO_SB)
+TRANS_STORE(ST_H, MO_TESW)
+TRANS_STORE(ST_W, MO_TESL)
+
+static bool trans_LD_BU(DisasContext *ctx, arg_LD_BU *a)
+{
+    if (a->r2 == 0) {
+        return false;
+    }
+    gen_load(ctx, MO_UB, a->r2, a->r1, a->disp, 0);
+    return true;
+}
 
-	switch(op){
-	case OPC_RH850_16bit_0:
-		if (rs2 != 0) {
-			gen_arithmetic(ctx, rs1, rs2, OPC_RH850_MOV_reg1_reg2);
-			break;
-		} else {
-			subOpCheck = MASK_OP_FORMAT_I_0(op);
-			switch(subOpCheck){
-				case OPC_RH850_NOP:
-					break;
-				case OPC_RH850_SYNCI:
-					break;
-				case OPC_RH850_SYNCE:
-					break;
-				case OPC_RH850_SYNCM:
-					break;
-				case OPC_RH850_SYNCP:
-					break;
-			}
-		}
-		break;
+TRANS_LOAD23(LD_B2, MO_SB)
+TRANS_LOAD23(LD_BU2, MO_UB)
+TRANS_LOAD23(LD_H2, MO_TESW)
+TRANS_LOAD23(LD_HU2, MO_TEUW)
+TRANS_LOAD23(LD_W2, MO_TESL)
+TRANS_LOAD23(LD_DW, MO_TEQ)
+TRANS_STORE23(ST_B2, MO_SB)
+TRANS_STORE23(ST_H2, MO_TESW)
+TRANS_STORE23(ST_W2, MO_TESL)
+TRANS_STORE23(ST_DW, MO_TEQ)
+
+/* Format VI */
+
+TRANS(ADDI, gen_arithmetic, OPC_RH850_ADDI_imm16_reg1_reg2)
+TRANS(MOVHI, gen_arithmetic, OPC_RH850_MOVHI_imm16_reg1_reg2)
+TRANS(SATSUBI, gen_sat_op, OPC_RH850_SATSUBI_imm16_reg1_reg2)
+TRANS(ORI, gen_logical, OPC_RH850_ORI_imm16_reg1_reg2)
+TRANS(XORI, gen_logical, OPC_RH850_XORI_imm16_reg1_reg2)
+TRANS(ANDI, gen_logical, OPC_RH850_ANDI_imm16_reg1_reg2)
+TRANS(MULHI, gen_multiply, OPC_RH850_MULHI_imm16_reg1_reg2)
+
+static bool trans_MOVEA(DisasContext *ctx, arg_MOVEA *a)
+{
+    /* reg2 = 0 is MOV imm32, reg1, which is a 48-bit instruction */
+    if (a->r2 == 0) {
+        return false;
+    }
+    gen_arithmetic(ctx, a->r1, a->r2, OPC_RH850_MOVEA_imm16_reg1_reg2);
+    return true;
+}
 
-	case OPC_RH850_16bit_2:
-		if (rs2 == 0){
-			if (rs1 == 0){
-				gen_special(ctx, env, rs1, rs2, OPC_RH850_RIE);
-				break;
-			} else {
-				gen_special(ctx, env, rs1, rs2, OPC_RH850_SWITCH_reg1);
-				break;
-			}
-		} else {
-			if (rs1 == 0){
-				gen_special(ctx, env, rs1, rs2, OPC_RH850_FETRAP_vector4);
-				break;
-			} else {
-				gen_divide(ctx, rs1, rs2, OPC_RH850_DIVH_reg1_reg2);
-				break;
-			}
-		}
-		break;
+static bool trans_MOV_i32(DisasContext *ctx, arg_MOV_i32 *a)
+{
+    gen_arithmetic(ctx, 0, a->r1, OPC_RH850_MOV_imm32_reg1);
+    return true;
+}
 
-	case OPC_RH850_16bit_4:
-		if (rs2 == 0){
-			gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_ZXB_reg1);
-			break;
-		} else {
-			gen_sat_op(ctx, rs1, rs2, OPC_RH850_SATSUBR_reg1_reg2);
-			break;
-		}
-		break;
-	case OPC_RH850_16bit_5:
-		if (rs2 == 0){
-			gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_SXB_reg1);
-			break;
-		} else {
-			gen_sat_op(ctx, rs1, rs2, OPC_RH850_SATSUB_reg1_reg2);
-			break;
-		}
-		break;
-	case OPC_RH850_16bit_6:
-		if (rs2 == 0){
-			gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_ZXH_reg1);
-			break;
-		} else {
-			gen_sat_op(ctx, rs1, rs2, OPC_RH850_SATADD_reg1_reg2);
-			break;
-		}
-		break;
-	case OPC_RH850_16bit_7:
-		if (rs2 == 0){
-			gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_SXH_reg1);
-			break;
-		} else {
-			gen_multiply(ctx, rs1, rs2, OPC_RH850_MULH_reg1_reg2);
-			break;
-		}
-		break;
-	case OPC_RH850_NOT_reg1_reg2:
-		gen_logical(ctx, rs1, rs2, OPC_RH850_NOT_reg1_reg2);
-		break;
-		// decode properly (handle also case when rs2 != 0), then uncomment
-//	case OPC_RH850_JMP_DISP:
-		// JMP opcode: DDDD DDDD DDDD DDDD dddd dddd dddd ddd0 0000 0110 111R RRRR
-//		disp32 = ctx->opcode >> 16;
+static bool trans_LOOP(DisasContext *ctx, arg_LOOP *a)
+{
+    gen_loop(ctx, a->r1, a->disp);
+    return true;
+}
 
+/* Jumps */
 
-		// this case is already handled in decode_RH850_48()
+static bool trans_JR_d22(DisasContext *ctx, arg_JR_d22 *a)
+{
+    gen_jmp(ctx, 0, a->disp, OPC_RH850_JR_imm22);
+    return true;
+}
 
-	case OPC_RH850_16bit_3:
-		if (rs2 == 0) {  			// JMP
-			gen_jmp(ctx, rs1, disp32, OPC_RH850_JMP_reg1);
-			break;
-		} else {
-			if(extract32(rs1,4,1)==1){
-				//SLD.HU
-				gen_load(ctx, MO_TEUW, rs2, 30, extract32(ctx->opcode, 0, 4) << 1, 0);
-			}else{
-				//SLD.BU
-				gen_load(ctx, MO_UB, rs2, 30, extract32(ctx->opcode, 0, 4), 0);
-			}
-			break;
-		}
-		break;
-	case OPC_RH850_OR_reg1_reg2:
-		gen_logical(ctx, rs1, rs2, OPC_RH850_OR_reg1_reg2);
-		break;
-	case OPC_RH850_XOR_reg1_reg2:
-		gen_logical(ctx, rs1, rs2, OPC_RH850_XOR_reg1_reg2);
-		break;
-	case OPC_RH850_AND_reg1_reg2:
-		gen_logical(ctx, rs1, rs2, OPC_RH850_AND_reg1_reg2);
-		break;
-	case OPC_RH850_TST_reg1_reg2:
-		gen_logical(ctx, rs1, rs2, OPC_RH850_TST_reg1_reg2);
-		break;
-	case OPC_RH850_SUBR_reg1_reg2:
-		gen_arithmetic(ctx, rs1, rs2, OPC_RH850_SUBR_reg1_reg2);
-		break;
-	case OPC_RH850_SUB_reg1_reg2:
-		gen_arithmetic(ctx, rs1, rs2, OPC_RH850_SUB_reg1_reg2);
-		break;
-	case OPC_RH850_ADD_reg1_reg2:
-		gen_arithmetic(ctx, rs1, rs2, OPC_RH850_ADD_reg1_reg2);
-		break;
-	case OPC_RH850_CMP_reg1_reg2:
-		gen_arithmetic(ctx, rs1, rs2, OPC_RH850_CMP_reg1_reg2);
-		break;
-	case OPC_RH850_16bit_16:
-		if (rs2 == 0){
-			gen_special(ctx, env, rs1, rs2, OPC_RH850_CALLT_imm6);
-			break;
-		} else {
-			gen_arithmetic(ctx, imm, rs2, OPC_RH850_MOV_imm5_reg2);
-			break;
-		}
-		break;
-	case OPC_RH850_16bit_17:
-		if (rs2 == 0){
-			gen_special(ctx, env, rs1, rs2, OPC_RH850_CALLT_imm6);
-			break;
-		} else {
-			gen_sat_op(ctx, rs1, rs2, OPC_RH850_SATADD_imm5_reg2);
-			break;
-		}
-		break;
-	case OPC_RH850_ADD_imm5_reg2:
-		gen_arithmetic(ctx, rs1, rs2, OPC_RH850_ADD_imm5_reg2);
-		break;
-	case OPC_RH850_CMP_imm5_reg2:
-		gen_arithmetic(ctx, rs1, rs2, OPC_RH850_CMP_imm5_reg2);
-		break;
-	case OPC_RH850_SHR_imm5_reg2:
-		gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_SHR_imm5_reg2);
-		break;
-	case OPC_RH850_SAR_imm5_reg2:
-		gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_SAR_imm5_reg2);
-		break;
-	case OPC_RH850_SHL_imm5_reg2:
-		gen_data_manipulation(ctx, rs1, rs2, OPC_RH850_SHL_imm5_reg2);
-		break;
-	case OPC_RH850_MULH_imm5_reg2:
-		gen_multiply(ctx, rs1, rs2, OPC_RH850_MULH_imm5_reg2);
-		break;
-	}
+static bool trans_JARL_d22(DisasContext *ctx, arg_JARL_d22 *a)
+{
+    gen_jmp(ctx, 0, a->disp, OPC_RH850_JARL_disp22_reg2);
+    return true;
+}
 
-	//Format IV ; dividing on code bits b7-b10
-	uint32_t opIV = (op >> 7);
-	opIV = opIV << 5;
+static bool trans_JARL_rr(DisasContext *ctx, arg_JARL_rr *a)
+{
+    gen_jmp(ctx, a->r1, 0, OPC_RH850_JARL_reg1_reg3);
+    return true;
+}
 
-	switch(opIV){
-	case OPC_RH850_16bit_SLDB:
-		gen_load(ctx, MO_SB, rs2, 30, extract32(ctx->opcode, 0, 7), 0);
-		break;
-	case OPC_RH850_16bit_SLDH:
-		gen_load(ctx, MO_TESW, rs2, 30, extract32(ctx->opcode, 0, 7) << 1, 0);
-		break;
-	case OPC_RH850_16bit_IV10:
-		if ( extract32(rs1,0,1) == 1 ) {
-			//SST.W
-	    	gen_store(ctx, MO_TEUL, 30, rs2, (extract32(ctx->opcode, 1, 6)) << 2, 0);
-			/// Note An MAE or MDP exception might occur
-	    	/// depending on the result of address calculation.
-		}
-		else{
-			//SLD.W
-			gen_load(ctx, MO_TESL, rs2, 30, extract32(ctx->opcode, 1, 6) << 2, 0);
-		}
-		break;
-	case OPC_RH850_16bit_SSTB:
-    	gen_store(ctx, MO_UB, 30, rs2, (extract32(ctx->opcode, 0, 7)), 0);
-    	/// Note An MDP exception might occur depending on the result of address calculation.
-		break;
-	case OPC_RH850_16bit_SSTH:
-    	gen_store(ctx, MO_TEUW, 30, rs2, (extract32(ctx->opcode, 0, 7)) << 1, 0);
-    	/// Note An MAE or MDP exception might occur
-    	///depending on the result of address calculation.
-		break;
-	}
+static bool trans_JR_d32(DisasContext *ctx, arg_JR_d32 *a)
+{
+    gen_jmp(ctx, 0, insn48_imm32(ctx), OPC_RH850_JR_imm32);
+    return true;
+}
+
+static bool trans_JARL_d32(DisasContext *ctx, arg_JARL_d32 *a)
+{
+    gen_jmp(ctx, a->r1, insn48_imm32(ctx), OPC_RH850_JARL_disp32_reg1);
+    return true;
+}
+
+static bool trans_JMP_d32(DisasContext *ctx, arg_JMP_d32 *a)
+{
+    gen_jmp(ctx, a->r1, insn48_imm32(ctx), OPC_RH850_JMP_disp32_reg1);
+    return true;
+}
+
+/* Format VIII and IX: bit manipulation */
+
+TRANS(SET1_i, gen_bit_manipulation, OPC_RH850_SET1_bit3_disp16_reg1)
+TRANS(NOT1_i, gen_bit_manipulation, OPC_RH850_NOT1_bit3_disp16_reg1)
+TRANS(CLR1_i, gen_bit_manipulation, OPC_RH850_CLR1_bit3_disp16_reg1)
+TRANS(TST1_i, gen_bit_manipulation, OPC_RH850_TST1_bit3_disp16_reg1)
+TRANS(SET1_rr, gen_bit_manipulation, OPC_RH850_SET1_reg2_reg1)
+TRANS(NOT1_rr, gen_bit_manipulation, OPC_RH850_NOT1_reg2_reg1)
+TRANS(CLR1_rr, gen_bit_manipulation, OPC_RH850_CLR1_reg2_reg1)
+TRANS(TST1_rr, gen_bit_manipulation, OPC_RH850_TST1_reg2_reg1)
+
+/* Format IX: shifts and bit field insertion */
+
+TRANS(BINS, gen_data_manipulation, OPC_RH850_BINS)
+TRANS(SHR_rr, gen_data_manipulation, OPC_RH850_SHR_reg1_reg2)
+TRANS(SHR_rrr, gen_data_manipulation, OPC_RH850_SHR_reg1_reg2_reg3)
+TRANS(SAR_rr, gen_data_manipulation, OPC_RH850_SAR_reg1_reg2)
+TRANS(SAR_rrr, gen_data_manipulation, OPC_RH850_SAR_reg1_reg2_reg3)
+TRANS(SHL_rr, gen_data_manipulation, OPC_RH850_SHL_reg1_reg2)
+TRANS(SHL_rrr, gen_data_manipulation, OPC_RH850_SHL_reg1_reg2_reg3)
+TRANS(ROTL_i5, gen_data_manipulation, OPC_RH850_ROTL_imm5_reg2_reg3)
+TRANS(ROTL_rrr, gen_data_manipulation, OPC_RH850_ROTL_reg1_reg2_reg3)
+TRANS(SETF, gen_data_manipulation, OPC_RH850_SETF_cccc_reg2)
+TRANS(SASF, gen_data_manipulation, OPC_RH850_SASF_cccc_reg2)
+TRANS(CMOV_i5, gen_data_manipulation, OPC_RH850_CMOV_cccc_imm5_reg2_reg3)
+TRANS(CMOV_rr, gen_data_manipulation, OPC_RH850_CMOV_cccc_reg1_reg2_reg3)
+TRANS(BSW, gen_data_manipulation, OPC_RH850_BSW_reg2_reg3)
+TRANS(BSH, gen_data_manipulation, OPC_RH850_BSH_reg2_reg3)
+TRANS(HSW, gen_data_manipulation, OPC_RH850_HSW_reg2_reg3)
+TRANS(HSH, gen_data_manipulation, OPC_RH850_HSH_reg2_reg3)
+
+/* Format X: special instructions */
+
+TRANS_SPECIAL(LDSR, OPC_RH850_LDSR_reg2_regID_selID)
+TRANS_SPECIAL(STSR, OPC_RH850_STSR_regID_reg2_selID)
+TRANS_SPECIAL(CAXI, OPC_RH850_CAXI_reg1_reg2_reg3)
+TRANS_SPECIAL(TRAP, OPC_RH850_TRAP)
+TRANS_SPECIAL(HALT, OPC_RH850_HALT)
+TRANS_SPECIAL(SNOOZE, OPC_RH850_SNOOZE)
+TRANS_SPECIAL(CTRET, OPC_RH850_CTRET)
+TRANS_SPECIAL(EIRET, OPC_RH850_EIRET)
+TRANS_SPECIAL(FERET, OPC_RH850_FERET)
+TRANS_SPECIAL(DI, OPC_RH850_DI)
+TRANS_SPECIAL(EI, OPC_RH850_EI)
+TRANS_SPECIAL(PUSHSP, OPC_RH850_PUSHSP_rh_rt)
+TRANS_SPECIAL(POPSP, OPC_RH850_POPSP_rh_rt)
+TRANS_SPECIAL(SYSCALL, OPC_RH850_SYSCALL)
+TRANS_SPECIAL(DISPOSE, OPC_RH850_DISPOSE_imm5_list12)
+TRANS_SPECIAL(DISPOSE_r, OPC_RH850_DISPOSE_imm5_list12_reg1)
+TRANS_SPECIAL(PREPARE, OPC_RH850_PREPARE_list12_imm5)
+TRANS_SPECIAL(PREPARE_sp, OPC_RH850_PREPARE_list12_imm5_sp)
+
+TRANS_SPECIAL0(RIE_32, OPC_RH850_RIE)
+
+static bool trans_PREF(DisasContext *ctx, arg_PREF *a)
+{
+    return true;
+}
+
+static bool trans_CACHE(DisasContext *ctx, arg_CACHE *a)
+{
+    gen_cache(ctx, a->r1, a->r2, 1);
+    return true;
+}
+
+/* Mutual exclusion */
+
+static bool trans_LDL_W(DisasContext *ctx, arg_LDL_W *a)
+{
+    gen_mutual_exclusion(ctx, a->r3, a->r1, operation_LDL_W);
+    return true;
+}
+
+static bool trans_STC_W(DisasContext *ctx, arg_STC_W *a)
+{
+    gen_mutual_exclusion(ctx, a->r3, a->r1, operation_STC_W);
+    return true;
+}
+
+static bool trans_CLL(DisasContext *ctx, arg_CLL *a)
+{
+    gen_mutual_exclusion(ctx, 30, 31, operation_CLL);
+    return true;
+}
+
+/* Format XI and XII: multiplication, division, bit search */
+
+TRANS(MUL_rrr, gen_multiply, OPC_RH850_MUL_reg1_reg2_reg3)
+TRANS(MULU_rrr, gen_multiply, OPC_RH850_MULU_reg1_reg2_reg3)
+TRANS(MUL_i9, gen_multiply, OPC_RH850_MUL_imm9_reg2_reg3)
+TRANS(MULU_i9, gen_multiply, OPC_RH850_MULU_imm9_reg2_reg3)
+TRANS(MAC, gen_mul_accumulate, OPC_RH850_MAC_reg1_reg2_reg3_reg4)
+TRANS(MACU, gen_mul_accumulate, OPC_RH850_MACU_reg1_reg2_reg3_reg4)
+
+TRANS(DIVH_rrr, gen_divide, OPC_RH850_DIVH_reg1_reg2_reg3)
+TRANS(DIVHU, gen_divide, OPC_RH850_DIVHU_reg1_reg2_reg3)
+TRANS(DIV, gen_divide, OPC_RH850_DIV_reg1_reg2_reg3)
+TRANS(DIVU, gen_divide, OPC_RH850_DIVU_reg1_reg2_reg3)
+/* DIVQ and DIVQU only differ from DIV and DIVU in execution time */
+TRANS(DIVQ, gen_divide, OPC_RH850_DIV_reg1_reg2_reg3)
+TRANS(DIVQU, gen_divide, OPC_RH850_DIVU_reg1_reg2_reg3)
+
+static bool trans_SCH0R(DisasContext *ctx, arg_SCH0R *a)
+{
+    gen_bit_search(ctx, a->r2, OPC_RH850_SCH0R_reg2_reg3);
+    return true;
+}
+
+static bool trans_SCH1R(DisasContext *ctx, arg_SCH1R *a)
+{
+    gen_bit_search(ctx, a->r2, OPC_RH850_SCH1R_reg2_reg3);
+    return true;
+}
+
+static bool trans_SCH0L(DisasContext *ctx, arg_SCH0L *a)
+{
+    gen_bit_search(ctx, a->r2, OPC_RH850_SCH0L_reg2_reg3);
+    return true;
+}
+
+static bool trans_SCH1L(DisasContext *ctx, arg_SCH1L *a)
+{
+    gen_bit_search(ctx, a->r2, OPC_RH850_SCH1L_reg2_reg3);
+    return true;
+}
+
+/* Format XI: ADF, SBF and saturated arithmetic with 3 registers */
+
+TRANS(ADF, gen_cond_arith, OPC_RH850_ADF_cccc_reg1_reg2_reg3)
+TRANS(SBF, gen_cond_arith, OPC_RH850_SBF_cccc_reg1_reg2_reg3)
+TRANS(SATADD_rrr, gen_sat_op, OPC_RH850_SATADD_reg1_reg2_reg3)
+TRANS(SATSUB_rrr, gen_sat_op, OPC_RH850_SATSUB_reg1_reg2_reg3)
+
+/* Format F:I, FPU instructions */
+
+static bool trans_FPU(DisasContext *ctx, arg_FPU *a)
+{
+    int op = MASK_OP_FPU(ctx->opcode);
+
+    switch (op) {
+    case OPC_RH850_DIVF_S:
+    case OPC_RH850_SQRTF_S:
+        set_insn_cycles(ctx, CYC_FPU_DIV_S);
+        break;
+    case OPC_RH850_DIVF_D:
+    case OPC_RH850_SQRTF_D:
+        set_insn_cycles(ctx, CYC_FPU_DIV_D);
+        break;
+    default:
+        set_insn_cycles(ctx, CYC_FPU);
+        break;
+    }
+    if (!fpu_op_valid(a->r1, op)) {
+        gen_exception_insn(ctx, RH850_EXCP_RIE);
+    } else if (!ctx->cu0) {
+        gen_exception_insn(ctx, RH850_EXCP_UCPOP);
+    } else {
+        gen_fpu(ctx, a->r1, a->r2, op);
+    }
+    return true;
 }
 
 
@@ -4887,71 +5185,71 @@ static void rh850_tr_init_disas_context(DisasContextBase *dcbase, CPUState *cpu)
     CPURH850State *env = cpu->env_ptr;
     dc->env = env;
     dc->pc = dc->base.pc_first;
+    dc->cc_op = CC_OP_FLAGS;
+    dc->cu0 = dc->base.tb->flags & TB_FLAGS_CU0;
+    dc->mem_idx = dc->base.tb->flags & TB_FLAGS_MMU_MASK;
+    dc->cycle_timing = RH850_CPU(cpu)->cycle_timing;
+    dc->tb_cycles = 0;
 }
 
 static void rh850_tr_tb_start(DisasContextBase *dcbase, CPUState *cpu)
-{
-}
-
-static void rh850_tr_insn_start(DisasContextBase *dcbase, CPUState *cpu)
 {
     DisasContext *dc = container_of(dcbase, DisasContext, base);
-    tcg_gen_insn_start(dc->pc);
+
+    if (dc->cycle_timing) {
+        /*
+         * Like the icount decrement, the cycle cost of the whole TB is
+         * added up front with a dummy constant, which is patched in
+         * rh850_tr_tb_stop() once the TB is complete.
+         */
+        tcg_gen_add_i64(cpu_cycles, cpu_cycles, tcg_constant_i64(0));
+        dc->cycles_op = tcg_last_op();
+    }
 }
 
-/*
- * This f. is called when breakpoint is hit. It should implement
- * handling of breakpoint - for example HW breakpoints may be
- * handled differently from SW breakpoints (see arm/translate.c).
- * However, in RH850 we currently implement only SW breakpoints.
- *
- * Comment from translator.c:
- *     The breakpoint_check hook may use DISAS_TOO_MANY to indicate
- *     that only one more instruction is to be executed.  Otherwise
- *     it should use DISAS_NORETURN when generating an exception,
- *     but may use a DISAS_TARGET_* value for Something Else.
- */
-static bool rh850_tr_breakpoint_check(DisasContextBase *dcbase, CPUState *cpu,
-                                     const CPUBreakpoint *bp)
+static void rh850_tr_insn_start(DisasContextBase *dcbase, CPUState *cpu)
 {
     DisasContext *dc = container_of(dcbase, DisasContext, base);
-
-    gen_exception_debug(dc);
-    /* The address covered by the breakpoint must be included in
-       [tb->pc, tb->pc + tb->size) in order to for it to be
-       properly cleared -- thus we increment the PC here so that
-       the logic setting tb->size below does the right thing.  */
-    dc->base.pc_next += 2;
-    dc->base.is_jmp = DISAS_NORETURN;
-    return true;
+    tcg_gen_insn_start(dc->pc, dc->cc_op, dc->tb_cycles);
 }
 
-
 static void rh850_tr_translate_insn(DisasContextBase *dcbase, CPUState *cpu)
 {
     DisasContext *dc = container_of(dcbase, DisasContext, base);
     CPURH850State *env = dc->env;
 
-    dc->opcode = cpu_lduw_code(env, dc->pc);  // get opcode from memory
+    bool ok;
 
-    if ((extract32(dc->opcode, 9, 2) != 0x3) && (extract32(dc->opcode, 5, 11) != 0x17)) {
-		dc->base.pc_next = dc->pc + 2;
-		decode_RH850_16(env, dc);		//this function includes 32-bit JR and JARL
+    dc->insn_cycles = rh850_insn_cycles[CYC_ALU];
+    dc->opcode = cpu_lduw_code(env, dc->pc);
+
+    /* The instruction length is encoded in the first halfword */
+    if ((extract32(dc->opcode, 9, 2) != 0x3) &&
+        (extract32(dc->opcode, 5, 11) != 0x17)) {
+        dc->base.pc_next = dc->pc + 2;
+        ok = decode_insn16(dc, dc->opcode);
     } else {
-    	dc->opcode = (dc->opcode) | (cpu_lduw_code(env, dc->pc + 2) << 0x10);
-    	if (((extract32(dc->opcode, 6, 11) == 0x41e) && ((extract32(dc->opcode, 17, 2) > 0x1) ||
-    			(extract32(dc->opcode, 17, 3) == 0x4))) ||
-    			(extract32(dc->opcode, 5, 11) == 0x31) ||		//48-bit MOV
-				(extract32(dc->opcode, 5, 12) == 0x37)  || 		//48-bit JMP
-				(extract32(dc->opcode, 5, 11) == 0x17) ) { 		//48-bit JARL and JR
-    		dc->opcode1 = cpu_lduw_code(env, dc->pc + 4);
-			dc->base.pc_next = dc->pc + 6;
-			decode_RH850_48(env, dc);
-    	} else {
-    		dc->base.pc_next = dc->pc + 4;
-    		decode_RH850_32(env, dc);
-    	}
+        dc->opcode |= cpu_lduw_code(env, dc->pc + 2) << 16;
+        if (((extract32(dc->opcode, 6, 11) == 0x41e) &&
+             ((extract32(dc->opcode, 17, 2) > 0x1) ||
+              (extract32(dc->opcode, 17, 3) == 0x4))) ||
+            (extract32(dc->opcode, 5, 11) == 0x31) ||   /* MOV imm32 */
+            (extract32(dc->opcode, 5, 12) == 0x37) ||   /* JMP disp32 */
+            (extract32(dc->opcode, 5, 11) == 0x17)) {   /* JR, JARL disp32 */
+            dc->opcode1 = cpu_lduw_code(env, dc->pc + 4);
+            dc->base.pc_next = dc->pc + 6;
+            ok = decode_insn48(dc, dc->opcode);
+        } else {
+            dc->base.pc_next = dc->pc + 4;
+            ok = decode_insn32(dc, dc->opcode);
+        }
+    }
+
+    if (!ok) {
+        qemu_log_mask(LOG_UNIMP, "rh850: unknown instruction 0x%x at 0x"
+                      TARGET_FMT_lx "\n", dc->opcode, dc->pc);
     }
+    dc->tb_cycles += dc->insn_cycles;
 
     dc->pc = dc->base.pc_next;
 
@@ -4982,14 +5280,45 @@ static void rh850_tr_translate_insn(DisasContextBase *dcbase, CPUState *cpu)
 #endif
 }
 
+/*
+ * Patches the cycle cost of the TB into the add emitted at TB start. The
+ * third insn_start word is turned from the cycles before each instruction
+ * into the cycles which were not executed when the TB is left at it, so
+ * that restore_state_to_opc() can subtract them.
+ */
+static void gen_tb_cycles_end(DisasContext *dc)
+{
+    TCGOp *op;
+
+#if TCG_TARGET_REG_BITS == 64
+    tcg_set_insn_param(dc->cycles_op, 2,
+                       tcgv_i64_arg(tcg_constant_i64(dc->tb_cycles)));
+#else
+    /* add2_i32 rl, rh, al, ah, bl, bh */
+    tcg_set_insn_param(dc->cycles_op, 4,
+                       tcgv_i32_arg(tcg_constant_i32(dc->tb_cycles)));
+#endif
+
+    QTAILQ_FOREACH(op, &tcg_ctx->ops, link) {
+        if (op->opc == INDEX_op_insn_start) {
+            tcg_set_insn_start_param(op, 2, dc->tb_cycles -
+                                     tcg_get_insn_start_param(op, 2));
+        }
+    }
+}
+
 // Emit exit TB code according to base.is_jmp
 static void rh850_tr_tb_stop(DisasContextBase *dcbase, CPUState *cpu)
 {
     DisasContext *dc = container_of(dcbase, DisasContext, base);
 
+    if (dc->cycle_timing) {
+        gen_tb_cycles_end(dc);
+    }
     if (dc->base.is_jmp == DISAS_NORETURN) {
         return;
     }
+    gen_flush_flags(dc);
     if (dc->base.singlestep_enabled) {
     	if (dc->base.is_jmp == DISAS_NEXT  ||  dc->base.is_jmp == DISAS_TOO_MANY) {
     		// PC is not loaded inside TB, so we have to do it here in case of
@@ -5028,7 +5357,6 @@ static const TranslatorOps rh850_tr_ops = {
     .init_disas_context = rh850_tr_init_disas_context,
     .tb_start           = rh850_tr_tb_start,
     .insn_start         = rh850_tr_insn_start,
-    .breakpoint_check   = rh850_tr_breakpoint_check,
     .translate_insn     = rh850_tr_translate_insn,
     .tb_stop            = rh850_tr_tb_stop,
     .disas_log          = rh850_tr_disas_log,
@@ -5042,139 +5370,12 @@ static const TranslatorOps rh850_tr_ops = {
  * breakpoint is detected, ... - see if statements, which break
  * while loop below.
  */
-#define NEW_GEN_INSN
-#ifdef NEW_GEN_INSN
 void gen_intermediate_code(CPUState *cpu, TranslationBlock *tb, int max_insns)
 {
     DisasContext dc;
     translator_loop(&rh850_tr_ops, &dc.base, cpu, tb, max_insns);
 }
 
-#else    // NEW_GEN_INSN
-
-void gen_intermediate_code(CPUState *cs, TranslationBlock *tb, int max_insns)
-{
-    CPURH850State *env = cs->env_ptr;
-    DisasContext ctx;
-    target_ulong pc_start = tb->pc;
-    ctx.pc = pc_start;
-
-    if (false) translator_loop(&rh850_tr_ops, &ctx.base, cs, tb);
-    /* once we have GDB, the rest of the translate.c implementation should be
-       ready for singlestep */
-    ctx.base.singlestep_enabled = cs->singlestep_enabled;
-    ctx.base.singlestep_enabled = 1;/// this is only for gdb exceptions
-
-    ctx.base.tb = tb;
-    ctx.base.is_jmp = DISAS_NEXT;
-
-    ctx.base.num_insns = 0;
-    ctx.base.max_insns = tb->cflags & CF_COUNT_MASK;
-    if (ctx.base.max_insns == 0) {
-    	ctx.base.max_insns = CF_COUNT_MASK;
-    }
-    if (ctx.base.max_insns > TCG_MAX_INSNS) {
-    	ctx.base.max_insns = TCG_MAX_INSNS;
-    }
-    gen_tb_start(tb);
-
-    while (ctx.base.is_jmp == DISAS_NEXT) {
-        tcg_gen_insn_start(ctx.pc);
-        ctx.base.num_insns++;
-
-        if (unlikely(cpu_breakpoint_test(cs, ctx.pc, BP_ANY))) {
-            tcg_gen_movi_tl(cpu_pc, ctx.pc);
-            gen_exception_debug(&ctx);
-            /* The address covered by the breakpoint must be included in
-               [tb->pc, tb->pc + tb->size) in order to for it to be
-               properly cleared -- thus we increment the PC here so that
-               the logic setting tb->size below does the right thing.  */
-            ctx.pc += 4;
-            goto done_generating;
-        }
-
-        if (ctx.base.num_insns == ctx.base.max_insns && (tb->cflags & CF_LAST_IO)) {
-            gen_io_start();
-        }
-
-        ctx.opcode = cpu_lduw_code(env, ctx.pc);  // get opcode from memory
-
-        if ((extract32(ctx.opcode, 9, 2) != 0x3) && (extract32(ctx.opcode, 5, 11) != 0x17)) {
-			ctx.base.pc_next = ctx.pc + 2;
-			decode_RH850_16(env, &ctx);		//this function includes 32-bit JR and JARL
-        } else {
-        	ctx.opcode = (ctx.opcode) | (cpu_lduw_code(env, ctx.pc+2) << 0x10);
-        	if (((extract32(ctx.opcode, 6, 11) == 0x41e) && ((extract32(ctx.opcode, 17, 2) > 0x1) ||
-        			(extract32(ctx.opcode, 17, 3) == 0x4))) ||
-        			(extract32(ctx.opcode, 5, 11) == 0x31) ||		//48-bit MOV
-					(extract32(ctx.opcode, 5, 12) == 0x37)  || 		//48-bit JMP
-					(extract32(ctx.opcode, 5, 11) == 0x17) ) { 		//48-bit JARL and JR
-        		ctx.opcode1 = cpu_lduw_code(env, ctx.pc+4);
-				ctx.base.pc_next = ctx.pc + 6;
-				decode_RH850_48(env, &ctx);
-        	} else {
-        		ctx.base.pc_next = ctx.pc + 4;
-        		decode_RH850_32(env, &ctx);
-        	}
-        }
-
-        ctx.pc = ctx.base.pc_next;
-
-        copyFlagsToPSW();
-
-        if (cs->singlestep_enabled) {
-            break;
-        }
-        if (tcg_op_buf_full()) {
-            break;
-        }
-        if (ctx.base.num_insns >= ctx.base.max_insns) {
-            break;
-        }
-        if (singlestep) {
-            break;
-        }
-
-    }
-
-    if (tb->cflags & CF_LAST_IO) {
-        gen_io_end();
-    }
-    switch (ctx.base.is_jmp) {
-    case DISAS_TOO_MANY:
-        gen_goto_tb_imm(&ctx, 0, ctx.pc);
-        break;
-    case DISAS_INDIRECT_JUMP:
-    	tcg_gen_lookup_and_goto_ptr();
-    	break;
-//    case BS_NONE: /* handle end of page - DO NOT CHAIN. See gen_goto_tb. */
-//        tcg_gen_movi_tl(cpu_pc, ctx.pc);
-//        if (cs->singlestep_enabled) {
-//            gen_exception_debug(&ctx);
-//        } else {
-//            tcg_gen_exit_tb(NULL, 0);
-//        }
-//        break;
-    case DISAS_NORETURN:
-    case DISAS_TB_EXIT_ALREADY_GENERATED: // ops using BS_BRANCH generate own exit seq
-    	break;
-    default:
-        break;
-    }
-done_generating:
-    gen_tb_end(tb, ctx.base.num_insns);
-    tb->size = ctx.pc - pc_start;
-    tb->icount = ctx.base.num_insns;
-
-#ifdef DEBUG_DISAS
-    if (qemu_loglevel_mask(CPU_LOG_TB_IN_ASM)  &&  qemu_log_in_addr_range(pc_start)) {
-        qemu_log("\nIN: %s\n", lookup_symbol(pc_start));
-        log_target_disas(cs, pc_start, ctx.pc - pc_start);
-        qemu_log("\n");
-    }
-#endif
-}
-#endif  // OLD_GEN_INSN
 void rh850_translate_init(void)
 {
     int i;
@@ -5188,18 +5389,19 @@ void rh850_translate_init(void)
             offsetof(CPURH850State, gpRegs[i]), rh850_gp_regnames[i]);
     }
 
-    for (int bankIdx = 0; bankIdx < NUM_SYS_REG_BANKS; bankIdx++) {
-        for (int regIdx = 0; regIdx < MAX_SYS_REGS_IN_BANK; regIdx++) {
-            const char *regName = rh850_sys_regnames[bankIdx][regIdx];
-            if (regName != NULL) {
-                cpu_sysRegs[bankIdx][regIdx] = tcg_global_mem_new(cpu_env,
-                                                                  offsetof(CPURH850State, systemRegs[bankIdx][regIdx]),
-                                                                  regName);
-            } else {
-                cpu_sysRegs[bankIdx][regIdx] = NULL;  // mark register as not present
-            }
-        }
-    }
+#define SYSREG_GLOBAL(idx) \
+    tcg_global_mem_new(cpu_env, \
+        offsetof(CPURH850State, systemRegs[BANK_ID_BASIC_0][idx]), \
+        rh850_sys_regnames[BANK_ID_BASIC_0][idx])
+
+    cpu_eipc = SYSREG_GLOBAL(EIPC_IDX);
+    cpu_eipsw = SYSREG_GLOBAL(EIPSW_IDX);
+    cpu_fepc = SYSREG_GLOBAL(FEPC_IDX);
+    cpu_fepsw = SYSREG_GLOBAL(FEPSW_IDX);
+    cpu_ctpc = SYSREG_GLOBAL(CTPC_IDX);
+    cpu_ctpsw = SYSREG_GLOBAL(CTPSW_IDX);
+
+#undef SYSREG_GLOBAL
 
     for (i = 0; i < 1; i++) {
         cpu_sysDatabuffRegs[i] = tcg_global_mem_new(cpu_env,
@@ -5220,6 +5422,11 @@ void rh850_translate_init(void)
     cpu_CU1 = tcg_global_mem_new_i32(cpu_env, offsetof(CPURH850State, CU1_flag), "CU1");
     cpu_CU2 = tcg_global_mem_new_i32(cpu_env, offsetof(CPURH850State, CU2_flag), "CU2");
     cpu_UM = tcg_global_mem_new_i32(cpu_env, offsetof(CPURH850State, UM_flag), "UM");
+    cpu_cycles = tcg_global_mem_new_i64(cpu_env, offsetof(CPURH850State, cycles), "cycles");
+
+    cpu_cc_src1 = tcg_global_mem_new_i32(cpu_env, offsetof(CPURH850State, cc_src1), "cc_src1");
+    cpu_cc_src2 = tcg_global_mem_new_i32(cpu_env, offsetof(CPURH850State, cc_src2), "cc_src2");
+    cpu_cc_dst = tcg_global_mem_new_i32(cpu_env, offsetof(CPURH850State, cc_dst), "cc_dst");
 
     cpu_pc = tcg_global_mem_new(cpu_env, offsetof(CPURH850State, pc), "pc");
     load_res = tcg_global_mem_new(cpu_env, offsetof(CPURH850State, load_res), "load_res");
@@ -5227,5 +5434,6 @@ void rh850_translate_init(void)
 
     cpu_LLbit = tcg_global_mem_new(cpu_env, offsetof(CPURH850State, cpu_LLbit), "cpu_LLbit");
     cpu_LLAddress = tcg_global_mem_new(cpu_env, offsetof(CPURH850State, cpu_LLAddress), "cpu_LLAddress");
+    cpu_LLValue = tcg_global_mem_new(cpu_env, offsetof(CPURH850State, cpu_LLValue), "cpu_LLValue");
 
 }
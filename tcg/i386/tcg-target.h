@@ -136,6 +136,7 @@ extern bool have_movbe;
 #define TCG_TARGET_HAS_muluh_i32        0
 #define TCG_TARGET_HAS_mulsh_i32        0
 #define TCG_TARGET_HAS_direct_jump      1
+#define TCG_TARGET_HAS_tb_reloc         (TCG_TARGET_REG_BITS == 64)
 
 #if TCG_TARGET_REG_BITS == 64
 /* Keep target addresses zero-extended in a register.  */
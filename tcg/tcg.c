@@ -4269,6 +4269,8 @@ int tcg_gen_code(TCGContext *s, TranslationBlock *tb)
      */
     s->code_buf = tcg_splitwx_to_rw(tb->tc.ptr);
     s->code_ptr = s->code_buf;
+    s->nb_tb_relocs = 0;
+    s->tb_reloc_failed = false;
 
 #ifdef TCG_TARGET_NEED_LDST_LABELS
     QSIMPLEQ_INIT(&s->ldst_labels);
@@ -0,0 +1,136 @@
+/*
+ * QTest testcase for the ARMv7-M NVIC pending exception state
+ *
+ * Copyright (c) 2021 iSYSTEM Labs d.o.o.
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "libqtest-single.h"
+
+/* mps2-an511 has a Cortex-M3 with 64 external interrupts */
+#define NUM_IRQ 64
+
+#define ICSR 0xe000ed04
+#define ISER 0xe000e100
+#define ICER 0xe000e180
+#define ISPR 0xe000e200
+#define ICPR 0xe000e280
+#define IPR 0xe000e400
+
+#define ICSR_VECTPENDING(icsr) (((icsr) >> 12) & 0x1ff)
+
+#define NVIC_FIRST_IRQ 16
+#define BENCH_ITERATIONS 100000
+
+static void set_pending(int irq, bool pending)
+{
+    writel((pending ? ISPR : ICPR) + irq / 32 * 4, 1u << (irq % 32));
+}
+
+static int vectpending(void)
+{
+    return ICSR_VECTPENDING(readl(ICSR));
+}
+
+/* Give higher numbered interrupts higher priority (lower values) */
+static void setup_irqs(void)
+{
+    int i;
+
+    for (i = 0; i < NUM_IRQ; i += 4) {
+        uint32_t prio = 0;
+        int j;
+
+        for (j = 0; j < 4; j++) {
+            prio |= (uint32_t)((NUM_IRQ - 1 - i - j) * 4) << (j * 8);
+        }
+        writel(IPR + i, prio);
+    }
+    for (i = 0; i < NUM_IRQ / 32; i++) {
+        writel(ICPR + i * 4, 0xffffffff);
+        writel(ISER + i * 4, 0xffffffff);
+    }
+}
+
+static void test_vectpending(void)
+{
+    setup_irqs();
+    g_assert_cmpint(vectpending(), ==, 0);
+
+    set_pending(3, true);
+    g_assert_cmpint(vectpending(), ==, NVIC_FIRST_IRQ + 3);
+    set_pending(40, true);
+    g_assert_cmpint(vectpending(), ==, NVIC_FIRST_IRQ + 40);
+    set_pending(10, true);
+    g_assert_cmpint(vectpending(), ==, NVIC_FIRST_IRQ + 40);
+
+    /* Disabled interrupts stay pending but are not taken */
+    writel(ICER + 4, 1u << (40 - 32));
+    g_assert_cmpint(vectpending(), ==, NVIC_FIRST_IRQ + 10);
+    g_assert_cmphex(readl(ISPR + 4), ==, 1u << (40 - 32));
+    writel(ISER + 4, 1u << (40 - 32));
+    g_assert_cmpint(vectpending(), ==, NVIC_FIRST_IRQ + 40);
+
+    set_pending(40, false);
+    g_assert_cmpint(vectpending(), ==, NVIC_FIRST_IRQ + 10);
+
+    /* Lowering the priority of a pending interrupt reorders it */
+    writeb(IPR + 10, 0xff);
+    g_assert_cmpint(vectpending(), ==, NVIC_FIRST_IRQ + 3);
+
+    set_pending(3, false);
+    g_assert_cmpint(vectpending(), ==, NVIC_FIRST_IRQ + 10);
+    set_pending(10, false);
+    g_assert_cmpint(vectpending(), ==, 0);
+}
+
+/*
+ * Measures how fast interrupts are pended and cleared. Interrupts cannot
+ * be acknowledged without a running CPU, so every iteration pends one
+ * interrupt on top of the lowest priority one and clears it again, and
+ * the state is recomputed on each write.
+ */
+static void test_pend_throughput(void)
+{
+    double elapsed;
+    int i;
+
+    setup_irqs();
+    set_pending(0, true);
+
+    g_test_timer_start();
+    for (i = 0; i < BENCH_ITERATIONS; i++) {
+        int irq = 1 + i % (NUM_IRQ - 1);
+
+        set_pending(irq, true);
+        set_pending(irq, false);
+    }
+    elapsed = g_test_timer_elapsed();
+
+    g_assert_cmpint(vectpending(), ==, NVIC_FIRST_IRQ);
+    g_test_message("%d pend/clear pairs in %.3f s, %.0f per second",
+                   BENCH_ITERATIONS, elapsed, BENCH_ITERATIONS / elapsed);
+}
+
+int main(int argc, char **argv)
+{
+    int r;
+
+    g_test_init(&argc, &argv, NULL);
+
+    qtest_start("-machine mps2-an511");
+
+    qtest_add_func("/armv7m-nvic/vectpending", test_vectpending);
+    if (g_test_perf()) {
+        qtest_add_func("/armv7m-nvic/pend-throughput", test_pend_throughput);
+    }
+
+    r = g_test_run();
+
+    qtest_end();
+
+    return r;
+}
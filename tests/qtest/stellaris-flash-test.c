@@ -0,0 +1,107 @@
+/*
+ * QTest testcase for the Stellaris flash memory controller
+ *
+ * Copyright (c) 2021 iSYSTEM Labs d.o.o.
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "libqos/libqtest.h"
+
+/* lm3s811evb, 64 KiB of flash at address 0 in 1 KiB pages */
+#define FLASH_SIZE (64 * 1024)
+#define FLASH_PAGE_SIZE 0x400
+#define FLASH_CTRL_BASE 0x400fd000
+
+#define FMA 0x00
+#define FMD 0x04
+#define FMC 0x08
+#define FCRIS 0x0c
+#define FCMISC 0x14
+
+#define FMC_WRKEY 0xa4420000
+#define FMC_WRITE 0x01
+#define FMC_ERASE 0x02
+
+#define INT_ACCESS 0x01
+#define INT_PROGRAM 0x02
+
+static void flash_command(QTestState *qts, uint32_t addr, uint32_t cmd)
+{
+    qtest_writel(qts, FLASH_CTRL_BASE + FMA, addr);
+    qtest_writel(qts, FLASH_CTRL_BASE + FMC, cmd);
+}
+
+static void flash_program(QTestState *qts, uint32_t addr, uint32_t data)
+{
+    qtest_writel(qts, FLASH_CTRL_BASE + FMD, data);
+    flash_command(qts, addr, FMC_WRKEY | FMC_WRITE);
+}
+
+static void test_erase(void)
+{
+    QTestState *qts = qtest_init("-machine lm3s811evb");
+    uint32_t page = 2 * FLASH_PAGE_SIZE;
+
+    /* Commands without the key are ignored */
+    flash_command(qts, page, FMC_ERASE);
+    g_assert_cmpuint(qtest_readl(qts, page), ==, 0);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_CTRL_BASE + FCRIS), ==, 0);
+
+    /* Only the page containing FMA is erased */
+    flash_command(qts, page + 0x10, FMC_WRKEY | FMC_ERASE);
+    g_assert_cmpuint(qtest_readl(qts, page - 4), ==, 0);
+    g_assert_cmpuint(qtest_readl(qts, page), ==, 0xffffffff);
+    g_assert_cmpuint(qtest_readl(qts, page + FLASH_PAGE_SIZE - 4), ==,
+                     0xffffffff);
+    g_assert_cmpuint(qtest_readl(qts, page + FLASH_PAGE_SIZE), ==, 0);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_CTRL_BASE + FMC), ==, 0);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_CTRL_BASE + FCRIS), ==,
+                     INT_PROGRAM);
+
+    /* FCMISC is write 1 to clear */
+    qtest_writel(qts, FLASH_CTRL_BASE + FCMISC, INT_PROGRAM);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_CTRL_BASE + FCRIS), ==, 0);
+
+    qtest_quit(qts);
+}
+
+static void test_program(void)
+{
+    QTestState *qts = qtest_init("-machine lm3s811evb");
+    uint32_t page = 4 * FLASH_PAGE_SIZE;
+
+    flash_command(qts, page, FMC_WRKEY | FMC_ERASE);
+    flash_program(qts, page + 8, 0x12345678);
+    g_assert_cmpuint(qtest_readl(qts, page + 8), ==, 0x12345678);
+    g_assert_cmpuint(qtest_readl(qts, page + 4), ==, 0xffffffff);
+
+    /* Programming only clears bits */
+    flash_program(qts, page + 8, 0xff00ff00);
+    g_assert_cmpuint(qtest_readl(qts, page + 8), ==, 0x12005600);
+
+    /* Without the key nothing is programmed */
+    qtest_writel(qts, FLASH_CTRL_BASE + FMD, 0);
+    flash_command(qts, page + 4, FMC_WRITE);
+    g_assert_cmpuint(qtest_readl(qts, page + 4), ==, 0xffffffff);
+
+    /* Addresses beyond flash raise the access interrupt */
+    qtest_writel(qts, FLASH_CTRL_BASE + FCMISC, INT_PROGRAM);
+    flash_command(qts, FLASH_SIZE, FMC_WRKEY | FMC_WRITE);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_CTRL_BASE + FCRIS), ==,
+                     INT_ACCESS);
+
+    qtest_quit(qts);
+}
+
+int main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    qtest_add_func("/stellaris-flash/erase", test_erase);
+    qtest_add_func("/stellaris-flash/program", test_program);
+
+    return g_test_run();
+}
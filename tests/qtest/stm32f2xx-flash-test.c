@@ -0,0 +1,178 @@
+/*
+ * QTest testcase for the STM32F2xx/STM32F4xx flash interface
+ *
+ * Copyright (c) 2021 iSYSTEM Labs d.o.o.
+ *
+ * This work is licensed under the terms of the GNU GPL, version 2 or later.
+ * See the COPYING file in the top-level directory.
+ */
+
+#include "qemu/osdep.h"
+#include "libqos/libqtest.h"
+
+/* netduinoplus2 (STM32F405) */
+#define FLASH_BASE 0x08000000
+#define FLASH_IF_BASE 0x40023c00
+
+#define FLASH_KEYR 0x04
+#define FLASH_SR 0x0c
+#define FLASH_CR 0x10
+
+#define FLASH_KEY1 0x45670123
+#define FLASH_KEY2 0xcdef89ab
+
+#define SR_PGPERR (1 << 6)
+#define SR_PGSERR (1 << 7)
+
+#define CR_PG (1 << 0)
+#define CR_SER (1 << 1)
+#define CR_SNB(n) ((n) << 3)
+#define CR_PSIZE_X8 (0 << 8)
+#define CR_PSIZE_X32 (2 << 8)
+#define CR_STRT (1 << 16)
+#define CR_LOCK (1u << 31)
+
+#define SECTOR_1 (16 * 1024)
+#define SECTOR_2 (32 * 1024)
+
+static void flash_unlock(QTestState *qts)
+{
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_KEYR, FLASH_KEY1);
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_KEYR, FLASH_KEY2);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_IF_BASE + FLASH_CR) & CR_LOCK,
+                     ==, 0);
+}
+
+static void test_unlock(void)
+{
+    QTestState *qts = qtest_init("-machine netduinoplus2");
+
+    /* Locked out of reset, CR ignores writes */
+    g_assert_cmpuint(qtest_readl(qts, FLASH_IF_BASE + FLASH_CR), ==, CR_LOCK);
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_CR, CR_PG);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_IF_BASE + FLASH_CR), ==, CR_LOCK);
+
+    flash_unlock(qts);
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_CR, CR_PG);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_IF_BASE + FLASH_CR), ==, CR_PG);
+
+    /* Setting LOCK locks it again */
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_CR, CR_LOCK);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_IF_BASE + FLASH_CR), ==, CR_LOCK);
+
+    qtest_quit(qts);
+}
+
+static void test_wrong_key(void)
+{
+    QTestState *qts = qtest_init("-machine netduinoplus2");
+
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_KEYR, FLASH_KEY1);
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_KEYR, 0x12345678);
+
+    /* A wrong key locks KEYR until reset, even for the right sequence */
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_KEYR, FLASH_KEY1);
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_KEYR, FLASH_KEY2);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_IF_BASE + FLASH_CR), ==, CR_LOCK);
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_CR, CR_PG);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_IF_BASE + FLASH_CR), ==, CR_LOCK);
+
+    qtest_quit(qts);
+}
+
+static void test_program(void)
+{
+    QTestState *qts = qtest_init("-machine netduinoplus2");
+
+    /* Stores are ignored unless PG is set */
+    qtest_writel(qts, FLASH_BASE, 0x12345678);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_BASE), ==, 0xffffffff);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_IF_BASE + FLASH_SR), ==,
+                     SR_PGSERR);
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_SR, SR_PGSERR);
+
+    flash_unlock(qts);
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_CR, CR_PG | CR_PSIZE_X32);
+    qtest_writel(qts, FLASH_BASE, 0x12345678);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_BASE), ==, 0x12345678);
+
+    /* Programming only clears bits */
+    qtest_writel(qts, FLASH_BASE, 0xff00ff00);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_BASE), ==, 0x12005600);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_IF_BASE + FLASH_SR), ==, 0);
+
+    /* Flash is also visible through the alias at 0 */
+    g_assert_cmpuint(qtest_readl(qts, 0), ==, 0x12005600);
+
+    qtest_quit(qts);
+}
+
+static void test_psize(void)
+{
+    QTestState *qts = qtest_init("-machine netduinoplus2");
+
+    flash_unlock(qts);
+
+    /* A byte store with x32 parallelism is not programmed */
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_CR, CR_PG | CR_PSIZE_X32);
+    qtest_writeb(qts, FLASH_BASE + 4, 0x00);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_BASE + 4), ==, 0xffffffff);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_IF_BASE + FLASH_SR), ==,
+                     SR_PGPERR);
+
+    /* PGPERR is cleared by writing 1 */
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_SR, SR_PGPERR);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_IF_BASE + FLASH_SR), ==, 0);
+
+    /* With x8 parallelism it is */
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_CR, CR_PG | CR_PSIZE_X8);
+    qtest_writeb(qts, FLASH_BASE + 4, 0x00);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_BASE + 4), ==, 0xffffff00);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_IF_BASE + FLASH_SR), ==, 0);
+
+    qtest_quit(qts);
+}
+
+static void test_sector_erase(void)
+{
+    QTestState *qts = qtest_init("-machine netduinoplus2");
+
+    flash_unlock(qts);
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_CR, CR_PG | CR_PSIZE_X32);
+    qtest_writel(qts, FLASH_BASE + SECTOR_1, 0);
+    qtest_writel(qts, FLASH_BASE + SECTOR_2 - 4, 0);
+    qtest_writel(qts, FLASH_BASE + SECTOR_2, 0);
+
+    /* Erasing sector 1 leaves sector 2 alone */
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_CR, CR_SER | CR_SNB(1));
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_CR,
+                 CR_SER | CR_SNB(1) | CR_STRT);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_IF_BASE + FLASH_CR) & CR_STRT,
+                     ==, 0);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_BASE + SECTOR_1), ==, 0xffffffff);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_BASE + SECTOR_2 - 4), ==,
+                     0xffffffff);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_BASE + SECTOR_2), ==, 0);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_IF_BASE + FLASH_SR), ==, 0);
+
+    /* Sectors beyond the 1 MiB of flash cannot be erased */
+    qtest_writel(qts, FLASH_IF_BASE + FLASH_CR,
+                 CR_SER | CR_SNB(12) | CR_STRT);
+    g_assert_cmpuint(qtest_readl(qts, FLASH_IF_BASE + FLASH_SR), ==,
+                     SR_PGSERR);
+
+    qtest_quit(qts);
+}
+
+int main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    qtest_add_func("/stm32f2xx-flash/unlock", test_unlock);
+    qtest_add_func("/stm32f2xx-flash/wrong-key", test_wrong_key);
+    qtest_add_func("/stm32f2xx-flash/program", test_program);
+    qtest_add_func("/stm32f2xx-flash/psize", test_psize);
+    qtest_add_func("/stm32f2xx-flash/sector-erase", test_sector_erase);
+
+    return g_test_run();
+}